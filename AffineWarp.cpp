@@ -0,0 +1,445 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.6
+ *          - 1.0.0 - Added inverse mapping affine warp with nearest and bilinear sampling.
+ *          - 1.0.1 - Added composition of mappings for fused geometry.
+ *          - 1.0.2 - Added whole pixel right angle mappings through the transpose.
+ *          - 1.0.3 - Added interleaved BGR24 warps.
+ *          - 1.0.4 - Added warps of destination rectangles from source windows, matching whole image warps.
+ *          - 1.0.5 - Added AVX2 gray bilinear rows.
+ *          - 1.0.6 - Added interleaved BGRA32 warps.
+ *
+ * @desc Inverse mapping affine warp of 8 bit planes, BGR24 and BGRA32 images,
+ *       used for rotation.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include "AffineWarp.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "CpuFeatures.h"
+#include "ThreadPool.h"
+#include "Transpose.h"
+
+#ifdef BITMAP_X86
+#include <immintrin.h>
+#endif
+
+static const int FIX_BITS = 16;							//16.16 fixed point coordinates
+static const int64_t FIX_ONE = (int64_t)1 << FIX_BITS;
+static const int64_t FIX_HALF = FIX_ONE >> 1;
+static const double UNIT_EPSILON = 1e-9;						//Tolerance of a unit or zero matrix coefficient
+static const double SHIFT_EPSILON = 1e-6;					//Tolerance of a whole pixel offset
+static const int64_t LANE_LIMIT = (int64_t)1 << 31;			//Bound of positions, steps and offsets in 32 bit lanes
+
+/*! Vector bilinear warp of destination pixels of a gray segment, returns the number done */
+typedef uint32_t (*WarpRowKernel)(const uint8_t *src, const uint32_t srcStride, uint8_t *out, const uint32_t count,
+	const int64_t x, const int64_t y, const int64_t dx, const int64_t dy);
+
+static inline int64_t floorDiv(const int64_t n, const int64_t d) {
+	int64_t q = n / d;
+	return (n % d != 0 && ((n < 0) != (d < 0))) ? q - 1 : q;
+}
+
+static inline int64_t ceilDiv(const int64_t n, const int64_t d) {
+	int64_t q = n / d;
+	return (n % d != 0 && ((n < 0) == (d < 0))) ? q + 1 : q;
+}
+
+/*!
+ * @brief Narrows [kBegin, kEnd) to the steps k for which lo <= s0 + k * ds <= hi.
+ *        Solved exactly on the fixed point values the sampling loop will see.
+ */
+static void clipRange(const int64_t s0, const int64_t ds, const int64_t lo, const int64_t hi,
+	int64_t &kBegin, int64_t &kEnd) {
+	if(ds == 0) {
+		if(s0 < lo || s0 > hi) { kEnd = kBegin; }
+		return;
+	}
+
+	int64_t first, last;
+	if(ds > 0) {
+		first = ceilDiv(lo - s0, ds);
+		last = floorDiv(hi - s0, ds);
+	} else {
+		first = ceilDiv(hi - s0, ds);
+		last = floorDiv(lo - s0, ds);
+	}
+
+	//Both ends stay inside the previous range, an empty range keeps kBegin == kEnd.
+	if(first > kBegin) { kBegin = (first < kEnd) ? first : kEnd; }
+	if(last + 1 < kEnd) { kEnd = (last + 1 > kBegin) ? last + 1 : kBegin; }
+}
+
+/*!
+ * @brief Bilinear sample of a pixel of 'CHANNELS' bytes where some of the 2x2
+ *        neighbours may be outside the source, those are replaced by the fill value.
+ */
+template<uint32_t CHANNELS>
+static inline void sampleBorder(const uint8_t *src, const int64_t width, const int64_t height, const uint32_t stride,
+	const int64_t sx, const int64_t sy, const uint8_t fill, uint8_t *out) {
+	int64_t x0 = sx >> FIX_BITS;
+	int64_t y0 = sy >> FIX_BITS;
+	uint32_t fx = (uint32_t)(sx >> 8) & 0xFF;
+	uint32_t fy = (uint32_t)(sy >> 8) & 0xFF;
+
+	const uint8_t *p[4];
+	for(int n = 0; n < 4; n++) {
+		int64_t x = x0 + (n & 1);
+		int64_t y = y0 + (n >> 1);
+		p[n] = (x >= 0 && x < width && y >= 0 && y < height) ? src + (size_t)y * stride + (size_t)x * CHANNELS : 0;
+	}
+
+	for(uint32_t c = 0; c < CHANNELS; c++) {
+		uint32_t top = (p[0] ? p[0][c] : fill) * (256 - fx) + (p[1] ? p[1][c] : fill) * fx;
+		uint32_t bot = (p[2] ? p[2][c] : fill) * (256 - fx) + (p[3] ? p[3][c] : fill) * fx;
+		out[c] = (uint8_t)((top * (256 - fy) + bot * fy + 32768) >> 16);
+	}
+}
+
+/*!
+ * @brief Samples destination pixels [kBegin, kEnd) of a segment whose reads are
+ *        all inside the source.
+ */
+template<uint32_t CHANNELS>
+static inline void sampleCore(const uint8_t *src, const uint32_t srcStride, uint8_t *out, int64_t k, const int64_t kEnd,
+	const int64_t sx, const int64_t sy, const int64_t dx, const int64_t dy, const Interpolation interp) {
+	int64_t x = sx + k * dx;
+	int64_t y = sy + k * dy;
+	if(interp == INTERP_NEAREST) {
+		for(; k < kEnd; k++) {
+			const uint8_t *p = src + (size_t)((y + FIX_HALF) >> FIX_BITS) * srcStride + (size_t)((x + FIX_HALF) >> FIX_BITS) * CHANNELS;
+			for(uint32_t c = 0; c < CHANNELS; c++) { out[k * CHANNELS + c] = p[c]; }
+			x += dx;
+			y += dy;
+		}
+	} else {
+		for(; k < kEnd; k++) {
+			const uint8_t *p = src + (size_t)(y >> FIX_BITS) * srcStride + (size_t)(x >> FIX_BITS) * CHANNELS;
+			uint32_t fx = (uint32_t)(x >> 8) & 0xFF;
+			uint32_t fy = (uint32_t)(y >> 8) & 0xFF;
+			for(uint32_t c = 0; c < CHANNELS; c++) {
+				uint32_t top = p[c] * (256 - fx) + p[c + CHANNELS] * fx;
+				uint32_t bot = p[srcStride + c] * (256 - fx) + p[srcStride + c + CHANNELS] * fx;
+				out[k * CHANNELS + c] = (uint8_t)((top * (256 - fy) + bot * fy + 32768) >> 16);
+			}
+			x += dx;
+			y += dy;
+		}
+	}
+}
+
+#ifdef BITMAP_X86
+
+/*!
+ * @brief Positions of 8 consecutive pixels, start plus 0..7 steps.
+ */
+SIMD_TARGET("avx2")
+static inline __m256i stepLanes(const int64_t start, const int64_t step) {
+	return _mm256_add_epi32(_mm256_set1_epi32((int32_t)start),
+		_mm256_mullo_epi32(_mm256_set1_epi32((int32_t)step), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+}
+
+/*!
+ * @brief Stores the low bytes of 8 lanes holding values 0..255.
+ */
+SIMD_TARGET("avx2")
+static inline void storeLanes(uint8_t *out, const __m256i value) {
+	__m256i bytes = _mm256_packus_epi16(_mm256_packus_epi32(value, value), _mm256_setzero_si256());
+	bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 1, 1, 1, 1, 1));
+	_mm_storel_epi64((__m128i *)out, _mm256_castsi256_si128(bytes));
+}
+
+/*!
+ * @brief AVX2 bilinear kernel, gathers the 2x2 neighbourhood of 8 positions as
+ *        two 4 byte loads each and blends with the scalar fixed point formula,
+ *        so the results are the same bytes.
+ * @return [int] - Number of pixels warped.
+ */
+SIMD_TARGET("avx2")
+static uint32_t bilinearRowAvx2(const uint8_t *src, const uint32_t srcStride, uint8_t *out, const uint32_t count,
+	const int64_t x, const int64_t y, const int64_t dx, const int64_t dy) {
+	const __m256i stride = _mm256_set1_epi32((int32_t)srcStride);
+	const __m256i mask = _mm256_set1_epi32(0xFF);
+	const __m256i one = _mm256_set1_epi32(256);
+	const __m256i round = _mm256_set1_epi32(32768);
+
+	uint32_t k = 0;
+	for(; k + 8 <= count; k += 8) {
+		__m256i vx = stepLanes(x + k * dx, dx);
+		__m256i vy = stepLanes(y + k * dy, dy);
+		__m256i fx = _mm256_and_si256(_mm256_srli_epi32(vx, 8), mask);
+		__m256i fy = _mm256_and_si256(_mm256_srli_epi32(vy, 8), mask);
+		__m256i offset = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_srai_epi32(vy, FIX_BITS), stride), _mm256_srai_epi32(vx, FIX_BITS));
+
+		__m256i upper = _mm256_i32gather_epi32((const int *)src, offset, 1);
+		__m256i lower = _mm256_i32gather_epi32((const int *)src, _mm256_add_epi32(offset, stride), 1);
+
+		//top = p0 * (256 - fx) + p1 * fx, the same for the bottom row.
+		__m256i wx = _mm256_sub_epi32(one, fx);
+		__m256i top = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_and_si256(upper, mask), wx),
+			_mm256_mullo_epi32(_mm256_and_si256(_mm256_srli_epi32(upper, 8), mask), fx));
+		__m256i bot = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_and_si256(lower, mask), wx),
+			_mm256_mullo_epi32(_mm256_and_si256(_mm256_srli_epi32(lower, 8), mask), fx));
+		__m256i value = _mm256_add_epi32(_mm256_mullo_epi32(top, _mm256_sub_epi32(one, fy)), _mm256_mullo_epi32(bot, fy));
+		storeLanes(out + k, _mm256_srli_epi32(_mm256_add_epi32(value, round), 16));
+	}
+	return k;
+}
+
+#endif
+
+/*!
+ * @brief Picks the gray bilinear row kernel for the given SIMD level. Only AVX2
+ *        has gathers, loading the neighbourhoods lane by lane is no faster than
+ *        the scalar loop, so SSE2 stays scalar. Nearest sampling is one load a
+ *        pixel which the gather does not beat, color pixels stay scalar as well.
+ *        Positions, steps and source offsets must fit the 32 bit lanes.
+ */
+static WarpRowKernel selectKernel(const SimdLevel level, const Interpolation interp, const uint32_t srcWidth,
+	const uint32_t srcHeight, const uint32_t srcStride, const int64_t dx, const int64_t dy) {
+#ifdef BITMAP_X86
+	int64_t stepX = (dx < 0) ? -dx : dx;
+	int64_t stepY = (dy < 0) ? -dy : dy;
+	bool fits = ((int64_t)srcWidth + 1) * FIX_ONE < LANE_LIMIT && ((int64_t)srcHeight + 1) * FIX_ONE < LANE_LIMIT &&
+		(int64_t)srcHeight * srcStride < LANE_LIMIT && stepX * 8 < LANE_LIMIT && stepY * 8 < LANE_LIMIT;
+	if(level == SIMD_AVX2 && interp == INTERP_BILINEAR && fits) { return bilinearRowAvx2; }
+#else
+	(void)level; (void)interp; (void)srcWidth; (void)srcHeight; (void)srcStride; (void)dx; (void)dy;
+#endif
+	return 0;
+}
+
+/*!
+ * @brief Warps 'count' destination pixels of 'CHANNELS' bytes of one row segment.
+ */
+template<uint32_t CHANNELS>
+static void warpSegment(const uint8_t *src, const uint32_t srcWidth, const uint32_t srcHeight, const uint32_t srcStride,
+	uint8_t *out, const uint32_t count, int64_t sx, int64_t sy, const int64_t dx, const int64_t dy,
+	const Interpolation interp, const uint8_t fill, const WarpRowKernel kernel) {
+	int64_t w = srcWidth;
+	int64_t h = srcHeight;
+
+	//Core: every sample read is inside the source, no checks in the loop.
+	//Edge: bilinear samples partially outside the source.
+	int64_t coreBegin = 0, coreEnd = count;
+	int64_t edgeBegin = 0, edgeEnd = count;
+
+	if(interp == INTERP_NEAREST) {
+		clipRange(sx, dx, -FIX_HALF, w * FIX_ONE - FIX_HALF - 1, coreBegin, coreEnd);
+		clipRange(sy, dy, -FIX_HALF, h * FIX_ONE - FIX_HALF - 1, coreBegin, coreEnd);
+		edgeBegin = coreBegin;
+		edgeEnd = coreEnd;
+	} else {
+		clipRange(sx, dx, 0, (w - 1) * FIX_ONE - 1, coreBegin, coreEnd);
+		clipRange(sy, dy, 0, (h - 1) * FIX_ONE - 1, coreBegin, coreEnd);
+		clipRange(sx, dx, -FIX_ONE + 1, w * FIX_ONE - 1, edgeBegin, edgeEnd);
+		clipRange(sy, dy, -FIX_ONE + 1, h * FIX_ONE - 1, edgeBegin, edgeEnd);
+		if(coreEnd <= coreBegin) { coreBegin = coreEnd = edgeEnd; }
+	}
+
+	int64_t k = 0;
+	memset(out, fill, (size_t)edgeBegin * CHANNELS);
+	k = edgeBegin;
+
+	for(; k < coreBegin; k++) {
+		sampleBorder<CHANNELS>(src, w, h, srcStride, sx + k * dx, sy + k * dy, fill, out + k * CHANNELS);
+	}
+
+	//Vector kernels take the part of the core whose 4 byte loads stay inside the rows.
+	int64_t vectorBegin = coreEnd, vectorEnd = coreEnd;
+	if(CHANNELS == 1 && kernel && coreBegin < coreEnd) {
+		vectorBegin = coreBegin;
+		clipRange(sx, dx, 0, (w - 3) * FIX_ONE - 1, vectorBegin, vectorEnd);
+		vectorEnd = vectorBegin + kernel(src, srcStride, out + vectorBegin, (uint32_t)(vectorEnd - vectorBegin),
+			sx + vectorBegin * dx, sy + vectorBegin * dy, dx, dy);
+	}
+
+	sampleCore<CHANNELS>(src, srcStride, out, k, vectorBegin, sx, sy, dx, dy, interp);
+	sampleCore<CHANNELS>(src, srcStride, out, vectorEnd, coreEnd, sx, sy, dx, dy, interp);
+	k = coreEnd;
+
+	for(; k < edgeEnd; k++) {
+		sampleBorder<CHANNELS>(src, w, h, srcStride, sx + k * dx, sy + k * dy, fill, out + k * CHANNELS);
+	}
+
+	memset(out + k * CHANNELS, fill, (size_t)(count - k) * CHANNELS);
+}
+
+static inline bool isNear(const double value, const double target, const double epsilon) {
+	return fabs(value - target) <= epsilon;
+}
+
+/*!
+ * @brief Recognises a mapping that only moves whole pixels by a right angle,
+ *        which a rotateQuarter() of a source sub rectangle reproduces exactly.
+ * @param [AffineMatrix] - Output to source mapping.
+ * @param [int] - Source width and height, output width and height.
+ * @param [QuarterTurn] - Receives the rotation.
+ * @param [int] - Receive the top left corner of the source sub rectangle.
+ * @return [boolean] - Set if the mapping is a right angle inside the source otherwise reset.
+ */
+static bool matchQuarterTurn(const AffineMatrix &m, const uint32_t srcWidth, const uint32_t srcHeight,
+	const uint32_t dstWidth, const uint32_t dstHeight, QuarterTurn &turn, int64_t &x0, int64_t &y0) {
+	if(dstWidth == 0 || dstHeight == 0) { return false; }
+	if(!isNear(m.c, nearbyint(m.c), SHIFT_EPSILON) || !isNear(m.f, nearbyint(m.f), SHIFT_EPSILON)) { return false; }
+
+	int64_t c = llround(m.c);
+	int64_t f = llround(m.f);
+	int64_t subWidth = dstWidth;
+	int64_t subHeight = dstHeight;
+
+	if(isNear(m.b, 0.0, UNIT_EPSILON) && isNear(m.d, 0.0, UNIT_EPSILON)) {
+		if(isNear(m.a, 1.0, UNIT_EPSILON) && isNear(m.e, 1.0, UNIT_EPSILON)) {
+			turn = TURN_0;
+			x0 = c;
+			y0 = f;
+		} else if(isNear(m.a, -1.0, UNIT_EPSILON) && isNear(m.e, -1.0, UNIT_EPSILON)) {
+			turn = TURN_180;
+			x0 = c - (dstWidth - 1);
+			y0 = f - (dstHeight - 1);
+		} else {
+			return false;
+		}
+	} else if(isNear(m.a, 0.0, UNIT_EPSILON) && isNear(m.e, 0.0, UNIT_EPSILON)) {
+		subWidth = dstHeight;
+		subHeight = dstWidth;
+		if(isNear(m.b, 1.0, UNIT_EPSILON) && isNear(m.d, -1.0, UNIT_EPSILON)) {
+			turn = TURN_90;
+			x0 = c;
+			y0 = f - (dstWidth - 1);
+		} else if(isNear(m.b, -1.0, UNIT_EPSILON) && isNear(m.d, 1.0, UNIT_EPSILON)) {
+			turn = TURN_270;
+			x0 = c - (dstHeight - 1);
+			y0 = f;
+		} else {
+			return false;
+		}
+	} else {
+		return false;
+	}
+
+	//Pixels mapped outside the source take the fill value, left to the general warp.
+	return (x0 >= 0 && y0 >= 0 && x0 + subWidth <= (int64_t)srcWidth && y0 + subHeight <= (int64_t)srcHeight);
+}
+
+/*!
+ * @brief Warps destination pixels [uBegin, uEnd) of row 'v'. Segments start at
+ *        multiples of WARP_TILE_COLS of the whole output, their first position
+ *        computed exactly and the rest stepped from it, so any part of a row is
+ *        sampled at the same positions. The source may be a window whose top
+ *        left pixel is (srcX, srcY) of the whole source.
+ */
+static void warpSpan(const uint8_t *src, const uint32_t srcWidth, const uint32_t srcHeight, const uint32_t srcStride,
+	const int64_t srcX, const int64_t srcY, uint8_t *out, const uint32_t uBegin, const uint32_t uEnd, const uint32_t v,
+	const AffineMatrix &m, const int64_t dx, const int64_t dy, const Interpolation interp, const uint8_t fill,
+	const uint32_t pixelBytes, const WarpRowKernel kernel) {
+	for(uint32_t u = uBegin; u < uEnd; ) {
+		uint32_t u0 = u - u % WARP_TILE_COLS;
+		uint32_t end = (uEnd - u0 > WARP_TILE_COLS) ? u0 + WARP_TILE_COLS : uEnd;
+
+		//Segment start is computed exactly, steps accumulate at most a tile width of rounding.
+		int64_t sx = llround((m.a * u0 + m.b * v + m.c) * FIX_ONE) + (int64_t)(u - u0) * dx - srcX * FIX_ONE;
+		int64_t sy = llround((m.d * u0 + m.e * v + m.f) * FIX_ONE) + (int64_t)(u - u0) * dy - srcY * FIX_ONE;
+		uint8_t *segment = out + (size_t)(u - uBegin) * pixelBytes;
+		if(pixelBytes == 4) {
+			warpSegment<4>(src, srcWidth, srcHeight, srcStride, segment, end - u, sx, sy, dx, dy, interp, fill, 0);
+		} else if(pixelBytes == 3) {
+			warpSegment<3>(src, srcWidth, srcHeight, srcStride, segment, end - u, sx, sy, dx, dy, interp, fill, 0);
+		} else {
+			warpSegment<1>(src, srcWidth, srcHeight, srcStride, segment, end - u, sx, sy, dx, dy, interp, fill, kernel);
+		}
+		u = end;
+	}
+}
+
+void warpAffine(const uint8_t *src, const uint32_t srcWidth, const uint32_t srcHeight, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstWidth, const uint32_t dstHeight, const uint32_t dstStride,
+	const AffineMatrix &inverse, const Interpolation interp, const uint8_t fill, const uint32_t pixelBytes) {
+	warpAffineWindow(src, srcWidth, srcHeight, srcStride, 0, 0, dst, 0, 0, dstWidth, dstHeight, dstStride,
+		inverse, interp, fill, pixelBytes);
+}
+
+void warpAffineWindow(const uint8_t *src, const uint32_t srcWidth, const uint32_t srcHeight, const uint32_t srcStride,
+	const int64_t srcX, const int64_t srcY, uint8_t *dst, const uint32_t dstX, const uint32_t dstY,
+	const uint32_t dstWidth, const uint32_t dstHeight, const uint32_t dstStride,
+	const AffineMatrix &inverse, const Interpolation interp, const uint8_t fill, const uint32_t pixelBytes) {
+	const AffineMatrix &m = inverse;
+
+	//Whole pixel right angles copy the pixels without sampling, the same pixels
+	//the sampling loop would produce.
+	AffineMatrix local = m;
+	local.c = m.c + m.a * dstX + m.b * dstY - srcX;
+	local.f = m.f + m.d * dstX + m.e * dstY - srcY;
+	QuarterTurn turn;
+	int64_t x0, y0;
+	if(matchQuarterTurn(local, srcWidth, srcHeight, dstWidth, dstHeight, turn, x0, y0)) {
+		uint32_t subWidth = (turn == TURN_90 || turn == TURN_270) ? dstHeight : dstWidth;
+		uint32_t subHeight = (turn == TURN_90 || turn == TURN_270) ? dstWidth : dstHeight;
+		rotateQuarter(src + (size_t)y0 * srcStride + (size_t)x0 * pixelBytes, subWidth, subHeight, srcStride, dst, dstStride,
+			pixelBytes, turn);
+		return;
+	}
+
+	//Per pixel steps along a destination row.
+	int64_t dx = llround(m.a * FIX_ONE);
+	int64_t dy = llround(m.d * FIX_ONE);
+	WarpRowKernel kernel = (pixelBytes == 1) ? selectKernel(getSimdLevel(), interp, srcWidth, srcHeight, srcStride, dx, dy) : 0;
+
+	ThreadPool::getShared().parallelFor(0, dstHeight, WARP_TILE_ROWS, [&](uint32_t first, uint32_t last) {
+		for(uint32_t tileRow = first; tileRow < last; tileRow += WARP_TILE_ROWS) {
+			uint32_t tileEnd = (last - tileRow > WARP_TILE_ROWS) ? tileRow + WARP_TILE_ROWS : last;
+
+			//Column tiles follow the segments of the whole output.
+			for(uint32_t u = dstX; u < dstX + dstWidth; ) {
+				uint32_t uEnd = u - u % WARP_TILE_COLS + WARP_TILE_COLS;
+				if(uEnd > dstX + dstWidth) { uEnd = dstX + dstWidth; }
+
+				for(uint32_t i = tileRow; i < tileEnd; i++) {
+					uint8_t *out = dst + (size_t)i * dstStride + (size_t)(u - dstX) * pixelBytes;
+					warpSpan(src, srcWidth, srcHeight, srcStride, srcX, srcY, out, u, uEnd, dstY + i, m, dx, dy,
+						interp, fill, pixelBytes, kernel);
+				}
+				u = uEnd;
+			}
+		}
+	});
+}
+
+AffineMatrix composeAffine(const AffineMatrix &outer, const AffineMatrix &inner) {
+	AffineMatrix m;
+	m.a = outer.a * inner.a + outer.b * inner.d;
+	m.b = outer.a * inner.b + outer.b * inner.e;
+	m.c = outer.a * inner.c + outer.b * inner.f + outer.c;
+	m.d = outer.d * inner.a + outer.e * inner.d;
+	m.e = outer.d * inner.b + outer.e * inner.e;
+	m.f = outer.d * inner.c + outer.e * inner.f + outer.f;
+	return m;
+}
+
+AffineMatrix identityAffine(void) {
+	AffineMatrix m;
+	m.a = 1.0; m.b = 0.0; m.c = 0.0;
+	m.d = 0.0; m.e = 1.0; m.f = 0.0;
+	return m;
+}
@@ -0,0 +1,143 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.6
+ *          - 1.0.0 - Added inverse mapping affine warp with nearest and bilinear sampling.
+ *          - 1.0.1 - Added composition of mappings for fused geometry.
+ *          - 1.0.3 - Added interleaved BGR24 warps.
+ *          - 1.0.4 - Added warps of destination rectangles from source windows, matching whole image warps.
+ *          - 1.0.5 - Added AVX2 gray bilinear rows.
+ *          - 1.0.6 - Added interleaved BGRA32 warps.
+ *
+ * @desc Inverse mapping affine warp of 8 bit planes, BGR24 and BGRA32 images,
+ *       used for rotation.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/*! Sampling used when warping */
+enum Interpolation {
+	INTERP_NEAREST = 0,				/*! Nearest source pixel */
+	INTERP_BILINEAR					/*! Weighted 2x2 source neighbourhood */
+};
+
+/*!
+ * Inverse affine mapping from a destination pixel (u, v) to the source
+ * position (x, y), pixel centers are at integer coordinates.
+ *     x = a * u + b * v + c
+ *     y = d * u + e * v + f
+ */
+struct AffineMatrix {
+	double a, b, c;
+	double d, e, f;
+};
+
+/*! Geometric operations that can be fused into one warp */
+enum GeometryOp {
+	GEOMETRY_ROTATE = 0,			/*! Rotation about the center by 'x' degrees, output sized to the bounding box */
+	GEOMETRY_SCALE,					/*! Scaling by 'x' and 'y', output sized to the scaled image */
+	GEOMETRY_TRANSLATE				/*! Translation by 'x' and 'y' pixels, output keeps its size */
+};
+
+/*! One step of a fused geometry pipeline */
+struct GeometryStep {
+	GeometryOp op;
+	double x;
+	double y;
+};
+
+static const uint32_t WARP_TILE_ROWS	= 64;		//Destination rows per tile
+static const uint32_t WARP_TILE_COLS	= 256;		//Destination columns per tile
+
+/*!
+ * @brief Fills the destination plane by sampling the source plane through the
+ *        inverse mapping. Destination pixels mapping outside the source get the
+ *        fill value, bilinear samples straddling the border are blended with it.
+ *        Work is split into tiles that are processed in parallel row bands.
+ *        Interleaved BGR24 and BGRA32 pixels are sampled with one position per
+ *        pixel for all their channels.
+ *        Gray bilinear rows gather their neighbourhoods with AVX2 where the
+ *        CPU has it, nearest sampling, color pixels and older CPUs are scalar.
+ * @param [string] - Source plane.
+ * @param [int] - Source width.
+ * @param [int] - Source height.
+ * @param [int] - Source row stride in bytes.
+ * @param [string] - Destination plane.
+ * @param [int] - Destination width.
+ * @param [int] - Destination height.
+ * @param [int] - Destination row stride in bytes.
+ * @param [AffineMatrix] - Destination to source mapping.
+ * @param [Interpolation] - Sampling to be used.
+ * @param [int] - Value of pixels mapping outside the source, used for every channel.
+ * @param [int] - Bytes per pixel, 1, 3 or 4.
+ * @return None
+ */
+void warpAffine(const uint8_t *src, const uint32_t srcWidth, const uint32_t srcHeight, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstWidth, const uint32_t dstHeight, const uint32_t dstStride,
+	const AffineMatrix &inverse, const Interpolation interp, const uint8_t fill, const uint32_t pixelBytes = 1);
+
+/*!
+ * @brief Warps the rectangle at (dstX, dstY) of a larger destination from a
+ *        window of the source whose top left pixel is (srcX, srcY). Pixels get
+ *        exactly the values warpAffine() gives them on the whole images, so
+ *        rectangles warped one at a time put together the same output. The
+ *        window must hold every source pixel the rectangle samples, its edges
+ *        are only treated as borders where they are the source's own.
+ * @param [string] - Source window.
+ * @param [int] - Window width.
+ * @param [int] - Window height.
+ * @param [int] - Window row stride in bytes.
+ * @param [int] - Source column of the window's first pixel.
+ * @param [int] - Source row of the window's first row.
+ * @param [string] - First pixel of the destination rectangle.
+ * @param [int] - Destination column of the rectangle.
+ * @param [int] - Destination row of the rectangle.
+ * @param [int] - Rectangle width.
+ * @param [int] - Rectangle height.
+ * @param [int] - Destination row stride in bytes.
+ * @param [AffineMatrix] - Destination to source mapping of the whole images.
+ * @param [Interpolation] - Sampling to be used.
+ * @param [int] - Value of pixels mapping outside the source, used for every channel.
+ * @param [int] - Bytes per pixel, 1, 3 or 4.
+ * @return None
+ */
+void warpAffineWindow(const uint8_t *src, const uint32_t srcWidth, const uint32_t srcHeight, const uint32_t srcStride,
+	const int64_t srcX, const int64_t srcY, uint8_t *dst, const uint32_t dstX, const uint32_t dstY,
+	const uint32_t dstWidth, const uint32_t dstHeight, const uint32_t dstStride,
+	const AffineMatrix &inverse, const Interpolation interp, const uint8_t fill, const uint32_t pixelBytes = 1);
+
+/*!
+ * @brief Composes two mappings, the result applies 'inner' first and 'outer'
+ *        to its result: composed(p) = outer(inner(p)).
+ * @param [AffineMatrix] - Mapping applied last.
+ * @param [AffineMatrix] - Mapping applied first.
+ * @return [AffineMatrix] - Composed mapping.
+ */
+AffineMatrix composeAffine(const AffineMatrix &outer, const AffineMatrix &inner);
+
+/*!
+ * @brief Returns the identity mapping.
+ * @param None
+ * @return [AffineMatrix] - Identity.
+ */
+AffineMatrix identityAffine(void);
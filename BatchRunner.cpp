@@ -0,0 +1,693 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.8
+ *          - 1.0.0 - Added batch processing of many files on a worker pool.
+ *          - 1.0.1 - Added fused geometry runs.
+ *          - 1.0.2 - Added composed point operations.
+ *          - 1.0.3 - Added neighbourhood filters.
+ *          - 1.0.4 - Added trace output.
+ *          - 1.0.5 - Added overlapped read, process and write stages.
+ *          - 1.0.6 - Added run length encoded outputs.
+ *          - 1.0.7 - Added image pyramid outputs.
+ *          - 1.0.8 - Added source regions.
+ *
+ * @desc Non-interactive batch processing of 'BMP' files, every file is run
+ *       through a list of operations by a pool of worker threads.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include "BatchRunner.h"
+#include "FilePrefetcher.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+/*!
+ * @brief Matches a file name against a pattern with '*' and '?' wildcards.
+ * @param [string] - Pattern.
+ * @param [string] - File name.
+ * @return [boolean] - Set if the name matches otherwise reset.
+ */
+static bool matchWildcard(const char *pattern, const char *name) {
+	const char *star = 0;
+	const char *resume = 0;
+	while(*name) {
+		if(*pattern == '*') { star = pattern++; resume = name; }
+		else if(*pattern == '?' || *pattern == *name) { pattern++; name++; }
+		else if(star) { pattern = star + 1; name = ++resume; }
+		else { return false; }
+	}
+	while(*pattern == '*') { pattern++; }
+	return *pattern == 0;
+}
+
+/*!
+ * @brief Checks for the '.bmp' extension in any letter case.
+ * @param [path] - File path.
+ * @return [boolean] - Set if it is a 'BMP' file name otherwise reset.
+ */
+static bool isBitmapName(const fs::path &path) {
+	std::string ext = path.extension().string();
+	for(char &c : ext) { c = (char)tolower((unsigned char)c); }
+	return ext == ".bmp";
+}
+
+/*!
+ * @brief Checks for the operations that only remap gray values.
+ * @param [BatchOpType] - Operation.
+ * @return [boolean] - Set if it is a point operation otherwise reset.
+ */
+static bool isPointOperation(const BatchOpType type) {
+	return type >= BATCH_GAMMA && type <= BATCH_EQUALIZE;
+}
+
+/*!
+ * @brief Checks for the operations that can be fused into one warp.
+ * @param [BatchOpType] - Operation.
+ * @return [boolean] - Set if it is a geometry operation otherwise reset.
+ */
+static bool isGeometryOperation(const BatchOpType type) {
+	return type == BATCH_ROTATE || type == BATCH_SCALE || type == BATCH_TRANSLATE;
+}
+
+/*!
+ * @brief Creates the lookup table of a point operation, equalization is
+ *        image dependent and left as the identity.
+ * @param [BatchOperation] - Operation.
+ * @return [PointLut] - Table of the operation.
+ */
+static PointLut operationLut(const BatchOperation &op) {
+	switch(op.type) {
+		case BATCH_GAMMA: return PointLut::gamma(op.x);
+		case BATCH_BRIGHTNESS: return PointLut::brightness((int32_t)lround(op.x));
+		case BATCH_CONTRAST: return PointLut::contrast(op.x);
+		case BATCH_THRESHOLD: return PointLut::threshold((uint8_t)op.x);
+		case BATCH_INVERT: return PointLut::invert();
+		case BATCH_WINDOW: return PointLut::window((uint8_t)op.x, (uint8_t)op.y);
+		default: break;
+	}
+	return PointLut();
+}
+
+/*!
+ * @brief Returns the name of the operation for status messages.
+ * @param [BatchOpType] - Operation.
+ * @return [string] - Name of the operation.
+ */
+static const char *operationName(const BatchOpType type) {
+	switch(type) {
+		case BATCH_GRAY: return "gray conversion";
+		case BATCH_ROTATE: return "rotation";
+		case BATCH_SCALE: return "scaling";
+		case BATCH_TRANSLATE: return "translation";
+		case BATCH_EQUALIZE: return "equalization";
+		case BATCH_BLUR: return "gaussian blur";
+		case BATCH_BOX: return "box blur";
+		case BATCH_MEDIAN: return "median filter";
+		case BATCH_GRADIENT: return "gradient";
+		default: break;
+	}
+	if(isPointOperation(type)) { return "point operation"; }
+	return "operation";
+}
+
+BatchRunner::BatchRunner() {
+	workers = 0;
+	stripRows = 0;
+	failedCount = 0;
+	verbose = true;
+	fuseGeometry = false;
+	rleOutput = false;
+	pyramidCount = 0;
+	pyramidFilter = PYRAMID_BOX;
+	memset(&region, 0, sizeof(region));
+	prefetchDepth = DEFAULT_PREFETCH_DEPTH;
+	inFlightLimit = DEFAULT_IN_FLIGHT_LIMIT;
+	outputDir = ".";
+}
+
+BatchRunner::~BatchRunner() {
+
+}
+
+bool BatchRunner::addOperation(const char *spec) {
+	std::string text = spec;
+	std::string name = text.substr(0, text.find(':'));
+	std::string params = (text.find(':') == std::string::npos) ? "" : text.substr(text.find(':') + 1);
+	std::string mode = (params.find(':') == std::string::npos) ? "" : params.substr(params.find(':') + 1);
+	params = params.substr(0, params.find(':'));
+
+	BatchOperation op;
+	op.x = 0.0;
+	op.y = 0.0;
+	op.mode = 0;
+
+	//Gray conversion and gradients take the mode in place of values.
+	if((name == "gray" || name == "sobel" || name == "scharr") && mode.empty()) { mode = params; params.clear(); }
+
+	//Values are "x" or "x,y", a single value is used for both axes.
+	int values = 0;
+	if(!params.empty()) {
+		char *end = 0;
+		op.x = strtod(params.c_str(), &end);
+		values = 1;
+		if(*end == ',') { op.y = strtod(end + 1, &end); values = 2; }
+		if(*end != 0) { return false; }
+		if(values == 1) { op.y = op.x; }
+	}
+
+	if(name == "gray") {
+		op.type = BATCH_GRAY;
+		if(values != 0) { return false; }
+		if(mode.empty() || mode == "average") { op.mode = LUMA_AVERAGE; }
+		else if(mode == "bt601") { op.mode = LUMA_BT601; }
+		else if(mode == "bt709") { op.mode = LUMA_BT709; }
+		else { return false; }
+	} else if(name == "rotate") {
+		op.type = BATCH_ROTATE;
+		if(values != 1) { return false; }
+		if(mode.empty() || mode == "bilinear") { op.mode = INTERP_BILINEAR; }
+		else if(mode == "nearest") { op.mode = INTERP_NEAREST; }
+		else { return false; }
+	} else if(name == "scale") {
+		op.type = BATCH_SCALE;
+		if(values == 0) { return false; }
+		if(mode.empty() || mode == "bilinear") { op.mode = FILTER_BILINEAR; }
+		else if(mode == "nearest") { op.mode = FILTER_NEAREST; }
+		else if(mode == "bicubic") { op.mode = FILTER_BICUBIC; }
+		else if(mode == "lanczos3") { op.mode = FILTER_LANCZOS3; }
+		else if(mode == "area") { op.mode = FILTER_AREA; }
+		else { return false; }
+	} else if(name == "translate") {
+		op.type = BATCH_TRANSLATE;
+		if(values != 2 || !mode.empty()) { return false; }
+	} else if(name == "gamma" || name == "brightness" || name == "contrast" || name == "threshold") {
+		op.type = (name == "gamma") ? BATCH_GAMMA : (name == "brightness") ? BATCH_BRIGHTNESS :
+			(name == "contrast") ? BATCH_CONTRAST : BATCH_THRESHOLD;
+		if(values != 1 || !mode.empty()) { return false; }
+		if(op.type == BATCH_GAMMA && op.x <= 0.0) { return false; }
+		if(op.type == BATCH_THRESHOLD && (op.x < 0.0 || op.x > 255.0)) { return false; }
+	} else if(name == "window") {
+		op.type = BATCH_WINDOW;
+		if(values != 2 || !mode.empty()) { return false; }
+		if(op.x < 0.0 || op.y > 255.0 || op.x >= op.y) { return false; }
+	} else if(name == "invert" || name == "equalize") {
+		op.type = (name == "invert") ? BATCH_INVERT : BATCH_EQUALIZE;
+		if(values != 0 || !mode.empty()) { return false; }
+	} else if(name == "blur") {
+		op.type = BATCH_BLUR;
+		if(values != 1 || !mode.empty()) { return false; }
+		if(op.x <= 0.0 || op.x > FILTER_MAX_RADIUS / 3.0) { return false; }
+	} else if(name == "box" || name == "median") {
+		op.type = (name == "box") ? BATCH_BOX : BATCH_MEDIAN;
+		if(values != 1 || !mode.empty()) { return false; }
+		if(op.x < 0.0 || op.x > FILTER_MAX_RADIUS || op.x != floor(op.x)) { return false; }
+	} else if(name == "sobel" || name == "scharr") {
+		op.type = BATCH_GRADIENT;
+		op.x = (name == "sobel") ? GRADIENT_SOBEL : GRADIENT_SCHARR;
+		if(values != 0) { return false; }
+		if(mode.empty() || mode == "magnitude") { op.mode = GRADIENT_MAGNITUDE; }
+		else if(mode == "x") { op.mode = GRADIENT_X; }
+		else if(mode == "y") { op.mode = GRADIENT_Y; }
+		else { return false; }
+	} else {
+		return false;
+	}
+
+	operations.push_back(op);
+	return true;
+}
+
+bool BatchRunner::setPyramid(const char *spec) {
+	std::string text = spec;
+	std::string mode = (text.find(':') == std::string::npos) ? "" : text.substr(text.find(':') + 1);
+
+	char *end = 0;
+	long levels = strtol(text.c_str(), &end, 10);
+	if(end == text.c_str() || (*end != 0 && *end != ':') || levels < 1 || levels > (long)PYRAMID_MAX_LEVELS) { return false; }
+
+	if(mode.empty() || mode == "box") { pyramidFilter = PYRAMID_BOX; }
+	else if(mode == "gaussian") { pyramidFilter = PYRAMID_GAUSSIAN; }
+	else { return false; }
+	pyramidCount = (uint32_t)levels;
+	return true;
+}
+
+bool BatchRunner::setRegion(const char *spec) {
+	//Four unsigned values, the window must not be empty.
+	uint32_t values[4];
+	const char *p = spec;
+	for(uint32_t i = 0; i < 4; i++) {
+		char *end = 0;
+		long value = strtol(p, &end, 10);
+		if(end == p || value < 0 || value > (long)UINT32_MAX || *end != ((i < 3) ? ',' : 0)) { return false; }
+		values[i] = (uint32_t)value;
+		p = end + 1;
+	}
+	if(values[2] == 0 || values[3] == 0) { return false; }
+
+	region.x = values[0];
+	region.y = values[1];
+	region.width = values[2];
+	region.height = values[3];
+	return true;
+}
+
+bool BatchRunner::addInput(const char *path) {
+	size_t before = files.size();
+	try {
+		fs::path input(path);
+		std::string name = input.filename().string();
+
+		if(name.find_first_of("*?") != std::string::npos) {
+			//Wildcards are matched against the names of one directory.
+			fs::path dir = input.has_parent_path() ? input.parent_path() : fs::path(".");
+			for(const fs::directory_entry &entry : fs::directory_iterator(dir)) {
+				std::string entryName = entry.path().filename().string();
+				if(entry.is_regular_file() && matchWildcard(name.c_str(), entryName.c_str())) {
+					addFile(entry.path().string(), entryName);
+				}
+			}
+		} else if(fs::is_directory(input)) {
+			for(const fs::directory_entry &entry : fs::recursive_directory_iterator(input)) {
+				if(entry.is_regular_file() && isBitmapName(entry.path())) {
+					addFile(entry.path().string(), fs::relative(entry.path(), input).string());
+				}
+			}
+		} else if(fs::is_regular_file(input)) {
+			addFile(input.string(), name);
+		}
+	} catch(std::exception &e) {
+		std::cout << e.what() << std::endl;
+	}
+
+	if(files.size() == before) { std::cout << "No input files found for " << path << std::endl; }
+	return files.size() > before;
+}
+
+bool BatchRunner::addManifest(const char *fileName) {
+	std::ifstream manifest(fileName);
+	if(!manifest.is_open()) {
+		std::cout << "Unable to read " << fileName << std::endl;
+		return false;
+	}
+
+	std::string line;
+	while(std::getline(manifest, line)) {
+		while(!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) { line.pop_back(); }
+		if(line.empty() || line[0] == '#') { continue; }
+		addInput(line.c_str());
+	}
+	return true;
+}
+
+void BatchRunner::addFile(const std::string &input, const std::string &relative) {
+	BatchFile file;
+	file.input = input;
+	file.output = relative;
+	files.push_back(file);
+}
+
+bool BatchRunner::run(void) {
+	failedCount = 0;
+	if((operations.empty() && !pyramidCount && !hasRegion()) || files.empty()) { return false; }
+
+	uint32_t threads = workers ? workers : std::thread::hardware_concurrency();
+	if(threads == 0) { threads = 1; }
+	if(threads > files.size()) { threads = (uint32_t)files.size(); }
+
+	//Files are spread over the workers, so every operation runs single threaded
+	//instead of competing with the other workers for the shared pool.
+	uint32_t libraryThreads = BitmapHandler::getThreadCount();
+	if(threads > 1) { BitmapHandler::setThreadCount(1); }
+
+	//Every handler call appends its trace to the shared file.
+	FILE *traceOutput = 0;
+	if(!traceFile.empty()) {
+		traceOutput = fopen(traceFile.c_str(), "a");
+		if(!traceOutput) { std::cout << "Unable to open " << traceFile << std::endl; }
+	}
+
+	std::atomic<size_t> next(0);
+	std::atomic<uint32_t> failed(0);
+	std::atomic<uint64_t> totalPixels(0);
+	std::mutex printMutex;
+	auto start = std::chrono::steady_clock::now();
+
+	auto report = [&](const size_t i, const bool ok, const std::string &message, const double ms, const uint64_t pixels) {
+		if(ok) { totalPixels += pixels; } else { failed++; }
+		if(verbose || !ok) {
+			std::lock_guard<std::mutex> lock(printMutex);
+			if(ok) {
+				std::cout << "[ok]   " << files[i].input << " (" << ms << " ms)" << std::endl;
+			} else {
+				std::cout << "[fail] " << files[i].input << ": " << message << std::endl;
+			}
+		}
+	};
+
+	auto worker = [&]() {
+		BitmapHandler bmp;
+		bmp.setStripRows(stripRows);
+		bmp.setTracing(traceOutput != 0);
+		bmp.setTraceOutput(traceOutput);
+		bmp.setRunLengthOutput(rleOutput);
+		bmp.setRegion(region);
+
+		for(size_t i = next++; i < files.size(); i = next++) {
+			std::string message;
+			uint64_t pixels = 0;
+			auto fileStart = std::chrono::steady_clock::now();
+
+			bool ok = false;
+			try {
+				ok = processFile(bmp, files[i], message, pixels);
+			} catch(std::exception &e) {
+				message = e.what();
+			}
+			report(i, ok, message, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - fileStart).count(), pixels);
+		}
+	};
+
+	//Whole images are read ahead and written behind their processing, so the disk
+	//and the cores work at the same time. Streamed single operations, pyramids of
+	//the inputs and windows read only their rows themselves and keep the plain workers.
+	if(prefetchDepth && !operations.empty() && !hasRegion() && !(stripRows && operations.size() == 1)) {
+		runPipeline(threads, traceOutput, report);
+	} else {
+		std::vector<std::thread> pool;
+		for(uint32_t t = 1; t < threads; t++) { pool.emplace_back(worker); }
+		worker();
+		for(std::thread &t : pool) { t.join(); }
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if(threads > 1) { BitmapHandler::setThreadCount(libraryThreads); }
+	if(traceOutput) { fclose(traceOutput); }
+
+	failedCount = failed;
+	std::cout << files.size() - failedCount << " of " << files.size() << " files processed in " << seconds << " s, "
+		<< threads << " workers, " << (seconds > 0.0 ? files.size() / seconds : 0.0) << " files/s, "
+		<< (seconds > 0.0 ? totalPixels / (seconds * 1e6) : 0.0) << " MP/s" << std::endl;
+
+	return failedCount == 0;
+}
+
+void BatchRunner::runPipeline(const uint32_t threads, FILE *traceOutput, const ReportFunction &report) {
+	std::vector<std::string> names;
+	for(const BatchFile &file : files) { names.push_back(file.input); }
+
+	FilePrefetcher prefetcher;
+	if(!prefetcher.start(names, prefetchDepth, inFlightLimit)) {
+		for(size_t i = 0; i < files.size(); i++) { report(i, false, "unable to start reading", 0.0, 0); }
+		return;
+	}
+	if(verbose) {
+		std::cout << "Reading " << prefetchDepth << " files ahead with " << (prefetcher.isUsingRing() ? "io_uring" : "reader threads")
+			<< ", " << (inFlightLimit >> 20) << " MiB in flight" << std::endl;
+	}
+
+	//A processed image waits in this queue for the writer, a full queue stops the workers.
+	BoundedQueue<PendingWrite> writes(threads);
+
+	auto worker = [&]() {
+		BitmapHandler bmp;
+		bmp.setTracing(traceOutput != 0);
+		bmp.setTraceOutput(traceOutput);
+		bmp.setRunLengthOutput(rleOutput);
+		bmp.setRegion(region);
+
+		PrefetchedFile file;
+		while(prefetcher.next(file)) {
+			PendingWrite write;
+			write.index = file.index;
+			write.bytes = file.bytes;
+			write.pixels = 0;
+			write.start = std::chrono::steady_clock::now();
+
+			std::string message;
+			bool ok = false;
+			try {
+				if(!file.data) {
+					message = "unable to read";
+				} else if(!bmp.loadImage(file.data, write.image)) {
+					message = "unable to load";
+				} else {
+					write.pixels = (uint64_t)write.image.getWidth() * write.image.getHeight();
+					ok = runOperations(bmp, write.image, message);
+					if(ok && pyramidCount && !bmp.buildPyramid(write.image, write.levels, pyramidCount, pyramidFilter)) {
+						message = "pyramid failed";
+						ok = false;
+					}
+				}
+			} catch(std::exception &e) {
+				message = e.what();
+			}
+			file.data.reset();											//The image keeps a view of it alive
+
+			if(ok) {
+				if(writes.push(std::move(write))) { continue; }
+				message = "unable to save";
+			}
+			write.image = BitmapImage();
+			write.levels.clear();
+			prefetcher.release(file.bytes);
+			report(file.index, false, message,
+				std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - write.start).count(), 0);
+		}
+	};
+
+	auto writer = [&]() {
+		BitmapHandler bmp;
+		bmp.setTracing(traceOutput != 0);
+		bmp.setTraceOutput(traceOutput);
+		bmp.setRunLengthOutput(rleOutput);
+		bmp.setRegion(region);
+
+		PendingWrite write;
+		while(writes.pop(write)) {
+			std::string outName = outputName(files[write.index]);
+			bool ok = false;
+			try {
+				ok = bmp.saveImage((const uint8_t *)outName.c_str(), write.image) && saveLevels(bmp, write.levels, outName);
+			} catch(std::exception &e) {
+				ok = false;
+			}
+
+			//The bytes of the source count until its image is gone.
+			write.image = BitmapImage();
+			write.levels.clear();
+			prefetcher.release(write.bytes);
+			report(write.index, ok, "unable to save",
+				std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - write.start).count(), write.pixels);
+		}
+	};
+
+	std::thread writerThread(writer);
+	std::vector<std::thread> pool;
+	for(uint32_t t = 1; t < threads; t++) { pool.emplace_back(worker); }
+	worker();
+	for(std::thread &t : pool) { t.join(); }
+
+	writes.close();
+	writerThread.join();
+	prefetcher.stop();
+}
+
+std::string BatchRunner::outputName(const BatchFile &file) const {
+	fs::path output = fs::path(outputDir) / file.output;
+	if(output.has_parent_path()) {
+		std::error_code ec;
+		fs::create_directories(output.parent_path(), ec);
+	}
+	return output.string();
+}
+
+uint64_t BatchRunner::sourcePixels(BitmapHandler &bmp, const uint8_t *fileName) const {
+	bmp.getImageInfo(fileName);
+	ImageRect window = { 0, 0, bmp.getImageWidth(), bmp.getImageHeight() };
+	if(hasRegion()) {
+		window = region;
+		if(!clipRect(window, bmp.getImageWidth(), bmp.getImageHeight())) { return 0; }
+	}
+	return (uint64_t)window.width * window.height;
+}
+
+std::vector<std::string> BatchRunner::levelNames(const std::string &output) const {
+	fs::path path(output);
+	std::vector<std::string> names;
+	for(uint32_t k = 1; k <= pyramidCount; k++) {
+		names.push_back((path.parent_path() / (path.stem().string() + "_" + std::to_string(1u << k) + path.extension().string())).string());
+	}
+	return names;
+}
+
+bool BatchRunner::saveLevels(BitmapHandler &bmp, const std::vector<BitmapImage> &levels, const std::string &output) {
+	std::vector<std::string> names = levelNames(output);
+	for(size_t k = 0; k < levels.size(); k++) {
+		if(!bmp.saveImage((const uint8_t *)names[k].c_str(), levels[k])) { return false; }
+	}
+	return true;
+}
+
+bool BatchRunner::processFile(BitmapHandler &bmp, const BatchFile &file, std::string &message, uint64_t &pixels) {
+	const uint8_t *srcFile = (const uint8_t *)file.input.c_str();
+	std::string outName = outputName(file);
+	const uint8_t *dstFile = (const uint8_t *)outName.c_str();
+
+	//Pyramids of the inputs are streamed out in one pass over the file.
+	if(operations.empty() && pyramidCount) {
+		pixels = sourcePixels(bmp, srcFile);
+		if(!bmp.buildPyramid(srcFile, levelNames(outName), pyramidFilter)) { message = "pyramid failed"; return false; }
+		return true;
+	}
+
+	//Strip streaming of a single operation goes through the file based call.
+	if(stripRows && operations.size() == 1) {
+		pixels = sourcePixels(bmp, srcFile);
+
+		const BatchOperation &op = operations[0];
+		bool ok = false;
+		switch(op.type) {
+			case BATCH_GRAY: ok = bmp.convert2Gray(srcFile, dstFile, (LumaWeights)op.mode); break;
+			case BATCH_ROTATE: ok = bmp.rotateImage(srcFile, dstFile, op.x, (Interpolation)op.mode); break;
+			case BATCH_SCALE: ok = bmp.scaleImage(srcFile, dstFile, op.x, op.y, (ResampleFilter)op.mode); break;
+			case BATCH_TRANSLATE: ok = bmp.translatedImage(srcFile, dstFile, (int32_t)lround(op.x), (int32_t)lround(op.y)); break;
+			case BATCH_EQUALIZE: ok = bmp.equalizeImage(srcFile, dstFile); break;
+			case BATCH_BLUR: ok = bmp.gaussianBlur(srcFile, dstFile, op.x); break;
+			case BATCH_BOX: ok = bmp.boxBlur(srcFile, dstFile, (uint32_t)op.x); break;
+			case BATCH_MEDIAN: ok = bmp.medianFilter(srcFile, dstFile, (uint32_t)op.x); break;
+			case BATCH_GRADIENT: ok = bmp.gradientImage(srcFile, dstFile, (GradientOperator)(int)op.x, (GradientOutput)op.mode); break;
+			default: ok = bmp.applyLut(srcFile, dstFile, operationLut(op)); break;
+		}
+		if(!ok) { message = std::string(operationName(op.type)) + " failed"; return false; }
+
+		//Levels of the output are streamed from the file just written.
+		if(pyramidCount && !bmp.buildPyramid(dstFile, levelNames(outName), pyramidFilter)) { message = "pyramid failed"; return false; }
+		return true;
+	}
+
+	//Operations are chained in memory, the file is read and written once.
+	BitmapImage image;
+	if(!bmp.loadImage(srcFile, image)) { message = "unable to load"; return false; }
+	pixels = (uint64_t)image.getWidth() * image.getHeight();
+
+	if(!runOperations(bmp, image, message)) { return false; }
+	if(!bmp.saveImage(dstFile, image)) { message = "unable to save"; return false; }
+
+	std::vector<BitmapImage> levels;
+	if(pyramidCount && (!bmp.buildPyramid(image, levels, pyramidCount, pyramidFilter) || !saveLevels(bmp, levels, outName))) {
+		message = "pyramid failed";
+		return false;
+	}
+	return true;
+}
+
+bool BatchRunner::runOperations(BitmapHandler &bmp, BitmapImage &image, std::string &message) {
+	for(size_t i = 0; i < operations.size(); i++) {
+		const BatchOperation &op = operations[i];
+		if(isPointOperation(op.type)) {
+			if(!runPoint(bmp, image, i)) { message = "point operation failed"; return false; }
+			continue;
+		}
+		if(fuseGeometry && isGeometryOperation(op.type)) {
+			if(!runGeometry(bmp, image, i)) { message = "transform failed"; return false; }
+			continue;
+		}
+
+		bool ok = false;
+		switch(op.type) {
+			case BATCH_GRAY: ok = bmp.convert2Gray(image, image, (LumaWeights)op.mode); break;
+			case BATCH_ROTATE: ok = bmp.rotateImage(image, image, op.x, (Interpolation)op.mode); break;
+			case BATCH_SCALE: ok = bmp.scaleImage(image, image, op.x, op.y, (ResampleFilter)op.mode); break;
+			case BATCH_TRANSLATE: ok = bmp.translatedImage(image, image, (int32_t)lround(op.x), (int32_t)lround(op.y)); break;
+			case BATCH_BLUR: ok = bmp.gaussianBlur(image, image, op.x); break;
+			case BATCH_BOX: ok = bmp.boxBlur(image, image, (uint32_t)op.x); break;
+			case BATCH_MEDIAN: ok = bmp.medianFilter(image, image, (uint32_t)op.x); break;
+			case BATCH_GRADIENT: ok = bmp.gradientImage(image, image, (GradientOperator)(int)op.x, (GradientOutput)op.mode); break;
+			default: break;
+		}
+		if(!ok) { message = std::string(operationName(op.type)) + " failed"; return false; }
+	}
+	return true;
+}
+
+bool BatchRunner::runGeometry(BitmapHandler &bmp, BitmapImage &image, size_t &index) {
+	std::vector<GeometryStep> steps;
+	Interpolation interp = INTERP_BILINEAR;
+
+	//Collecting the run of geometry operations, a nearest rotation selects nearest sampling.
+	for(; index < operations.size() && isGeometryOperation(operations[index].type); index++) {
+		const BatchOperation &op = operations[index];
+		GeometryStep step;
+		step.x = op.x;
+		step.y = op.y;
+		if(op.type == BATCH_ROTATE) {
+			step.op = GEOMETRY_ROTATE;
+			if(op.mode == INTERP_NEAREST) { interp = INTERP_NEAREST; }
+		} else if(op.type == BATCH_SCALE) {
+			step.op = GEOMETRY_SCALE;
+		} else {
+			step.op = GEOMETRY_TRANSLATE;
+			step.x = (double)lround(op.x);
+			step.y = (double)lround(op.y);
+		}
+		steps.push_back(step);
+	}
+	index--;
+
+	return bmp.transformImage(image, image, steps, interp);
+}
+
+bool BatchRunner::runPoint(BitmapHandler &bmp, BitmapImage &image, size_t &index) {
+	//Checking if the image is gray or not.
+	if(image.getBitsPerPixel() != BIT_GRAY_IMAGE) { return false; }
+
+	//Composing the run of point operations into one table. Equalization needs the
+	//histogram the image would have at that point, which is the source histogram
+	//moved through the table composed so far.
+	PointLut lut;
+	ImageStats stats;
+	bool counted = false;
+	for(; index < operations.size() && isPointOperation(operations[index].type); index++) {
+		const BatchOperation &op = operations[index];
+		if(op.type != BATCH_EQUALIZE) {
+			lut = lut.then(operationLut(op));
+			continue;
+		}
+
+		if(!counted) {
+			bmp.computeStats(image, stats);
+			counted = true;
+		}
+		uint64_t current[256] = { 0 };
+		for(uint32_t k = 0; k < 256; k++) { current[lut[(uint8_t)k]] += stats.histogram[0][k]; }
+		lut = lut.then(PointLut::equalize(current));
+	}
+	index--;
+
+	return lut.isIdentity() || bmp.applyLut(image, image, lut);
+}
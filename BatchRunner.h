@@ -0,0 +1,288 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.8
+ *          - 1.0.0 - Added batch processing of many files on a worker pool.
+ *          - 1.0.1 - Added fused geometry runs.
+ *          - 1.0.2 - Added composed point operations.
+ *          - 1.0.3 - Added neighbourhood filters.
+ *          - 1.0.4 - Added trace output.
+ *          - 1.0.5 - Added overlapped read, process and write stages.
+ *          - 1.0.6 - Added run length encoded outputs.
+ *          - 1.0.7 - Added image pyramid outputs.
+ *          - 1.0.8 - Added source regions.
+ *
+ * @desc Non-interactive batch processing of 'BMP' files, every file is run
+ *       through a list of operations by a pool of worker threads.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "BitmapHandler.h"
+
+static const uint32_t DEFAULT_PREFETCH_DEPTH = 4;				//Files read ahead of the workers
+static const size_t DEFAULT_IN_FLIGHT_LIMIT = 512u << 20;		//Bytes of source files held at once
+
+/*! Operations a batch can apply */
+enum BatchOpType {
+	BATCH_GRAY = 0,						/*! convert2Gray, parameter: luma weights */
+	BATCH_ROTATE,						/*! rotateImage, parameters: angle, interpolation */
+	BATCH_SCALE,						/*! scaleImage, parameters: x, y, filter */
+	BATCH_TRANSLATE,					/*! translatedImage, parameters: x, y */
+	BATCH_GAMMA,						/*! Point operation, parameter: exponent */
+	BATCH_BRIGHTNESS,					/*! Point operation, parameter: offset */
+	BATCH_CONTRAST,						/*! Point operation, parameter: gain */
+	BATCH_THRESHOLD,					/*! Point operation, parameter: level */
+	BATCH_INVERT,						/*! Point operation, no parameters */
+	BATCH_WINDOW,						/*! Point operation, parameters: low, high */
+	BATCH_EQUALIZE,						/*! Point operation, no parameters */
+	BATCH_BLUR,							/*! gaussianBlur, parameter: sigma */
+	BATCH_BOX,							/*! boxBlur, parameter: radius */
+	BATCH_MEDIAN,						/*! medianFilter, parameter: radius */
+	BATCH_GRADIENT						/*! gradientImage, parameter: operator, output */
+};
+
+/*! One operation of the batch with its parameters */
+struct BatchOperation {
+	BatchOpType type;
+	double x;							/*! Angle, x scale, x offset or point operation value */
+	double y;							/*! Y scale, y offset or window high */
+	int mode;							/*! Luma weights, interpolation, filter or gradient output */
+};
+
+/*! One file of the batch */
+struct BatchFile {
+	std::string input;
+	std::string output;
+};
+
+/*! Processed image waiting for the writer */
+struct PendingWrite {
+	uint32_t index;						/*! Index of the file */
+	size_t bytes;						/*! Bytes of the source file held for it */
+	uint64_t pixels;					/*! Number of source pixels processed */
+	BitmapImage image;
+	std::vector<BitmapImage> levels;	/*! Pyramid levels of the image */
+	std::chrono::steady_clock::time_point start;
+};
+
+class BatchRunner {
+
+	public:
+		/*!
+		 * @brief Constructor of the class initializing all the data variable(s).
+		 */
+		BatchRunner();
+
+		/*!
+		 * @brief Destructor
+		 */
+		virtual ~BatchRunner();
+
+		/*!
+		 * @brief Appends an operation given as "name[:params]", e.g. "gray:bt601",
+		 *        "rotate:30:nearest", "scale:0.5,0.5:lanczos3" or "translate:10,-5".
+		 * @param [string] - Operation specification.
+		 * @return [boolean] - Set if the specification is valid otherwise reset.
+		 */
+		bool addOperation(const char *spec);
+
+		/*!
+		 * @brief Writes the 1/2, 1/4, ... reductions of every output next to it as
+		 *        "name_2.bmp", "name_4.bmp" and so on, given as "levels[:box|gaussian]".
+		 *        Without operations the levels of the inputs are streamed out in one
+		 *        pass over each file and no other output is written.
+		 * @param [string] - Pyramid specification, e.g. "4" or "3:gaussian".
+		 * @return [boolean] - Set if the specification is valid otherwise reset.
+		 */
+		bool setPyramid(const char *spec);
+
+		/*!
+		 * @brief Limits every file to a window given as "x,y,width,height" from its
+		 *        top-left corner, only the rows of the window are read. Without
+		 *        operations the windows are written as they are.
+		 * @param [string] - Region specification, e.g. "1024,2048,512,512".
+		 * @return [boolean] - Set if the specification is valid otherwise reset.
+		 */
+		bool setRegion(const char *spec);
+
+		/*!
+		 * @brief Adds input files. A directory adds every '.bmp' file below it keeping
+		 *        the relative paths in the output directory, a name with '*' or '?'
+		 *        adds the matching files of its directory.
+		 * @param [string] - File, directory or wildcard pattern.
+		 * @return [boolean] - Set if at least one file is added otherwise reset.
+		 */
+		bool addInput(const char *path);
+
+		/*!
+		 * @brief Adds the inputs listed in a manifest, one file, directory or pattern
+		 *        per line. Empty lines and lines starting with '#' are skipped.
+		 * @param [string] - Manifest file name.
+		 * @return [boolean] - Set if the manifest is read successfully otherwise reset.
+		 */
+		bool addManifest(const char *fileName);
+
+		/*!
+		 * @brief Processes all files and prints the status of each file and the total
+		 *        throughput.
+		 * @param None
+		 * @return [boolean] - Set if every file is processed successfully otherwise reset.
+		 */
+		bool run(void);
+
+		//GETTERS
+
+		inline uint32_t getFileCount(void) const { return (uint32_t)files.size(); }
+		inline uint32_t getOperationCount(void) const { return (uint32_t)operations.size(); }
+		inline uint32_t getPyramidLevels(void) const { return pyramidCount; }
+		inline bool hasRegion(void) const { return region.width && region.height; }
+		inline uint32_t getFailedCount(void) const { return failedCount; }
+
+		//SETTERS
+
+		inline void setOutputDir(const char *dir) { outputDir = dir; }
+		inline void setWorkers(const uint32_t count) { workers = count; }
+		inline void setStripRows(const uint32_t rows) { stripRows = rows; }
+		inline void setVerbose(const bool enable) { verbose = enable; }
+		inline void setFuseGeometry(const bool enable) { fuseGeometry = enable; }
+		inline void setRunLengthOutput(const bool enable) { rleOutput = enable; }
+		inline void setTraceFile(const char *fileName) { traceFile = fileName; }
+		inline void setPrefetchDepth(const uint32_t depth) { prefetchDepth = depth; }
+		inline void setInFlightLimit(const size_t bytes) { inFlightLimit = bytes; }
+
+	private:
+		/*! Reports the result of one file: index, success, reason of a failure, milliseconds, pixels */
+		typedef std::function<void(size_t, bool, const std::string &, double, uint64_t)> ReportFunction;
+
+		/*!
+		 * @brief Processes all files in three overlapped stages: files are read ahead
+		 *        by a FilePrefetcher, processed in memory by the workers and written
+		 *        by one writer thread. Bytes of source files are held until their
+		 *        output is written, which bounds the memory in flight.
+		 * @param [int] - Number of workers.
+		 * @param [FILE] - Trace output, may be null.
+		 * @param [ReportFunction] - Called once per file.
+		 * @return None
+		 */
+		void runPipeline(const uint32_t threads, FILE *traceOutput, const ReportFunction &report);
+
+		/*!
+		 * @brief Returns the output file name of a file, creating its directory.
+		 * @param [BatchFile] - File of the batch.
+		 * @return [string] - Output file name.
+		 */
+		std::string outputName(const BatchFile &file) const;
+
+		/*!
+		 * @brief Returns the number of pixels of a file, or of its window.
+		 * @param [BitmapHandler] - Handler owned by the calling thread.
+		 * @param [string] - Source file.
+		 * @return [int] - Number of pixels processed.
+		 */
+		uint64_t sourcePixels(BitmapHandler &bmp, const uint8_t *fileName) const;
+
+		/*!
+		 * @brief Returns the file names of the pyramid levels of an output.
+		 * @param [string] - Output file name.
+		 * @return [string] - File names, the 1/2 level first.
+		 */
+		std::vector<std::string> levelNames(const std::string &output) const;
+
+		/*!
+		 * @brief Saves the pyramid levels of an output.
+		 * @param [BitmapHandler] - Handler owned by the calling thread.
+		 * @param [BitmapImage] - Levels, the 1/2 level first.
+		 * @param [string] - Output file name.
+		 * @return [boolean] - Set if every level is saved otherwise reset.
+		 */
+		bool saveLevels(BitmapHandler &bmp, const std::vector<BitmapImage> &levels, const std::string &output);
+
+		/*!
+		 * @brief Runs all operations on an in-memory image.
+		 * @param [BitmapHandler] - Handler owned by the calling worker.
+		 * @param [BitmapImage] - Image processed in place.
+		 * @param [string] - Reason of a failure.
+		 * @return [boolean] - Set if every operation succeeded otherwise reset.
+		 */
+		bool runOperations(BitmapHandler &bmp, BitmapImage &image, std::string &message);
+
+		/*!
+		 * @brief Runs all operations on one file.
+		 * @param [BitmapHandler] - Handler owned by the calling worker.
+		 * @param [BatchFile] - File to be processed.
+		 * @param [string] - Reason of a failure.
+		 * @param [int] - Number of source pixels processed.
+		 * @return [boolean] - Set if the file is processed successfully otherwise reset.
+		 */
+		bool processFile(BitmapHandler &bmp, const BatchFile &file, std::string &message, uint64_t &pixels);
+
+		/*!
+		 * @brief Runs consecutive rotate, scale and translate operations as one pass.
+		 * @param [BitmapHandler] - Handler owned by the calling worker.
+		 * @param [BitmapImage] - Image transformed in place.
+		 * @param [int] - Index of the first geometry operation, moved past the last one.
+		 * @return [boolean] - Set if the transformation is done successfully otherwise reset.
+		 */
+		bool runGeometry(BitmapHandler &bmp, BitmapImage &image, size_t &index);
+
+		/*!
+		 * @brief Runs consecutive point operations as one lookup table pass.
+		 * @param [BitmapHandler] - Handler owned by the calling worker.
+		 * @param [BitmapImage] - Image mapped in place.
+		 * @param [int] - Index of the first point operation, moved past the last one.
+		 * @return [boolean] - Set if the mapping is done successfully otherwise reset.
+		 */
+		bool runPoint(BitmapHandler &bmp, BitmapImage &image, size_t &index);
+
+		/*!
+		 * @brief Adds one file with its output name.
+		 * @param [string] - Input file.
+		 * @param [string] - Output file relative to the output directory.
+		 * @return None
+		 */
+		void addFile(const std::string &input, const std::string &relative);
+
+		std::vector<BatchOperation> operations;
+		std::vector<BatchFile> files;
+		std::string outputDir;
+		std::string traceFile;					/*! JSON lines file of the operation traces, empty for none */
+
+		uint32_t workers;
+		uint32_t stripRows;
+		uint32_t failedCount;
+		uint32_t prefetchDepth;					/*! Files read ahead, 0 to read in the workers */
+		size_t inFlightLimit;
+		bool verbose;
+		bool fuseGeometry;
+		bool rleOutput;							/*! RLE8 encode the gray outputs */
+		uint32_t pyramidCount;					/*! Pyramid levels written per output, 0 for none */
+		PyramidFilter pyramidFilter;
+		ImageRect region;						/*! Window of every file, empty for whole files */
+};
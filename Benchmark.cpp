@@ -0,0 +1,353 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ *
+ * Benchmark of every BitmapHandler operation on synthetic images.
+ *
+ * Usage: Benchmark [-o results.jsonl] [-d work_dir] [-m max_size] [-r min_seconds]
+ *                  [-t threads] [-s simd_level] [-l label]
+ *
+ * Square images from 64x64 up to 'max_size' (16384 by default) are generated at
+ * 8 and 24 bits per pixel. Every operation is timed in three stages: loading the
+ * source (mapping and faulting in the pixels), the kernel on the in-memory image
+ * and saving the result. Heap bytes of the kernel are counted separately from the
+ * bytes the buffer pool had to allocate fresh. One JSON object per operation and size is appended to
+ * the results file so runs of different versions can be compared.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <new>
+#include <string>
+
+#include "BitmapHandler.h"
+#include "CpuFeatures.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <Psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "Psapi.lib")
+#endif
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+static const uint32_t MIN_SIZE			= 64;
+static const uint32_t MAX_SIZE			= 16384;
+static const uint32_t MAX_REPEATS		= 50;
+static const size_t ALLOC_HEADER		= 16;		//Keeps the size of every block, preserves alignment
+
+/*! Heap traffic counted by the replaced global allocation functions */
+static atomic<uint64_t> allocBytes(0);
+static atomic<uint64_t> allocCount(0);
+static atomic<int64_t> liveBytes(0);
+static atomic<int64_t> peakLiveBytes(0);
+
+void *operator new(size_t size) {
+	uint8_t *block = (uint8_t *)malloc(size + ALLOC_HEADER);
+	if(block == 0) { throw bad_alloc(); }
+	*(size_t *)block = size;
+
+	allocBytes += size;
+	allocCount++;
+	int64_t live = (liveBytes += (int64_t)size);
+	int64_t peak = peakLiveBytes.load();
+	while(live > peak && !peakLiveBytes.compare_exchange_weak(peak, live)) {}
+
+	return block + ALLOC_HEADER;
+}
+
+void operator delete(void *ptr) noexcept {
+	if(ptr == 0) { return; }
+	uint8_t *block = (uint8_t *)ptr - ALLOC_HEADER;
+	liveBytes -= (int64_t)*(size_t *)block;
+	free(block);
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete[](void *ptr) noexcept { operator delete(ptr); }
+void operator delete(void *ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { operator delete(ptr); }
+
+/*! Options of a benchmark run */
+struct BenchOptions {
+	string output;
+	string workDir;
+	string label;
+	uint32_t maxSize;
+	double minSeconds;
+	uint32_t threads;
+	int simdLevel;
+};
+
+/*! Measurements of one operation on one image */
+struct BenchResult {
+	string op;
+	uint32_t width;
+	uint32_t height;
+	uint16_t bpp;
+	bool supported;
+	uint32_t repeats;
+	double loadMs;
+	double kernelMs;
+	double kernelMinMs;
+	double saveMs;
+	double mpixPerSec;
+	uint64_t allocBytes;
+	uint64_t allocCount;
+	uint64_t poolBytes;
+	uint64_t peakLiveBytes;
+	uint64_t peakRssKb;
+};
+
+typedef function<bool(BitmapHandler &, const BitmapImage &, BitmapImage &)> BenchKernel;
+
+bool parseOptions(int argc, char **argv, BenchOptions &options);
+bool generateImage(const string &fileName, const uint32_t size, const uint16_t bpp);
+BenchResult runBenchmark(const BenchOptions &options, const string &op, const string &srcFile, const BenchKernel &kernel);
+void writeResult(FILE *file, const BenchOptions &options, const BenchResult &result);
+uint64_t getPeakRssKb(void);
+
+inline double elapsedMs(const chrono::steady_clock::time_point &start) {
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+	BenchOptions options;
+	if(!parseOptions(argc, argv, options)) {
+		cout << "Usage: Benchmark [-o results.jsonl] [-d work_dir] [-m max_size] [-r min_seconds]"
+			" [-t threads] [-s simd_level] [-l label]" << endl;
+		return EXIT_FAILURE;
+	}
+
+	BitmapHandler::setThreadCount(options.threads);
+	if(options.simdLevel >= 0) { setSimdLevelLimit((SimdLevel)options.simdLevel); }
+
+	FILE *results = fopen(options.output.c_str(), "a");
+	if(results == 0) {
+		cout << "Unable to open " << options.output << endl;
+		return EXIT_FAILURE;
+	}
+
+	//Operations under test, gray conversion only applies to color sources.
+	struct { const char *op; bool colorOnly; BenchKernel kernel; } operations[] = {
+		{ "convert2Gray", true, [](BitmapHandler &h, const BitmapImage &s, BitmapImage &d) { return h.convert2Gray(s, d); } },
+		{ "rotateImage", false, [](BitmapHandler &h, const BitmapImage &s, BitmapImage &d) { return h.rotateImage(s, d, 30.0); } },
+		{ "rotateImage_90", false, [](BitmapHandler &h, const BitmapImage &s, BitmapImage &d) { return h.rotateImage(s, d, 90.0); } },
+		{ "rotateImage_180", false, [](BitmapHandler &h, const BitmapImage &s, BitmapImage &d) { return h.rotateImage(s, d, 180.0); } },
+		{ "scaleImage_down", false, [](BitmapHandler &h, const BitmapImage &s, BitmapImage &d) { return h.scaleImage(s, d, 0.5, 0.5); } },
+		{ "scaleImage_up", false, [](BitmapHandler &h, const BitmapImage &s, BitmapImage &d) { return h.scaleImage(s, d, 1.5, 1.5); } },
+		{ "buildPyramid", false, [](BitmapHandler &h, const BitmapImage &s, BitmapImage &d) {
+			vector<BitmapImage> levels; if(!h.buildPyramid(s, levels, 4)) { return false; } d = move(levels[0]); return true; } },
+		{ "translatedImage", false, [](BitmapHandler &h, const BitmapImage &s, BitmapImage &d) { return h.translatedImage(s, d, 37, -23); } },
+		{ "applyLut", false, [](BitmapHandler &h, const BitmapImage &s, BitmapImage &d) {
+			return h.applyLut(s, d, PointLut::gamma(0.8).then(PointLut::contrast(1.2))); } },
+		{ "equalizeImage", false, [](BitmapHandler &h, const BitmapImage &s, BitmapImage &d) { return h.equalizeImage(s, d); } },
+		{ "computeStats", false, [](BitmapHandler &h, const BitmapImage &s, BitmapImage &d) {
+			ImageStats stats; (void)d; return h.computeStats(s, stats); } },
+		{ "convert2Gray_stats", true, [](BitmapHandler &h, const BitmapImage &s, BitmapImage &d) {
+			ImageStats stats; return h.convert2Gray(s, d, LUMA_AVERAGE, &stats); } },
+		{ "gaussianBlur", false, [](BitmapHandler &h, const BitmapImage &s, BitmapImage &d) { return h.gaussianBlur(s, d, 2.0); } },
+		{ "boxBlur", false, [](BitmapHandler &h, const BitmapImage &s, BitmapImage &d) { return h.boxBlur(s, d, 7); } },
+		{ "medianFilter", false, [](BitmapHandler &h, const BitmapImage &s, BitmapImage &d) { return h.medianFilter(s, d, 1); } },
+		{ "gradientImage", false, [](BitmapHandler &h, const BitmapImage &s, BitmapImage &d) { return h.gradientImage(s, d); } }
+	};
+
+	printf("%-16s %6s %6s %4s %10s %10s %10s %10s %12s %10s\n",
+		"operation", "width", "height", "bpp", "load ms", "kernel ms", "save ms", "MP/s", "alloc MB", "rss MB");
+
+	for(uint32_t size = MIN_SIZE; size <= options.maxSize; size *= 2) {
+		for(uint16_t bpp : { BIT_GRAY_IMAGE, BIT_COLOR_IMAGE }) {
+			string srcFile = options.workDir + "/bench_" + to_string(size) + "_" + to_string(bpp) + ".bmp";
+			if(!generateImage(srcFile, size, bpp)) {
+				cout << "Unable to generate " << srcFile << endl;
+				fclose(results);
+				return EXIT_FAILURE;
+			}
+
+			for(auto &operation : operations) {
+				if(operation.colorOnly && bpp != BIT_COLOR_IMAGE) { continue; }
+
+				BenchResult result = runBenchmark(options, operation.op, srcFile, operation.kernel);
+				writeResult(results, options, result);
+
+				if(result.supported) {
+					printf("%-16s %6u %6u %4u %10.2f %10.2f %10.2f %10.1f %12.1f %10.1f\n",
+						result.op.c_str(), result.width, result.height, result.bpp, result.loadMs, result.kernelMs,
+						result.saveMs, result.mpixPerSec, (result.allocBytes + result.poolBytes) / 1048576.0, result.peakRssKb / 1024.0);
+				} else {
+					printf("%-16s %6u %6u %4u %10s\n", result.op.c_str(), result.width, result.height, result.bpp, "unsupported");
+				}
+				fflush(stdout);
+			}
+
+			remove(srcFile.c_str());
+		}
+	}
+
+	remove((options.workDir + "/bench_out.bmp").c_str());
+	fclose(results);
+	return EXIT_SUCCESS;
+}
+
+bool parseOptions(int argc, char **argv, BenchOptions &options) {
+	options.output = "benchmark.jsonl";
+	options.workDir = ".";
+	options.label = "";
+	options.maxSize = MAX_SIZE;
+	options.minSeconds = 0.5;
+	options.threads = 0;
+	options.simdLevel = -1;
+
+	for(int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if(i + 1 >= argc) { return false; }
+		string value = argv[++i];
+
+		if(arg == "-o") { options.output = value; }
+		else if(arg == "-d") { options.workDir = value; }
+		else if(arg == "-l") { options.label = value; }
+		else if(arg == "-m") { options.maxSize = (uint32_t)atoi(value.c_str()); }
+		else if(arg == "-r") { options.minSeconds = atof(value.c_str()); }
+		else if(arg == "-t") { options.threads = (uint32_t)atoi(value.c_str()); }
+		else if(arg == "-s") { options.simdLevel = atoi(value.c_str()); }
+		else { return false; }
+	}
+	return options.maxSize >= MIN_SIZE;
+}
+
+bool generateImage(const string &fileName, const uint32_t size, const uint16_t bpp) {
+	BitmapImage image(size, size, bpp);
+	if(image.isEmpty()) { return false; }
+
+	//Smooth gradients with a little noise, so neither the kernels nor the disk see constant data.
+	uint32_t rowBytes = size * (bpp / 8);
+	uint32_t seed = 0x9E3779B9u;
+	for(uint32_t y = 0; y < size; y++) {
+		uint8_t *row = image.getRow(y);
+		for(uint32_t x = 0; x < rowBytes; x++) {
+			seed ^= seed << 13;
+			seed ^= seed >> 17;
+			seed ^= seed << 5;
+			row[x] = (uint8_t)(((x * 255) / rowBytes + (y * 255) / size) / 2 + (seed & 15));
+		}
+	}
+	image.setHorPixPerMeter(2835);
+	image.setVerPixPerMeter(2835);
+	if(bpp == BIT_GRAY_IMAGE) { image.createGrayPalette(); }
+
+	BitmapHandler bmp;
+	return bmp.saveImage((const uint8_t *)fileName.c_str(), image);
+}
+
+BenchResult runBenchmark(const BenchOptions &options, const string &op, const string &srcFile, const BenchKernel &kernel) {
+	BenchResult result;
+	result.op = op;
+	result.width = result.height = 0;
+	result.bpp = 0;
+	result.supported = true;
+	result.repeats = 0;
+	result.loadMs = result.kernelMs = result.kernelMinMs = result.saveMs = result.mpixPerSec = 0.0;
+	result.allocBytes = result.allocCount = result.poolBytes = result.peakLiveBytes = 0;
+
+	string dstFile = options.workDir + "/bench_out.bmp";
+	vector<double> loadTimes, kernelTimes, saveTimes;
+	double total = 0.0;
+
+	while(result.repeats < MAX_REPEATS && (result.repeats == 0 || total < options.minSeconds * 1000.0)) {
+		BitmapHandler bmp;
+		BitmapImage src, dst;
+
+		//Loading, pixels are faulted in here so page faults are not charged to the kernel.
+		auto start = chrono::steady_clock::now();
+		if(!bmp.loadImage((const uint8_t *)srcFile.c_str(), src)) { result.supported = false; break; }
+		const uint8_t *data = src.getData();
+		volatile uint8_t sink = 0;
+		for(size_t i = 0; i < src.getDataSize(); i += 4096) { sink = sink + data[i]; }
+		loadTimes.push_back(elapsedMs(start));
+
+		result.width = src.getWidth();
+		result.height = src.getHeight();
+		result.bpp = src.getBitsPerPixel();
+
+		//Kernel, heap traffic is counted from here on.
+		uint64_t bytesBefore = allocBytes.load();
+		uint64_t countBefore = allocCount.load();
+		int64_t liveBefore = liveBytes.load();
+		uint64_t poolBefore = BufferPool::getShared().getAllocatedBytes();
+		peakLiveBytes = liveBefore;
+
+		start = chrono::steady_clock::now();
+		if(!kernel(bmp, src, dst)) { result.supported = false; break; }
+		kernelTimes.push_back(elapsedMs(start));
+
+		result.allocBytes = allocBytes.load() - bytesBefore;
+		result.allocCount = allocCount.load() - countBefore;
+		result.poolBytes = BufferPool::getShared().getAllocatedBytes() - poolBefore;
+		result.peakLiveBytes = (uint64_t)(peakLiveBytes.load() - liveBefore);
+
+		//Saving the result.
+		start = chrono::steady_clock::now();
+		if(!bmp.saveImage((const uint8_t *)dstFile.c_str(), dst)) { result.supported = false; break; }
+		saveTimes.push_back(elapsedMs(start));
+
+		total += loadTimes.back() + kernelTimes.back() + saveTimes.back();
+		result.repeats++;
+	}
+
+	//Medians are robust against the odd slow repetition.
+	auto median = [](vector<double> &v) {
+		if(v.empty()) { return 0.0; }
+		sort(v.begin(), v.end());
+		return v[v.size() / 2];
+	};
+
+	if(result.supported && result.repeats > 0) {
+		result.kernelMinMs = *min_element(kernelTimes.begin(), kernelTimes.end());
+		result.loadMs = median(loadTimes);
+		result.kernelMs = median(kernelTimes);
+		result.saveMs = median(saveTimes);
+		result.mpixPerSec = (result.kernelMs > 0.0) ? (double)result.width * result.height / (result.kernelMs * 1000.0) : 0.0;
+	}
+	result.peakRssKb = getPeakRssKb();
+	return result;
+}
+
+void writeResult(FILE *file, const BenchOptions &options, const BenchResult &result) {
+	fprintf(file, "{\"label\":\"%s\",\"op\":\"%s\",\"width\":%u,\"height\":%u,\"bpp\":%u,\"threads\":%u,\"simd\":%d,"
+		"\"supported\":%s,\"repeats\":%u,\"load_ms\":%.4f,\"kernel_ms\":%.4f,\"kernel_min_ms\":%.4f,\"save_ms\":%.4f,"
+		"\"mpix_per_s\":%.3f,\"alloc_bytes\":%llu,\"alloc_count\":%llu,\"pool_alloc_bytes\":%llu,\"peak_heap_bytes\":%llu,"
+		"\"peak_rss_kb\":%llu}\n",
+		options.label.c_str(), result.op.c_str(), result.width, result.height, result.bpp, BitmapHandler::getThreadCount(),
+		(int)getSimdLevel(), result.supported ? "true" : "false", result.repeats, result.loadMs, result.kernelMs,
+		result.kernelMinMs, result.saveMs, result.mpixPerSec, (unsigned long long)result.allocBytes,
+		(unsigned long long)result.allocCount, (unsigned long long)result.poolBytes, (unsigned long long)result.peakLiveBytes,
+		(unsigned long long)result.peakRssKb);
+	fflush(file);
+}
+
+uint64_t getPeakRssKb(void) {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) { return 0; }
+	return counters.PeakWorkingSetSize / 1024;
+#else
+	struct rusage usage;
+	if(getrusage(RUSAGE_SELF, &usage) != 0) { return 0; }
+#ifdef __APPLE__
+	return (uint64_t)usage.ru_maxrss / 1024;
+#else
+	return (uint64_t)usage.ru_maxrss;
+#endif
+#endif
+}
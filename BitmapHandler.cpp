@@ -1,7 +1,7 @@
 /*!
  * @author Syed Asad Amin
  * @date Nov 02nd, 2019
- * @version 1.0.6
+ * @version 1.2.12
  *          - 1.0.0 - Added file reading feature along with data extraction
  *          - 1.0.1 - Corrected data skip problem during file read.
  *          - 1.0.2 - Added data structure support.
@@ -9,6 +9,32 @@
  *			- 1.0.4 - Added gray scale translation support.
  *			- 1.0.5 - Added gray scale scaling support.
  *			- 1.0.6 - Added gray scale rotation support.
+ *			- 1.0.7 - Added in-memory image support for chaining operations.
+ *			- 1.0.8 - Added memory mapped zero-copy image loading.
+ *			- 1.0.9 - Added atomic single gather write of output images.
+ *			- 1.1.0 - Added SIMD gray scale kernels with selectable luma weights.
+ *			- 1.1.1 - Added row parallel execution on a shared thread pool.
+ *			- 1.1.2 - Added inverse mapping rotation with bilinear interpolation.
+ *			- 1.1.3 - Added separable resampling for scaling.
+ *			- 1.1.4 - Added in-place translation with signed offsets.
+ *			- 1.1.5 - Added strip streaming of file operations with bounded memory.
+ *			- 1.1.6 - Added cached header info.
+ *			- 1.1.7 - Added pooled aligned buffers without full clearing.
+ *			- 1.1.8 - Added fused single pass geometry pipeline.
+ *			- 1.1.9 - Added lookup table point operations.
+ *			- 1.2.0 - Added parallel image statistics.
+ *			- 1.2.1 - Added SIMD neighbourhood filters.
+ *			- 1.2.2 - Added pixel formats driven by the real header.
+ *			- 1.2.3 - Added per stage operation tracing.
+ *			- 1.2.4 - Added loading from file contents in memory.
+ *			- 1.2.5 - Added lossless right angle rotations.
+ *			- 1.2.6 - Added RLE8/RLE4 reading and RLE8 writing.
+ *			- 1.2.7 - Added single pass image pyramids.
+ *			- 1.2.8 - Added regions of interest.
+ *			- 1.2.9 - Added 24 bit color rotation, scaling and translation.
+ *			- 1.2.10 - Streamed warps sample at the positions of in-memory warps.
+ *			- 1.2.11 - Added 32 bit BGRA rotation, scaling and translation.
+ *			- 1.2.12 - Expanded color palette images to BGR24 before interpolating them.
  *
  * @desc This library is used to extract and manipulate the 'BMP' file data.
  *
@@ -33,389 +59,1527 @@
 
 #include "BitmapHandler.h"
 
+/*!
+ * @brief Writes one output row of a translation with one bulk move.
+ * @param [string] - Source row shown by the output row, null if it shows none.
+ * @param [string] - Output row, may overlap the source row.
+ * @param [int] - Row width in bytes.
+ * @param [int] - Bytes to translate along x axis.
+ * @param [int] - Value of the exposed border bytes.
+ * @return None
+ */
+static void translateRow(const uint8_t *srcRow, uint8_t *dstRow, const int64_t width, const int32_t X, const uint8_t fill) {
+	//Columns kept by the row and where they come from / go to.
+	int64_t keep = width - (X < 0 ? -(int64_t)X : (int64_t)X);
+	if(keep < 0) { keep = 0; }
+	int64_t srcCol = (X < 0) ? -(int64_t)X : 0;
+	int64_t dstCol = (X > 0) ? (int64_t)X : 0;
+
+	if(srcRow == 0 || keep == 0) {
+		memset(dstRow, fill, (size_t)width);
+		return;
+	}
+	memmove(dstRow + dstCol, srcRow + srcCol, (size_t)keep);
+	if(X > 0) { memset(dstRow, fill, (size_t)dstCol); }
+	if(X < 0) { memset(dstRow + keep, fill, (size_t)srcCol); }
+}
+
+/*! Gray plane kernel run by runPlanes(): src, srcStride, dst, dstStride */
+typedef std::function<void(const uint8_t *, uint32_t, uint8_t *, uint32_t)> PlaneKernel;
+
+/*!
+ * @brief Runs a gray plane kernel on gray, BGR24 or BGRA32 pixels. Color pixels
+ *        are split once into pooled B, G, R (and alpha) planes, every plane runs
+ *        through the kernel and the results are merged once into the destination.
+ *        Used by the separable resampler, whose passes gain nothing from
+ *        interleaved pixels. BGR24 rows use the SIMD shuffles, BGRA32 rows are
+ *        split byte by byte.
+ * @param [string] - Source pixels.
+ * @param [int] - Source width.
+ * @param [int] - Source height.
+ * @param [int] - Source row stride in bytes.
+ * @param [string] - Destination pixels.
+ * @param [int] - Destination width.
+ * @param [int] - Destination height.
+ * @param [int] - Destination row stride in bytes.
+ * @param [int] - Bytes per pixel, 1, 3 or 4.
+ * @param [PlaneKernel] - Kernel writing one destination plane from one source plane.
+ * @return None
+ */
+static void runPlanes(const uint8_t *src, const uint32_t srcWidth, const uint32_t srcHeight, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstWidth, const uint32_t dstHeight, const uint32_t dstStride,
+	const uint32_t pixelBytes, const PlaneKernel &kernel) {
+	if(pixelBytes == 1) {
+		kernel(src, srcStride, dst, dstStride);
+		return;
+	}
+
+	size_t srcPlane = (size_t)srcWidth * srcHeight;
+	size_t dstPlane = (size_t)dstWidth * dstHeight;
+	PixelBuffer inPlanes = BufferPool::getShared().acquire(pixelBytes * srcPlane);
+	PixelBuffer outPlanes = BufferPool::getShared().acquire(pixelBytes * dstPlane);
+	uint8_t *in = inPlanes.data();
+	uint8_t *out = outPlanes.data();
+
+	ThreadPool::getShared().parallelFor(0, srcHeight, MIN_BAND_ROWS, [&](uint32_t first, uint32_t last) {
+		for(uint32_t i = first; i < last; i++) {
+			size_t row = (size_t)i * srcWidth;
+			const uint8_t *p = src + (size_t)i * srcStride;
+			if(pixelBytes == 3) {
+				splitBgrRow(p, in + row, in + srcPlane + row, in + 2 * srcPlane + row, srcWidth);
+				continue;
+			}
+			for(uint32_t j = 0; j < srcWidth; j++, p += 4) {
+				for(uint32_t c = 0; c < 4; c++) { in[c * srcPlane + row + j] = p[c]; }
+			}
+		}
+	});
+
+	for(uint32_t c = 0; c < pixelBytes; c++) {
+		kernel(in + c * srcPlane, srcWidth, out + c * dstPlane, dstWidth);
+	}
+
+	ThreadPool::getShared().parallelFor(0, dstHeight, MIN_BAND_ROWS, [&](uint32_t first, uint32_t last) {
+		for(uint32_t i = first; i < last; i++) {
+			size_t row = (size_t)i * dstWidth;
+			uint8_t *p = dst + (size_t)i * dstStride;
+			if(pixelBytes == 3) {
+				mergeBgrRow(out + row, out + dstPlane + row, out + 2 * dstPlane + row, p, dstWidth);
+				continue;
+			}
+			for(uint32_t j = 0; j < dstWidth; j++, p += 4) {
+				for(uint32_t c = 0; c < 4; c++) { p[c] = out[c * dstPlane + row + j]; }
+			}
+		}
+	});
+}
+
+/*!
+ * @brief Checks for the whole byte pixels geometric operations and pyramids take.
+ * @param [int] - Bits per pixel.
+ * @return [boolean] - Set for 8 bit gray, 24 bit BGR and 32 bit BGRA otherwise reset.
+ */
+static inline bool isGeometryDepth(const uint16_t bpp) {
+	return bpp == BIT_GRAY_IMAGE || bpp == BIT_COLOR_IMAGE || bpp == BIT_ALPHA_IMAGE;
+}
+
+/*!
+ * @brief Checks if an indexed image has colors in its palette.
+ * @param [string] - BGRA palette entries, may be null.
+ * @param [int] - Size of the palette in bytes.
+ * @return [boolean] - Set if any entry is not a gray level otherwise reset.
+ */
+static bool isColorPalette(const uint8_t *palette, const uint32_t size) {
+	for(uint32_t i = 0; palette && i + 3 < size; i += 4) {
+		if(palette[i] != palette[i + 1] || palette[i] != palette[i + 2]) { return true; }
+	}
+	return false;
+}
+
+/*!
+ * @brief Creates the table mapping palette indices to the gray value of their color.
+ * @param [string] - Palette of PALETTE_SIZE bytes.
+ * @param [LumaWeights] - Weights of the color channels.
+ * @return [PointLut] - Index to gray table.
+ */
+static PointLut paletteGrayLut(const uint8_t *palette, const LumaWeights weights) {
+	uint8_t gray[256];
+	bgrToGrayRow(palette, gray, 256, 4, weights);
+
+	PointLut lut;
+	for(uint32_t k = 0; k < 256; k++) { lut.set((uint8_t)k, gray[k]); }
+	return lut;
+}
+
+/*!
+ * @brief Checks if an image holds indices of a color palette instead of gray levels.
+ * @param [BitmapImage] - Image to be checked.
+ * @return [boolean] - Set for 8 bit images with a color palette otherwise reset.
+ */
+static bool isIndexedColor(const BitmapImage &image) {
+	return image.getBitsPerPixel() == BIT_GRAY_IMAGE && isColorPalette(image.getPalette(), image.getPaletteSize());
+}
+
+/*!
+ * @brief Expands the indices of an image with a color palette into BGR24 pixels,
+ *        neighbouring indices may stand for unrelated colors and can not be blended.
+ * @param [BitmapImage] - Indexed source image.
+ * @param [BitmapImage] - Expanded image.
+ * @return None
+ */
+static void expandIndexedColor(const BitmapImage &src, BitmapImage &dst) {
+	dst.allocate(src.getWidth(), src.getHeight(), BIT_COLOR_IMAGE);
+	dst.setHorPixPerMeter(src.getHorPixPerMeter());
+	dst.setVerPixPerMeter(src.getVerPixPerMeter());
+
+	ThreadPool::getShared().parallelFor(0, src.getHeight(), MIN_BAND_ROWS, [&](uint32_t first, uint32_t last) {
+		expandPaletteRows(src.getRow(first), src.getStride(), dst.getRow(first), dst.getStride(),
+			src.getWidth(), last - first, src.getPalette());
+	});
+}
+
+/*!
+ * @brief Makes a streamed source with a color palette hand out BGR24 rows, readRows()
+ *        expands the indices through the palette.
+ * @param [StripSource] - Opened source.
+ * @return None
+ */
+static void expandIndexedColor(StripSource &source) {
+	if(source.bitsPerPixel != BIT_GRAY_IMAGE || !isColorPalette(source.palette.data(), (uint32_t)source.palette.size())) { return; }
+	source.colors.swap(source.palette);
+	source.bitsPerPixel = BIT_COLOR_IMAGE;
+	source.stride = BitmapImage::calcStride(source.width, BIT_COLOR_IMAGE);
+}
+
+/*! Traces one public call of the handler, calls it makes add to the outer trace */
+class TraceScope {
+
+	public:
+		inline TraceScope(BitmapHandler *handler, const char *operation, const uint8_t *fileName, const bool &result) :
+			handler(handler), result(result) {
+			outer = handler->beginTrace(operation, fileName);
+		}
+
+		inline ~TraceScope() {
+			if(outer) { handler->endTrace(result); }
+		}
+
+	private:
+		TraceScope(const TraceScope &);
+		TraceScope &operator=(const TraceScope &);
+
+		BitmapHandler *handler;
+		const bool &result;
+		bool outer;
+};
+
 BitmapHandler::BitmapHandler() {
 	imageFound = false;
+	stripRows = 0;
 	memset(palette, 0, sizeof(palette));
 	memset(&BMP_FH, 0, sizeof(BMP_FH));
 	memset(&BMP_IH, 0, sizeof(BMP_IH));
+	memset(&layout, 0, sizeof(layout));
+
+	rleOutput = false;
+	memset(&region, 0, sizeof(region));
+
+	tracing = false;
+	resetTrace(trace, "");
+	activeTrace = 0;
+	memset(&poolCounters, 0, sizeof(poolCounters));
+	traceOutput = 0;
 }
 
 BitmapHandler::~BitmapHandler() {
 
 }
 
+void BitmapHandler::setThreadCount(const uint32_t threads) {
+	ThreadPool::getShared().setThreadCount(threads);
+}
+
+uint32_t BitmapHandler::getThreadCount(void) {
+	return ThreadPool::getShared().getThreadCount();
+}
+
+void BitmapHandler::setBufferCacheLimit(const size_t bytes) {
+	BufferPool::getShared().setCacheLimit(bytes);
+}
+
 void BitmapHandler::getImageInfo(const uint8_t *fileName) {
 	try {
+		//Headers are cached by path, size and modification time.
 		uint8_t rawData[HEADER_SIZE];
-		readImage(fileName, 0, rawData, HEADER_SIZE);
-		extractInfo(rawData);
+		imageFound = false;
+		if(!MetadataCache::getShared().lookup((const char *)fileName, rawData)) { return; }
+		extractInfo(rawData, HEADER_SIZE);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+}
+
+bool BitmapHandler::gaussianBlur(const uint8_t *srcFile, const uint8_t *dstFile, const double sigma) {
+	if(sigma <= 0.0 || ceil(3.0 * sigma) > FILTER_MAX_RADIUS) { return false; }
+	uint32_t radius = (uint32_t)ceil(3.0 * sigma);
+	return filterFile("gaussianBlur", srcFile, dstFile, (radius < 1) ? 1 : radius,
+		[sigma](const uint8_t *src, uint32_t width, uint32_t height, uint32_t srcStride, uint8_t *dst, uint32_t dstStride) {
+			gaussianPlane(src, width, height, srcStride, dst, dstStride, sigma);
+		});
+}
+
+bool BitmapHandler::boxBlur(const uint8_t *srcFile, const uint8_t *dstFile, const uint32_t radius) {
+	return filterFile("boxBlur", srcFile, dstFile, radius,
+		[radius](const uint8_t *src, uint32_t width, uint32_t height, uint32_t srcStride, uint8_t *dst, uint32_t dstStride) {
+			boxPlane(src, width, height, srcStride, dst, dstStride, radius);
+		});
+}
+
+bool BitmapHandler::medianFilter(const uint8_t *srcFile, const uint8_t *dstFile, const uint32_t radius) {
+	return filterFile("medianFilter", srcFile, dstFile, radius,
+		[radius](const uint8_t *src, uint32_t width, uint32_t height, uint32_t srcStride, uint8_t *dst, uint32_t dstStride) {
+			medianPlane(src, width, height, srcStride, dst, dstStride, radius);
+		});
+}
+
+bool BitmapHandler::gradientImage(const uint8_t *srcFile, const uint8_t *dstFile, const GradientOperator op,
+	const GradientOutput output) {
+	return filterFile("gradientImage", srcFile, dstFile, 1,
+		[op, output](const uint8_t *src, uint32_t width, uint32_t height, uint32_t srcStride, uint8_t *dst, uint32_t dstStride) {
+			gradientPlane(src, width, height, srcStride, dst, dstStride, op, output);
+		});
+}
+
+bool BitmapHandler::convolveImage(const uint8_t *srcFile, const uint8_t *dstFile, const std::vector<float> &kernel, const int32_t bias) {
+	uint32_t size = (uint32_t)lround(sqrt((double)kernel.size()));
+	if(size * size != kernel.size() || (size & 1) == 0 || size > FILTER_MAX_SIZE) { return false; }
+	return filterFile("convolveImage", srcFile, dstFile, size / 2,
+		[&kernel, size, bias](const uint8_t *src, uint32_t width, uint32_t height, uint32_t srcStride, uint8_t *dst, uint32_t dstStride) {
+			convolvePlane(src, width, height, srcStride, dst, dstStride, kernel.data(), size, bias);
+		});
+}
+
+bool BitmapHandler::computeStats(const uint8_t *fileName, ImageStats &stats) {
+	bool result = false;
+	TraceScope scope(this, "computeStats", fileName, result);
+	try {
+		if(stripRows) { return result = statsStream(fileName, stats); }
+
+		BitmapImage image;
+		if(!loadImage(fileName, image)) { return false; }
+		result = computeStats(image, stats);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::buildPyramid(const uint8_t *srcFile, const std::vector<std::string> &dstFiles, const PyramidFilter filter) {
+	bool result = false;
+	TraceScope scope(this, "buildPyramid", srcFile, result);
+	try {
+		StripSource source;
+		if(!openStream(srcFile, source)) { return false; }
+
+		//Indices of a color palette can not be averaged.
+		if(isColorPalette(source.palette.data(), (uint32_t)source.palette.size())) { return false; }
+
+		//Chaining the levels, every level is fed the rows completed by the one above.
+		uint32_t count = pyramidLevels(source.width, source.height, (uint32_t)dstFiles.size());
+		std::vector<PyramidLevel> levels(count);
+		std::vector<std::unique_ptr<AtomicFileWriter>> writers(count);
+		uint32_t width = source.width, height = source.height;
+		for(uint32_t k = 0; k < count; k++) {
+			levels[k].reset(width, height, source.bitsPerPixel / 8, filter);
+			width = levels[k].getWidth();
+			height = levels[k].getHeight();
+
+			writers[k].reset(new AtomicFileWriter());
+			if(!beginStream((const uint8_t *)dstFiles[k].c_str(), *writers[k], source, width, height, source.bitsPerPixel)) {
+				return false;
+			}
+		}
+
+		//Reading the source once, strip by strip.
+		uint32_t rows = stripRows ? stripRows : PYRAMID_STRIP_ROWS;
+		if(rows > source.height) { rows = source.height; }
+		BitmapImage strip;
+		strip.allocate(source.width, rows, source.bitsPerPixel);
+
+		for(uint32_t first = 0; first < source.height && count; first += rows) {
+			uint32_t done = (source.height - first < rows) ? source.height - first : rows;
+			if(!readRows(source, first, done, strip.getData())) { return false; }
+
+			const uint8_t *data = strip.getData();
+			uint32_t stride = source.stride;
+			for(uint32_t k = 0; k < count && done; k++) {
+				done = levels[k].push(data, done, stride);
+				data = levels[k].getRows();
+				stride = levels[k].getStride();
+
+				IoBuffer buffer = { data, (size_t)done * stride };
+				if(done && !writeRows(*writers[k], &buffer, 1)) { return false; }
+			}
+		}
+
+		for(uint32_t k = 0; k < count; k++) {
+			if(!commitRows(*writers[k])) { return false; }
+		}
+		result = true;
 	} catch(std::exception &e) {
-		std::cout << e.what() << std::endl;
+		reportError(e.what());
 	}
+	return result;
 }
 
-bool BitmapHandler::convert2Gray(const uint8_t *srcFile, const uint8_t *dstFile) {
+bool BitmapHandler::loadImage(const uint8_t *fileName, BitmapImage &image) {
 	bool result = false;
+	TraceScope scope(this, "loadImage", fileName, result);
 	try {
-		//Reading the source image file for info.
-		getImageInfo(srcFile);
+		imageFound = false;
 
-		//Checking if the image is colored or not.
-		if(getBitsPerPixel() < BIT_COLOR_IMAGE) { return 0; }
+		//Mapping the whole file once, header and pixels are read from the mapping.
+		std::shared_ptr<MappedFile> mapped = std::make_shared<MappedFile>();
+		{
+			StageTimer timer(activeTrace, STAGE_HEADER);
+			if(!mapped->open((const char *)fileName)) {
+				reportError(std::string("Unable to open ") + (const char *)fileName);
+				return false;
+			}
+			if(activeTrace) { activeTrace->bytesRead += mapped->getSize(); }
+		}
+
+		result = decodeImage(mapped->getData(), mapped->getSize(), mapped, image);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::loadImage(const std::shared_ptr<const PixelBuffer> &file, BitmapImage &image) {
+	bool result = false;
+	TraceScope scope(this, "loadImage", 0, result);
+	try {
+		imageFound = false;
+		if(!file || file->empty()) { return false; }
 
-		//Calculating the row bytes with padding.
-		uint32_t rowBytesColor = (((getBitsPerPixel() * getImageWidth()) + 31) / 32) * 4;
-		uint32_t rowBytesGray = (((BIT_GRAY_IMAGE * getImageWidth()) + 31) / 32) * 4;
+		result = decodeImage(file->data(), file->size(), file, image);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
 
-		//Calculating image size.
-		uint32_t colorImageSize = rowBytesColor * getImageHeight();
-		uint32_t grayImageSize = rowBytesGray * getImageHeight();
+bool BitmapHandler::decodeImage(const uint8_t *data, const uint64_t size, const std::shared_ptr<const void> &owner,
+	BitmapImage &image) {
+	bool result = false;
+	try {
+		{
+			StageTimer timer(activeTrace, STAGE_HEADER);
+			if(size < HEADER_SIZE) { return false; }
 
-		//Creating heap memory according to calculated sizes.
-		uint8_t *buffColorData = new uint8_t[colorImageSize];
-		uint8_t *buffGrayData = new uint8_t[grayImageSize];
+			//Extracting and validating header info.
+			extractInfo(data, size);
+			if(!validateHeader(size)) { return false; }
+		}
 
-		//Resetting heap memory buffers.
-		memset(buffColorData, 0, colorImageSize);
-		memset(buffGrayData, 0, grayImageSize);
+		//Reading palette data for indexed images.
+		uint64_t paletteOffset;
+		uint32_t paletteSize;
+		std::vector<uint8_t> imagePalette, levels;
+		paletteLocation(paletteOffset, paletteSize);
+		if(paletteSize) { preparePalette(data + paletteOffset, paletteSize, imagePalette, levels); }
+
+		//Only the rows of the region are touched, the bottom one is the first stored.
+		ImageRect window = { 0, 0, getImageWidth(), getImageHeight() };
+		if(region.width && region.height) {
+			window = region;
+			if(!clipRect(window, getImageWidth(), getImageHeight())) { return false; }
+		}
+		uint32_t bottom = getImageHeight() - window.y - window.height;
+		bool whole = window.width == getImageWidth();
+		ImageRect columns = { window.x, 0, window.width, window.height };
+
+		const uint8_t *rows = data + getImageOffset();
+		uint32_t fileStride = BitmapImage::calcStride(getImageWidth(), getBitsPerPixel());
+		if(isRunLengthLayout(layout)) {
+			//Decoding the codes in file order, they can not be split between threads.
+			BitmapImage band;
+			band.allocate(getImageWidth(), window.height, layout.workingBits);
+			StageTimer timer(activeTrace, STAGE_READ);
+			RleDecoder decoder;
+			decoder.reset(layout.format, getImageWidth(), getImageHeight(), pixelDataSize(size),
+				levels.empty() ? 0 : levels.data());
+			decoder.decode(rows, bottom, window.height, band.getData(), band.getStride());
+			if(whole) { image = std::move(band); } else { band.crop(columns, image); }
+		} else if(isNativeLayout(layout)) {
+			//Exposing the pixel rows as a zero-copy view of the file contents, windows stride over the rows.
+			image.wrap(rows + (uint64_t)bottom * fileStride + (uint64_t)window.x * (getBitsPerPixel() / 8),
+				window.width, window.height, getBitsPerPixel(), owner, fileStride);
+		} else {
+			//Unpacking the rows of other layouts in row bands, top-down rows are walked backwards.
+			BitmapImage band;
+			band.allocate(getImageWidth(), window.height, layout.workingBits);
+			StageTimer timer(activeTrace, STAGE_READ);
+			int64_t step = layout.topDown ? -(int64_t)fileStride : (int64_t)fileStride;
+			ThreadPool::getShared().parallelFor(0, window.height, MIN_BAND_ROWS, [&](uint32_t first, uint32_t last) {
+				uint64_t fileRow = layout.topDown ? getImageHeight() - 1 - bottom - first : bottom + first;
+				unpackRows(layout, rows + fileRow * fileStride, step, band.getRow(first), band.getStride(),
+					getImageWidth(), last - first, levels.empty() ? 0 : levels.data());
+			});
+			if(whole) { image = std::move(band); } else { band.crop(columns, image); }
+		}
+		image.setHorPixPerMeter(getHorPixPerMeter());
+		image.setVerPixPerMeter(getVerPixPerMeter());
+		if(!imagePalette.empty()) { image.setPalette(imagePalette.data(), PALETTE_SIZE); }
 
-		//Reading colored image data.
-		readImage(srcFile, HEADER_SIZE, buffColorData, colorImageSize);
+		result = true;
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
 
-		//Changing header data according to new gray scale image data.
-		setFileSize(HEADER_SIZE + PALETTE_SIZE + grayImageSize);
-		setReserved1(getReserved1());
-		setReserved2(getReserved2());
-		setImageOffset(getImageOffset() + PALETTE_SIZE);
-		setInfoHeaderSize(getInfoHeaderSize());
-		setImageWidth(getImageWidth());
-		setImageHeight(getImageHeight());
-		setColorPlane(getColorPlane());
-		setBitsPerPixel(BIT_GRAY_IMAGE);
-		setCompressionType(getCompressionType());
-		setImageSize(grayImageSize);
-		setHorPixPerMeter(getHorPixPerMeter());
-		setVerPixPerMeter(getVerPixPerMeter());
-		setColorUsed(lround(pow(2, BIT_GRAY_IMAGE)));
-		setImpColorUsed(getImpColorUsed());
+bool BitmapHandler::saveImage(const uint8_t *fileName, const BitmapImage &image) {
+	bool result = false;
+	TraceScope scope(this, "saveImage", fileName, result);
+	try {
+		if(image.isEmpty()) { return false; }
+
+		//Encoding gray images if asked to, keeping them uncompressed when that is smaller.
+		PixelBuffer encoded;
+		size_t encodedSize = 0;
+		if(rleOutput && image.getBitsPerPixel() == BIT_GRAY_IMAGE) {
+			encoded = BufferPool::getShared().acquire(rleBound(image.getWidth(), image.getHeight()) + 2);
+			encodedSize = encodeRle8(image.getData(), image.getStride(), image.getWidth(), image.getHeight(), encoded.data());
+			encoded.data()[encodedSize++] = 0;
+			encoded.data()[encodedSize++] = 1;
+			if(encodedSize >= image.getDataSize()) { encodedSize = 0; }
+		}
 
-		//Creating header data.
+		//Creating header data according to the image.
 		uint8_t rawData[HEADER_SIZE];
-		rawData[0] = HEADER_B0;
-		rawData[1] = HEADER_B1;
-		memcpy(&rawData[FILE_INFO_ADD], &BMP_FH, sizeof(BMP_FH));
-		memcpy(&rawData[IMAGE_INFO_ADD], &BMP_IH, sizeof(BMP_IH));
-
-		//Writing header data.
-		writeImage(dstFile, rawData, HEADER_SIZE);
-
-		//Creating palette.
-		createPalette();
-
-		//Writing palette data.
-		writeImage(dstFile, palette, PALETTE_SIZE);
-
-		//Converting to gray scale.
-		for(uint32_t i = 0; i < getImageHeight(); i++) {
-			for(uint32_t j = 0; j < getImageWidth(); j++) {
-				uint16_t value = 0;
-				for(uint8_t k = 0; k < 3; k++) {
-					value += buffColorData[(i * rowBytesColor) + (j * 3) + k];
-				}
-				value /= 3;
-				buffGrayData[(i * rowBytesGray) + j] = value;
+		uint32_t paletteSize = createHeader(rawData, image.getWidth(), image.getHeight(), image.getBitsPerPixel(),
+			image.getHorPixPerMeter(), image.getVerPixPerMeter(), encodedSize ? COMPRESSION_RLE8 : COMPRESSION_RGB,
+			(uint32_t)encodedSize);
+
+		//Creating palette data, keeping the image's own palette if it has one.
+		if(paletteSize) {
+			if(image.getPaletteSize() == PALETTE_SIZE) {
+				memcpy(palette, image.getPalette(), PALETTE_SIZE);
+			} else {
+				createPalette();
 			}
 		}
-		
-		//Writing gray image data.
-		writeImage(dstFile, buffGrayData, grayImageSize);
 
-		//Deleting heap memory
-		delete[] buffGrayData;	//RULE: Always delete what you new.
-		buffGrayData = 0;		//		Always free what you malloc.
-		
-		delete[] buffColorData;
-		buffColorData = 0;
+		//Windows of wider rows are copied into rows of their own size, which mutable access does.
+		BitmapImage packed;
+		if(!encodedSize && !image.isPacked()) { packed = image; }
+		const uint8_t *pixels = packed.isEmpty() ? image.getData() : packed.getData();
+
+		//Writing header, palette and image data in one go.
+		IoBuffer buffers[3] = {
+			{ rawData, HEADER_SIZE },
+			{ palette, paletteSize },
+			{ encodedSize ? encoded.data() : pixels, encodedSize ? encodedSize : image.getDataSize() }
+		};
+		if(!writeImage(fileName, buffers, 3)) { return false; }
 
+		imageFound = true;
 		result = true;
 	} catch(std::exception &e) {
-		std::cout << e.what() << std::endl;
+		reportError(e.what());
 	}
+	return result;
+}
 
+bool BitmapHandler::convert2Gray(const uint8_t *srcFile, const uint8_t *dstFile, const LumaWeights weights, ImageStats *stats) {
+	bool result = false;
+	TraceScope scope(this, "convert2Gray", srcFile, result);
+	try {
+		if(stripRows) { return result = convert2GrayStream(srcFile, dstFile, weights, stats); }
+
+		BitmapImage image;
+		if(!loadImage(srcFile, image)) { return false; }
+		if(!convert2Gray(image, image, weights, stats)) { return false; }
+		result = saveImage(dstFile, image);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
 	return result;
 }
 
-bool BitmapHandler::rotateImage(const uint8_t *srcFile, const uint8_t *dstFile, double angle) {
+bool BitmapHandler::rotateImage(const uint8_t *srcFile, const uint8_t *dstFile, double angle, const Interpolation interp) {
 	bool result = false;
+	TraceScope scope(this, "rotateImage", srcFile, result);
+	try {
+		if(stripRows) { return result = rotateStream(srcFile, dstFile, angle, interp); }
 
+		BitmapImage image;
+		if(!loadImage(srcFile, image)) { return false; }
+		if(!rotateImage(image, image, angle, interp)) { return false; }
+		result = saveImage(dstFile, image);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::scaleImage(const uint8_t *srcFile, const uint8_t *dstFile, double X, double Y, const ResampleFilter filter) {
+	bool result = false;
+	TraceScope scope(this, "scaleImage", srcFile, result);
 	try {
-		//Reading the source image file for info.
-		getImageInfo(srcFile);
+		if(stripRows) { return result = scaleStream(srcFile, dstFile, X, Y, filter); }
 
-		//Checking if the image is gray or not.
-		if(getBitsPerPixel() != BIT_GRAY_IMAGE) { return false; }
-
-		//Calculating data sizes.
-		while(angle >= 360.0) { angle -= 360.0; }									//Failsafe operations
-		while(angle < 0.0) { angle += 360; }
-
-		double cosA = cos(toRadians(angle));
-		double sinA = sin(toRadians(angle));
-
-		uint32_t gImageWidth = getImageWidth();
-		uint32_t gimageHeight = getImageHeight();
-
-		uint32_t rImageWidth = lround((gimageHeight * sinA) + (gImageWidth * cosA));
-		uint32_t rImageHeight = lround((gimageHeight * cosA) + (gImageWidth * sinA));
-
-		uint32_t rowGrayData = (((BIT_GRAY_IMAGE * gImageWidth) + 31) / 32) * 4;
-		uint32_t rowRotData = (((BIT_GRAY_IMAGE * rImageWidth) + 31) / 32) * 4;
-
-		uint32_t gImageSize = getImageSize();
-		uint32_t rImageSize = rowRotData * rImageHeight;
-
-		//Creating heap memory for gray image data.
-		uint8_t *buffGrayData = new uint8_t[gImageSize];
-		uint8_t *buffRotData = new uint8_t[rImageSize];
-
-		//Resetting the created heap memory.
-		memset(buffGrayData, 0, gImageSize);
-		memset(buffRotData, 0, rImageSize);
-
-		//Reading gray image data.
-		readImage(srcFile, HEADER_SIZE + PALETTE_SIZE, buffGrayData, getImageSize());
-
-		//Changing header data according to new rotated image.
-		setFileSize(HEADER_SIZE + PALETTE_SIZE + rImageSize);
-		setReserved1(0);
-		setReserved2(0);
-		setImageOffset(getImageOffset());
-		setInfoHeaderSize(getInfoHeaderSize());
-		setImageWidth(rImageWidth);
-		setImageHeight(rImageHeight);
-		setColorPlane(1);
-		setBitsPerPixel(getBitsPerPixel());
-		setCompressionType(0);
-		setImageSize(rImageSize);
-		setHorPixPerMeter(getHorPixPerMeter());
-		setVerPixPerMeter(getVerPixPerMeter());
-		setColorUsed(getColorUsed());
-		setImpColorUsed(getImpColorUsed());
+		BitmapImage image;
+		if(!loadImage(srcFile, image)) { return false; }
+		if(!scaleImage(image, image, X, Y, filter)) { return false; }
+		result = saveImage(dstFile, image);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
 
-		uint8_t rawData[HEADER_SIZE];
-		rawData[0] = HEADER_B0;
-		rawData[1] = HEADER_B1;
-		memcpy(&rawData[FILE_INFO_ADD], &BMP_FH, sizeof(BMP_FH));
-		memcpy(&rawData[IMAGE_INFO_ADD], &BMP_IH, sizeof(BMP_IH));
-
-		//Writing header data.
-		writeImage(dstFile, rawData, HEADER_SIZE);
-
-		//Creating palette.
-		createPalette();
-
-		//Writing palette data.
-		writeImage(dstFile, palette, PALETTE_SIZE);
-
-		//Rotating the image.
-		//x' = x * cos(a) + y * sin(a)
-		//y' = y * cos(a) - x * sin(a)
-		for(uint32_t i = 0; i < gimageHeight; i++) {
-			for(uint32_t j = 0; j < gImageWidth; j++) {
-				uint32_t xo = lround(i * cosA + j * sinA);
-				uint32_t yo = lround(j * cosA - i * sinA);
-				buffRotData[(xo * rowRotData) + yo] = buffGrayData[(i * rowGrayData) + j];
+bool BitmapHandler::translatedImage(const uint8_t *srcFile, const uint8_t *dstFile, const int32_t X, const int32_t Y, const uint8_t fill) {
+	bool result = false;
+	TraceScope scope(this, "translatedImage", srcFile, result);
+	try {
+		if(stripRows) { return result = translateStream(srcFile, dstFile, X, Y, fill); }
+
+		BitmapImage image;
+		if(!loadImage(srcFile, image)) { return false; }
+		if(!translatedImage(image, image, X, Y, fill)) { return false; }
+		result = saveImage(dstFile, image);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::transformImage(const uint8_t *srcFile, const uint8_t *dstFile, const std::vector<GeometryStep> &steps,
+	const Interpolation interp, const uint8_t fill) {
+	bool result = false;
+	TraceScope scope(this, "transformImage", srcFile, result);
+	try {
+		if(stripRows) { return result = transformStream(srcFile, dstFile, steps, interp, fill); }
+
+		BitmapImage image;
+		if(!loadImage(srcFile, image)) { return false; }
+		if(!transformImage(image, image, steps, interp, fill)) { return false; }
+		result = saveImage(dstFile, image);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::applyLut(const uint8_t *srcFile, const uint8_t *dstFile, const PointLut &lut) {
+	bool result = false;
+	TraceScope scope(this, "applyLut", srcFile, result);
+	try {
+		if(stripRows) { return result = lutStream(srcFile, dstFile, lut); }
+
+		BitmapImage image;
+		if(!loadImage(srcFile, image)) { return false; }
+		if(!applyLut(image, image, lut)) { return false; }
+		result = saveImage(dstFile, image);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::equalizeImage(const uint8_t *srcFile, const uint8_t *dstFile) {
+	bool result = false;
+	TraceScope scope(this, "equalizeImage", srcFile, result);
+	try {
+		if(stripRows) { return result = equalizeStream(srcFile, dstFile); }
+
+		BitmapImage image;
+		if(!loadImage(srcFile, image)) { return false; }
+		if(!equalizeImage(image, image)) { return false; }
+		result = saveImage(dstFile, image);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::convert2Gray(const BitmapImage &src, BitmapImage &dst, const LumaWeights weights, ImageStats *stats) {
+	bool result = false;
+	TraceScope scope(this, "convert2Gray", 0, result);
+	try {
+		//Checking if the image is colored or not, indexed images go through their palette.
+		bool indexed = src.getBitsPerPixel() == BIT_GRAY_IMAGE && isColorPalette(src.getPalette(), src.getPaletteSize());
+		if(src.getBitsPerPixel() < BIT_COLOR_IMAGE && !indexed) { return false; }
+		PointLut lut = indexed ? paletteGrayLut(src.getPalette(), weights) : PointLut();
+
+		//Creating gray image buffer, 'dst' may alias 'src'.
+		BitmapImage gray;
+		gray.allocate(src.getWidth(), src.getHeight(), BIT_GRAY_IMAGE);
+		gray.setHorPixPerMeter(src.getHorPixPerMeter());
+		gray.setVerPixPerMeter(src.getVerPixPerMeter());
+		gray.createGrayPalette();
+
+		uint32_t bytesPerPixel = src.getBitsPerPixel() / 8;
+		if(stats) { resetStats(*stats, 1); }
+		std::mutex mergeMutex;
+
+		//Converting to gray scale in row bands, row kernel is dispatched to the best SIMD level.
+		//Requested statistics are counted per band right after each row is converted.
+		ThreadPool::getShared().parallelFor(0, src.getHeight(), MIN_BAND_ROWS, [&](uint32_t first, uint32_t last) {
+			ImageStats band;
+			if(stats) { resetStats(band, 1); }
+			for(uint32_t i = first; i < last; i++) {
+				if(indexed) { applyLutRow(src.getRow(i), gray.getRow(i), src.getWidth(), lut); }
+				else { bgrToGrayRow(src.getRow(i), gray.getRow(i), src.getWidth(), bytesPerPixel, weights); }
+				if(stats) { countRows(gray.getRow(i), src.getWidth(), 1, gray.getStride(), 1, band); }
+			}
+			if(stats) {
+				std::lock_guard<std::mutex> lock(mergeMutex);
+				mergeStats(*stats, band);
 			}
+		});
+		if(stats) { finishStats(*stats); }
+
+		dst = std::move(gray);
+		result = true;
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::rotateImage(const BitmapImage &src, BitmapImage &dst, double angle, const Interpolation interp) {
+	bool result = false;
+	TraceScope scope(this, "rotateImage", 0, result);
+	try {
+		//Right angles move whole pixels, gray and color images are transposed losslessly.
+		QuarterTurn turn;
+		uint16_t bpp = src.getBitsPerPixel();
+		if(toQuarterTurn(angle, turn) && isGeometryDepth(bpp)) {
+			bool swapped = (turn == TURN_90 || turn == TURN_270);
+			BitmapImage turned;
+			turned.allocate(swapped ? src.getHeight() : src.getWidth(), swapped ? src.getWidth() : src.getHeight(), bpp);
+			copyAttributes(src, turned);
+
+			rotateQuarter(src.getData(), src.getWidth(), src.getHeight(), src.getStride(),
+				turned.getData(), turned.getStride(), bpp / 8, turn);
+
+			dst = std::move(turned);
+			result = true;
+			return result;
 		}
 
-		//Writing gray image data.
-		writeImage(dstFile, buffRotData, rImageSize);
+		//Checking if the image is gray, 24 bit or 32 bit color.
+		if(!isGeometryDepth(bpp)) { return false; }
+
+		//Indices of a color palette are interpolated as the colors they stand for.
+		bool indexed = isIndexedColor(src);
+		BitmapImage expanded;
+		if(indexed) { expandIndexedColor(src, expanded); }
+		const BitmapImage &in = indexed ? expanded : src;
+		bpp = in.getBitsPerPixel();
+
+		uint32_t gImageWidth = in.getWidth();
+		uint32_t gimageHeight = in.getHeight();
+
+		//Calculating data sizes and the output to source mapping.
+		uint32_t rImageWidth, rImageHeight;
+		AffineMatrix inverse;
+		rotationGeometry(gImageWidth, gimageHeight, angle, rImageWidth, rImageHeight, inverse);
 
-		//Deleting heap memory
-		delete[] buffRotData;	//RULE: Always delete what you new.
-		buffRotData = 0;		//		Always free what you malloc.
+		//Creating rotated image buffer, 'dst' may alias 'src'.
+		BitmapImage rotated;
+		rotated.allocate(rImageWidth, rImageHeight, bpp);
+		copyAttributes(in, rotated);
 
-		delete[] buffGrayData;
-		buffGrayData = 0;
+		//Rotating the image about its center by inverse mapping every output pixel.
+		warpAffine(in.getData(), gImageWidth, gimageHeight, in.getStride(),
+			rotated.getData(), rImageWidth, rImageHeight, rotated.getStride(), inverse, interp, 0, bpp / 8);
 
+		dst = std::move(rotated);
 		result = true;
 	} catch(std::exception &e) {
-		std::cout << e.what() << std::endl;
+		reportError(e.what());
 	}
 	return result;
 }
 
-bool BitmapHandler::scaleImage(const uint8_t *srcFile, const uint8_t *dstFile, double X, double Y) {
+bool BitmapHandler::scaleImage(const BitmapImage &src, BitmapImage &dst, double X, double Y, const ResampleFilter filter) {
 	bool result = false;
+	TraceScope scope(this, "scaleImage", 0, result);
 	try {
-		//Reading the source image file for info.
-		getImageInfo(srcFile);
+		//Checking if the image is gray, 24 bit or 32 bit color.
+		uint16_t bpp = src.getBitsPerPixel();
+		if(!isGeometryDepth(bpp)) { return false; }
 
-		//Checking if the image is gray or not.
-		if(getBitsPerPixel() != BIT_GRAY_IMAGE) { return false; }
+		//Indices of a color palette are interpolated as the colors they stand for.
+		bool indexed = isIndexedColor(src);
+		BitmapImage expanded;
+		if(indexed) { expandIndexedColor(src, expanded); }
+		const BitmapImage &in = indexed ? expanded : src;
+		bpp = in.getBitsPerPixel();
 
 		//Calculating row data size.
-		if(X == 0.0) { X = 1.0; }														//Failsafe operation
-		if(Y == 0.0) { Y = 1.0; }
-
-		uint32_t gImageWidth = getImageWidth();
-		uint32_t sImageWidth = lround(getImageWidth() * X);
-
-		uint32_t gimageHeight = getImageHeight();
-		uint32_t sImageHeight = lround(getImageHeight() * Y);
-
-		uint32_t rowGrayData = (((BIT_GRAY_IMAGE * gImageWidth) + 31) / 32) * 4;		//Original image rows data.
-		uint32_t rowScaledData = (((BIT_GRAY_IMAGE * sImageWidth) + 31) / 32) * 4;		//Scaled image rows data.
-
-		uint32_t gImageSize = getImageSize();
-		uint32_t sImageSize = rowScaledData * sImageHeight;								//Scaled image size.
-
-		//Creating heap memory for image data.
-		uint8_t *buffGrayData = new uint8_t[gImageSize];
-		uint8_t *buffScaleData = new uint8_t[sImageSize];
-
-		//Resetting the created memory buffer.
-		memset(buffGrayData, 0, gImageSize);
-		memset(buffScaleData, 0, sImageSize);
-
-		//Reading the image data into the buffer.
-		readImage(srcFile, HEADER_SIZE + PALETTE_SIZE, buffGrayData, gImageSize);
-
-		//Changing header data.
-		setFileSize(HEADER_SIZE + PALETTE_SIZE + sImageSize);							//CHANGED
-		setReserved1(0);
-		setReserved2(0);
-		setImageOffset(getImageOffset());
-		setInfoHeaderSize(getInfoHeaderSize());
-		setImageWidth(sImageWidth);														//CHANGED
-		setImageHeight(sImageHeight);													//CHANGED
-		setColorPlane(1);
-		setBitsPerPixel(getBitsPerPixel());
-		setCompressionType(0);
-		setImageSize(sImageSize);														//CHANGED
-		setHorPixPerMeter(getHorPixPerMeter());
-		setVerPixPerMeter(getVerPixPerMeter());
-		setColorUsed(getColorUsed());
-		setImpColorUsed(getImpColorUsed());
+		if(X <= 0.0) { X = 1.0; }														//Failsafe operation
+		if(Y <= 0.0) { Y = 1.0; }
 
-		uint8_t rawData[HEADER_SIZE];
-		rawData[0] = HEADER_B0;
-		rawData[1] = HEADER_B1;
-		memcpy(&rawData[FILE_INFO_ADD], &BMP_FH, sizeof(BMP_FH));
-		memcpy(&rawData[IMAGE_INFO_ADD], &BMP_IH, sizeof(BMP_IH));
-
-		//Writing header data.
-		writeImage(dstFile, rawData, HEADER_SIZE);
-
-		//Creating palette.
-		createPalette();
-
-		//Writing palette data.
-		writeImage(dstFile, palette, PALETTE_SIZE);
-
-		//Scaling image data.
-		//x' = x * (width' / width)
-		//y' = y * (height' / height)
-		for(uint32_t i = 0; i < gimageHeight; i++) {
-			for(uint32_t j = 0; j < gImageWidth; j++) {
-				uint32_t xo = lround(i * sImageWidth / gImageWidth);
-				uint32_t yo = lround(j * sImageHeight / gimageHeight);
-				buffScaleData[(xo * rowScaledData) + yo] = buffGrayData[(i * rowGrayData) + j];
+		uint32_t gImageWidth = in.getWidth();
+		uint32_t sImageWidth = lround(gImageWidth * X);
+
+		uint32_t gimageHeight = in.getHeight();
+		uint32_t sImageHeight = lround(gimageHeight * Y);
+
+		if(sImageWidth == 0) { sImageWidth = 1; }
+		if(sImageHeight == 0) { sImageHeight = 1; }
+
+		//Creating scaled image buffer, 'dst' may alias 'src'.
+		BitmapImage scaled;
+		scaled.allocate(sImageWidth, sImageHeight, bpp);
+		copyAttributes(in, scaled);
+
+		//Scaling image data with the separable resampler.
+		//x = (x' + 0.5) * (width / width') - 0.5
+		//y = (y' + 0.5) * (height / height') - 0.5
+		runPlanes(in.getData(), gImageWidth, gimageHeight, in.getStride(),
+			scaled.getData(), sImageWidth, sImageHeight, scaled.getStride(), bpp / 8,
+			[&](const uint8_t *in, uint32_t inStride, uint8_t *out, uint32_t outStride) {
+			resamplePlane(in, gImageWidth, gimageHeight, inStride, out, sImageWidth, sImageHeight, outStride, filter);
+		});
+
+		dst = std::move(scaled);
+		result = true;
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::transformImage(const BitmapImage &src, BitmapImage &dst, const std::vector<GeometryStep> &steps,
+	const Interpolation interp, const uint8_t fill) {
+	bool result = false;
+	TraceScope scope(this, "transformImage", 0, result);
+	try {
+		//Checking if the image is gray, 24 bit or 32 bit color.
+		uint16_t bpp = src.getBitsPerPixel();
+		if(!isGeometryDepth(bpp)) { return false; }
+
+		//Indices of a color palette are interpolated as the colors they stand for.
+		bool indexed = isIndexedColor(src);
+		BitmapImage expanded;
+		if(indexed) { expandIndexedColor(src, expanded); }
+		const BitmapImage &in = indexed ? expanded : src;
+		bpp = in.getBitsPerPixel();
+
+		//Composing all steps into one output to source mapping.
+		uint32_t tImageWidth, tImageHeight;
+		AffineMatrix inverse;
+		transformGeometry(in.getWidth(), in.getHeight(), steps, tImageWidth, tImageHeight, inverse);
+
+		//Creating transformed image buffer, 'dst' may alias 'src'.
+		BitmapImage transformed;
+		transformed.allocate(tImageWidth, tImageHeight, bpp);
+		copyAttributes(in, transformed);
+
+		//One pass over the output with a single interpolation.
+		warpAffine(in.getData(), in.getWidth(), in.getHeight(), in.getStride(),
+			transformed.getData(), tImageWidth, tImageHeight, transformed.getStride(), inverse, interp, fill, bpp / 8);
+
+		dst = std::move(transformed);
+		result = true;
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::applyLut(const BitmapImage &src, BitmapImage &dst, const PointLut &lut) {
+	bool result = false;
+	TraceScope scope(this, "applyLut", 0, result);
+	try {
+		//Checking if the image is gray or not, indices of a color palette are no gray levels.
+		if(src.getBitsPerPixel() != BIT_GRAY_IMAGE || isIndexedColor(src)) { return false; }
+
+		//Working in place when 'dst' is 'src', a view is mapped into a fresh buffer
+		//instead of being copied first.
+		bool inPlace = (&src == &dst) && !src.isView();
+		BitmapImage mapped;
+		if(!inPlace) {
+			mapped.allocate(src.getWidth(), src.getHeight(), BIT_GRAY_IMAGE);
+			copyAttributes(src, mapped);
+		}
+		BitmapImage &out = inPlace ? dst : mapped;
+
+		//Mapping in row bands, row kernel is dispatched to the best SIMD level.
+		ThreadPool::getShared().parallelFor(0, src.getHeight(), MIN_BAND_ROWS, [&](uint32_t first, uint32_t last) {
+			for(uint32_t i = first; i < last; i++) {
+				applyLutRow(src.getRow(i), out.getRow(i), src.getWidth(), lut);
+			}
+		});
+
+		if(!inPlace) { dst = std::move(mapped); }
+		result = true;
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::gaussianBlur(const BitmapImage &src, BitmapImage &dst, const double sigma) {
+	if(sigma <= 0.0 || ceil(3.0 * sigma) > FILTER_MAX_RADIUS) { return false; }
+	return filterImage("gaussianBlur", src, dst,
+		[sigma](const uint8_t *in, uint32_t width, uint32_t height, uint32_t inStride, uint8_t *out, uint32_t outStride) {
+			gaussianPlane(in, width, height, inStride, out, outStride, sigma);
+		});
+}
+
+bool BitmapHandler::boxBlur(const BitmapImage &src, BitmapImage &dst, const uint32_t radius) {
+	return filterImage("boxBlur", src, dst,
+		[radius](const uint8_t *in, uint32_t width, uint32_t height, uint32_t inStride, uint8_t *out, uint32_t outStride) {
+			boxPlane(in, width, height, inStride, out, outStride, radius);
+		});
+}
+
+bool BitmapHandler::medianFilter(const BitmapImage &src, BitmapImage &dst, const uint32_t radius) {
+	return filterImage("medianFilter", src, dst,
+		[radius](const uint8_t *in, uint32_t width, uint32_t height, uint32_t inStride, uint8_t *out, uint32_t outStride) {
+			medianPlane(in, width, height, inStride, out, outStride, radius);
+		});
+}
+
+bool BitmapHandler::gradientImage(const BitmapImage &src, BitmapImage &dst, const GradientOperator op, const GradientOutput output) {
+	return filterImage("gradientImage", src, dst,
+		[op, output](const uint8_t *in, uint32_t width, uint32_t height, uint32_t inStride, uint8_t *out, uint32_t outStride) {
+			gradientPlane(in, width, height, inStride, out, outStride, op, output);
+		});
+}
+
+bool BitmapHandler::convolveImage(const BitmapImage &src, BitmapImage &dst, const std::vector<float> &kernel, const int32_t bias) {
+	uint32_t size = (uint32_t)lround(sqrt((double)kernel.size()));
+	if(size * size != kernel.size() || (size & 1) == 0 || size > FILTER_MAX_SIZE) { return false; }
+	return filterImage("convolveImage", src, dst,
+		[&kernel, size, bias](const uint8_t *in, uint32_t width, uint32_t height, uint32_t inStride, uint8_t *out, uint32_t outStride) {
+			convolvePlane(in, width, height, inStride, out, outStride, kernel.data(), size, bias);
+		});
+}
+
+bool BitmapHandler::computeStats(const BitmapImage &image, ImageStats &stats) {
+	bool result = false;
+	TraceScope scope(this, "computeStats", 0, result);
+	try {
+		//Indices of a color palette are counted as the colors they stand for.
+		bool indexed = isIndexedColor(image);
+		BitmapImage expanded;
+		if(indexed) { expandIndexedColor(image, expanded); }
+		const BitmapImage &in = indexed ? expanded : image;
+
+		result = ::computeStats(in.getData(), in.getWidth(), in.getHeight(), in.getStride(),
+			in.getBitsPerPixel(), stats);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::buildPyramid(const BitmapImage &src, std::vector<BitmapImage> &levels, const uint32_t count,
+	const PyramidFilter filter) {
+	bool result = false;
+	TraceScope scope(this, "buildPyramid", 0, result);
+	try {
+		//Checking for whole byte pixels, indices of a color palette can not be averaged.
+		uint16_t bpp = src.getBitsPerPixel();
+		if(!isGeometryDepth(bpp)) { return false; }
+		if(isIndexedColor(src)) { return false; }
+
+		uint32_t available = pyramidLevels(src.getWidth(), src.getHeight(), count);
+		std::vector<PyramidLevel> reducers(available);
+		std::vector<BitmapImage> images(available);
+		uint32_t width = src.getWidth(), height = src.getHeight();
+		for(uint32_t k = 0; k < available; k++) {
+			reducers[k].reset(width, height, bpp / 8, filter);
+			width = reducers[k].getWidth();
+			height = reducers[k].getHeight();
+			images[k].allocate(width, height, bpp);
+			copyAttributes(src, images[k]);
+		}
+
+		//Feeding the source in strips, completed rows go down the chain right away.
+		for(uint32_t first = 0; first < src.getHeight() && available; first += PYRAMID_STRIP_ROWS) {
+			uint32_t done = (src.getHeight() - first < PYRAMID_STRIP_ROWS) ? src.getHeight() - first : PYRAMID_STRIP_ROWS;
+			const uint8_t *data = src.getRow(first);
+			uint32_t stride = src.getStride();
+			for(uint32_t k = 0; k < available && done; k++) {
+				done = reducers[k].push(data, done, stride);
+				data = reducers[k].getRows();
+				stride = reducers[k].getStride();
+				memcpy(images[k].getRow(reducers[k].getFirstRow()), data, (size_t)done * stride);
 			}
 		}
 
-		//Writing scaled imaged data.
-		writeImage(dstFile, buffScaleData, sImageSize);
+		levels = std::move(images);
+		result = true;
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::equalizeImage(const BitmapImage &src, BitmapImage &dst) {
+	bool result = false;
+	TraceScope scope(this, "equalizeImage", 0, result);
 
-		//Deleting heap memory.
-		delete[] buffGrayData;
-		buffGrayData = 0;
+	//Checking if the image is gray or not, indices of a color palette are no gray levels.
+	if(src.getBitsPerPixel() != BIT_GRAY_IMAGE || isIndexedColor(src)) { return false; }
 
-		delete[] buffScaleData;
-		buffScaleData = 0;
+	ImageStats stats;
+	if(!computeStats(src, stats)) { return false; }
+	result = applyLut(src, dst, PointLut::equalize(stats.histogram[0]));
+	return result;
+}
 
+bool BitmapHandler::translatedImage(const BitmapImage &src, BitmapImage &dst, const int32_t X, const int32_t Y, const uint8_t fill) {
+	bool result = false;
+	TraceScope scope(this, "translatedImage", 0, result);
+	try {
+		//Checking if the image is gray, 24 bit or 32 bit color.
+		uint16_t bpp = src.getBitsPerPixel();
+		if(!isGeometryDepth(bpp)) { return false; }
+
+		//Whole pixel moves need no planes, color rows are moved as bytes.
+		int64_t pixelBytes = bpp / 8;
+		int64_t width = src.getWidth() * pixelBytes;
+		int64_t height = src.getHeight();
+		int64_t shift = (int64_t)X * pixelBytes;
+		if(shift > width) { shift = width; }
+		if(shift < -width) { shift = -width; }
+
+		//Working in place when 'dst' is 'src', otherwise on a fresh buffer.
+		bool inPlace = (&src == &dst);
+		BitmapImage translated;
+		if(!inPlace) {
+			translated.allocate(src.getWidth(), src.getHeight(), bpp);
+			copyAttributes(src, translated);
+		}
+		BitmapImage &out = inPlace ? dst : translated;
+		uint8_t *outData = out.getData();
+		const uint8_t *inData = inPlace ? outData : src.getData();
+		uint32_t stride = out.getStride();
+		uint32_t inStride = inPlace ? stride : src.getStride();
+
+		//Output row 'i' shows source row 'i - Y'.
+		auto translateRowAt = [&](int64_t i) {
+			int64_t k = i - Y;
+			const uint8_t *srcRow = (k < 0 || k >= height) ? 0 : inData + (size_t)k * inStride;
+			translateRow(srcRow, outData + (size_t)i * stride, width, (int32_t)shift, fill);
+		};
+
+		//Translating the image data about X and Y axis. In place moves with a vertical
+		//offset must visit rows so that no source row is overwritten before it is read.
+		if(inPlace && Y > 0) {
+			for(int64_t i = height - 1; i >= 0; i--) { translateRowAt(i); }
+		} else if(inPlace && Y < 0) {
+			for(int64_t i = 0; i < height; i++) { translateRowAt(i); }
+		} else {
+			ThreadPool::getShared().parallelFor(0, src.getHeight(), MIN_BAND_ROWS, [&](uint32_t first, uint32_t last) {
+				for(uint32_t i = first; i < last; i++) { translateRowAt(i); }
+			});
+		}
+
+		if(!inPlace) { dst = std::move(translated); }
 		result = true;
 	} catch(std::exception &e) {
-		std::cout << e.what() << std::endl;
+		reportError(e.what());
 	}
 	return result;
 }
 
-bool BitmapHandler::translatedImage(const uint8_t *srcFile, const uint8_t *dstFile, const uint32_t X, const uint32_t Y) {
+bool BitmapHandler::convert2GrayStream(const uint8_t *srcFile, const uint8_t *dstFile, const LumaWeights weights, ImageStats *stats) {
 	bool result = false;
 	try {
-		//Reading the source image file for info.
-		getImageInfo(srcFile);
+		StripSource source;
+		if(!openStream(srcFile, source)) { return false; }
+
+		//Checking if the image is colored or not, indexed images go through their palette.
+		bool indexed = source.bitsPerPixel == BIT_GRAY_IMAGE && isColorPalette(source.palette.data(), (uint32_t)source.palette.size());
+		if(source.bitsPerPixel < BIT_COLOR_IMAGE && !indexed) { return false; }
+		PointLut lut = indexed ? paletteGrayLut(source.palette.data(), weights) : PointLut();
+		source.palette.clear();										//Output gets the gray palette
+
+		AtomicFileWriter writer;
+		if(!beginStream(dstFile, writer, source, source.width, source.height, BIT_GRAY_IMAGE)) { return false; }
+
+		//Only one strip of color and gray rows is held in memory.
+		uint32_t rows = (stripRows < source.height) ? stripRows : source.height;
+		uint32_t bytesPerPixel = source.bitsPerPixel / 8;
+		BitmapImage colorStrip, grayStrip;
+		colorStrip.allocate(source.width, rows, source.bitsPerPixel);
+		grayStrip.allocate(source.width, rows, BIT_GRAY_IMAGE);
+		if(stats) { resetStats(*stats, 1); }
+		std::mutex mergeMutex;
+
+		for(uint32_t first = 0; first < source.height; first += rows) {
+			uint32_t count = (source.height - first < rows) ? source.height - first : rows;
+			if(!readRows(source, first, count, colorStrip.getData())) { return false; }
+
+			ThreadPool::getShared().parallelFor(0, count, MIN_BAND_ROWS, [&](uint32_t bandFirst, uint32_t bandLast) {
+				ImageStats band;
+				if(stats) { resetStats(band, 1); }
+				for(uint32_t i = bandFirst; i < bandLast; i++) {
+					if(indexed) { applyLutRow(colorStrip.getRow(i), grayStrip.getRow(i), source.width, lut); }
+					else { bgrToGrayRow(colorStrip.getRow(i), grayStrip.getRow(i), source.width, bytesPerPixel, weights); }
+					if(stats) { countRows(grayStrip.getRow(i), source.width, 1, grayStrip.getStride(), 1, band); }
+				}
+				if(stats) {
+					std::lock_guard<std::mutex> lock(mergeMutex);
+					mergeStats(*stats, band);
+				}
+			});
+
+			IoBuffer strip = { grayStrip.getData(), (size_t)count * grayStrip.getStride() };
+			if(!writeRows(writer, &strip, 1)) { return false; }
+		}
+
+		if(stats) { finishStats(*stats); }
+		result = commitRows(writer);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::rotateStream(const uint8_t *srcFile, const uint8_t *dstFile, const double angle, const Interpolation interp) {
+	bool result = false;
+	try {
+		StripSource source;
+		if(!openStream(srcFile, source)) { return false; }
+
+		//Checking if the image is gray, 24 bit or 32 bit color.
+		if(!isGeometryDepth(source.bitsPerPixel)) { return false; }
+
+		//Indices of a color palette are interpolated as the colors they stand for, right
+		//angles move whole pixels and keep them like in memory.
+		QuarterTurn turn;
+		if(!toQuarterTurn(angle, turn)) { expandIndexedColor(source); }
+
+		uint32_t rImageWidth, rImageHeight;
+		AffineMatrix inverse;
+		rotationGeometry(source.width, source.height, angle, rImageWidth, rImageHeight, inverse);
+
+		AtomicFileWriter writer;
+		if(!beginStream(dstFile, writer, source, rImageWidth, rImageHeight, source.bitsPerPixel)) { return false; }
+		if(!warpStrips(source, writer, rImageWidth, rImageHeight, inverse, interp, 0)) { return false; }
+
+		result = commitRows(writer);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::transformStream(const uint8_t *srcFile, const uint8_t *dstFile, const std::vector<GeometryStep> &steps,
+	const Interpolation interp, const uint8_t fill) {
+	bool result = false;
+	try {
+		StripSource source;
+		if(!openStream(srcFile, source)) { return false; }
+
+		//Checking if the image is gray, 24 bit or 32 bit color.
+		if(!isGeometryDepth(source.bitsPerPixel)) { return false; }
+
+		//Indices of a color palette are interpolated as the colors they stand for.
+		expandIndexedColor(source);
+
+		uint32_t tImageWidth, tImageHeight;
+		AffineMatrix inverse;
+		transformGeometry(source.width, source.height, steps, tImageWidth, tImageHeight, inverse);
+
+		AtomicFileWriter writer;
+		if(!beginStream(dstFile, writer, source, tImageWidth, tImageHeight, source.bitsPerPixel)) { return false; }
+		if(!warpStrips(source, writer, tImageWidth, tImageHeight, inverse, interp, fill)) { return false; }
+
+		result = commitRows(writer);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::lutStream(const uint8_t *srcFile, const uint8_t *dstFile, const PointLut &lut) {
+	bool result = false;
+	try {
+		StripSource source;
+		if(!openStream(srcFile, source)) { return false; }
+
+		//Checking if the image is gray or not, indices of a color palette are no gray levels.
+		if(source.bitsPerPixel != BIT_GRAY_IMAGE) { return false; }
+		if(isColorPalette(source.palette.data(), (uint32_t)source.palette.size())) { return false; }
+
+		AtomicFileWriter writer;
+		if(!beginStream(dstFile, writer, source, source.width, source.height, BIT_GRAY_IMAGE)) { return false; }
+
+		uint32_t rows = (stripRows < source.height) ? stripRows : source.height;
+		BitmapImage strip;
+		strip.allocate(source.width, rows, BIT_GRAY_IMAGE);
+
+		//Strips are mapped in place, padding stays zero as the table is only
+		//applied to the pixels.
+		for(uint32_t first = 0; first < source.height; first += rows) {
+			uint32_t count = (source.height - first < rows) ? source.height - first : rows;
+			if(!readRows(source, first, count, strip.getData())) { return false; }
+
+			ThreadPool::getShared().parallelFor(0, count, MIN_BAND_ROWS, [&](uint32_t bandFirst, uint32_t bandLast) {
+				for(uint32_t i = bandFirst; i < bandLast; i++) {
+					applyLutRow(strip.getRow(i), strip.getRow(i), source.width, lut);
+				}
+			});
+
+			IoBuffer buffer = { strip.getData(), (size_t)count * source.stride };
+			if(!writeRows(writer, &buffer, 1)) { return false; }
+		}
+
+		result = commitRows(writer);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::equalizeStream(const uint8_t *srcFile, const uint8_t *dstFile) {
+	bool result = false;
+	try {
+		//First pass counts the pixels strip by strip, the second one maps them.
+		ImageStats stats;
+		if(!statsStream(srcFile, stats)) { return false; }
 
 		//Checking if the image is gray or not.
-		if(getBitsPerPixel() != BIT_GRAY_IMAGE) { return false; }
+		if(stats.channels != 1) { return false; }
 
-		//Calculating row data size.
-		uint32_t rowByteData = (((BIT_GRAY_IMAGE * getImageWidth()) + 31) / 32) * 4;
-
-		//Creating heap memory for image data.
-		uint8_t *buffGrayData = new uint8_t[getImageSize()];
-		uint8_t *buffTransData = new uint8_t[getImageSize()];
-
-		//Resetting the created memory buffer.
-		memset(buffGrayData, 0, getImageSize());
-		memset(buffTransData, 0, getImageSize());
-
-		//Reading the image data into the buffer.
-		readImage(srcFile, HEADER_SIZE + PALETTE_SIZE, buffGrayData, getImageSize());
-
-		//Changing header data.
-		setFileSize(getFileSize());
-		setReserved1(0);
-		setReserved2(0);
-		setImageOffset(getImageOffset());
-		setInfoHeaderSize(getInfoHeaderSize());
-		setImageWidth(getImageWidth());
-		setImageHeight(getImageHeight());
-		setColorPlane(1);
-		setBitsPerPixel(getBitsPerPixel());
-		setCompressionType(0);
-		setImageSize(getImageSize());
-		setHorPixPerMeter(getHorPixPerMeter());
-		setVerPixPerMeter(getVerPixPerMeter());
-		setColorUsed(getColorUsed());
-		setImpColorUsed(getImpColorUsed());
+		result = lutStream(srcFile, dstFile, PointLut::equalize(stats.histogram[0]));
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
 
-		uint8_t rawData[HEADER_SIZE];
-		rawData[0] = HEADER_B0;
-		rawData[1] = HEADER_B1;
-		memcpy(&rawData[FILE_INFO_ADD], &BMP_FH, sizeof(BMP_FH));
-		memcpy(&rawData[IMAGE_INFO_ADD], &BMP_IH, sizeof(BMP_IH));
+bool BitmapHandler::statsStream(const uint8_t *fileName, ImageStats &stats) {
+	bool result = false;
+	try {
+		StripSource source;
+		if(!openStream(fileName, source)) { return false; }
+		if(source.bitsPerPixel != BIT_GRAY_IMAGE && source.bitsPerPixel < BIT_COLOR_IMAGE) { return false; }
+
+		//Indices of a color palette are counted as the colors they stand for.
+		expandIndexedColor(source);
+
+		uint32_t rows = (stripRows < source.height) ? stripRows : source.height;
+		BitmapImage strip;
+		strip.allocate(source.width, rows, source.bitsPerPixel);
+
+		ImageStats strips;
+		resetStats(strips, (source.bitsPerPixel == BIT_GRAY_IMAGE) ? 1 : STATS_MAX_CHANNELS);
+		for(uint32_t first = 0; first < source.height; first += rows) {
+			uint32_t count = (source.height - first < rows) ? source.height - first : rows;
+			if(!readRows(source, first, count, strip.getData())) { return false; }
+
+			ImageStats part;
+			::computeStats(strip.getData(), source.width, count, source.stride, source.bitsPerPixel, part);
+			mergeStats(strips, part);
+		}
+
+		finishStats(strips);
+		stats = strips;
+		result = true;
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::filterImage(const char *operation, const BitmapImage &src, BitmapImage &dst, const PlaneFilter &filter) {
+	bool result = false;
+	TraceScope scope(this, operation, 0, result);
+	try {
+		//Checking if the image is gray or not, indices of a color palette are no gray levels.
+		if(src.getBitsPerPixel() != BIT_GRAY_IMAGE || isIndexedColor(src)) { return false; }
+
+		//Neighbourhoods read the source after the rows are written, so 'dst' gets
+		//a fresh buffer even when it is the source.
+		BitmapImage filtered;
+		filtered.allocate(src.getWidth(), src.getHeight(), BIT_GRAY_IMAGE);
+		copyAttributes(src, filtered);
 
-		//Writing header data.
-		writeImage(dstFile, rawData, HEADER_SIZE);
+		filter(src.getData(), src.getWidth(), src.getHeight(), src.getStride(), filtered.getData(), filtered.getStride());
 
-		//Creating palette.
-		createPalette();
+		dst = std::move(filtered);
+		result = true;
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::filterFile(const char *operation, const uint8_t *srcFile, const uint8_t *dstFile, const uint32_t radius,
+	const PlaneFilter &filter) {
+	bool result = false;
+	TraceScope scope(this, operation, srcFile, result);
+	try {
+		if(!stripRows) {
+			BitmapImage image;
+			if(!loadImage(srcFile, image)) { return false; }
+			if(!filterImage(operation, image, image, filter)) { return false; }
+			return result = saveImage(dstFile, image);
+		}
+
+		StripSource source;
+		if(!openStream(srcFile, source)) { return false; }
+
+		//Checking if the image is gray or not, indices of a color palette are no gray levels.
+		if(source.bitsPerPixel != BIT_GRAY_IMAGE) { return false; }
+		if(isColorPalette(source.palette.data(), (uint32_t)source.palette.size())) { return false; }
+
+		AtomicFileWriter writer;
+		if(!beginStream(dstFile, writer, source, source.width, source.height, BIT_GRAY_IMAGE)) { return false; }
+
+		//Every strip is filtered together with the rows its neighbourhoods reach,
+		//only the rows of the strip itself are written.
+		uint32_t rows = (stripRows < source.height) ? stripRows : source.height;
+		uint64_t windowRows = (uint64_t)rows + 2 * (uint64_t)radius;
+		if(windowRows > source.height) { windowRows = source.height; }
+		BitmapImage window, filtered;
+		window.allocate(source.width, (uint32_t)windowRows, BIT_GRAY_IMAGE);
+		filtered.allocate(source.width, (uint32_t)windowRows, BIT_GRAY_IMAGE);
+
+		for(uint32_t first = 0; first < source.height; first += rows) {
+			uint32_t count = (source.height - first < rows) ? source.height - first : rows;
+			uint32_t w0 = (first > radius) ? first - radius : 0;
+			uint64_t w1 = (uint64_t)first + count + radius;
+			if(w1 > source.height) { w1 = source.height; }
+			uint32_t wCount = (uint32_t)(w1 - w0);
+
+			if(!readRows(source, w0, wCount, window.getData())) { return false; }
+			filter(window.getData(), source.width, wCount, window.getStride(), filtered.getData(), filtered.getStride());
+
+			IoBuffer strip = { filtered.getRow(first - w0), (size_t)count * filtered.getStride() };
+			if(!writeRows(writer, &strip, 1)) { return false; }
+		}
+
+		result = commitRows(writer);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::warpStrips(const StripSource &source, AtomicFileWriter &writer, const uint32_t dstWidth, const uint32_t dstHeight,
+	const AffineMatrix &inverse, const Interpolation interp, const uint8_t fill) {
+	//Output strips are split into column tiles narrow enough that the source rows
+	//under a tile, plus the interpolation margin, stay within the strip height.
+	double rowSpan = (fabs(inverse.e) > 1.0) ? fabs(inverse.e) : 1.0;
+	uint32_t rows = (uint32_t)(stripRows / 2 / rowSpan);
+	if(rows == 0) { rows = 1; }
+	if(rows > dstHeight) { rows = dstHeight; }
+
+	double budget = stripRows - rows * fabs(inverse.e) - 4.0;
+	uint32_t tileWidth = dstWidth;
+	if(fabs(inverse.d) * dstWidth > budget) {
+		tileWidth = (budget > fabs(inverse.d)) ? (uint32_t)(budget / fabs(inverse.d)) : 1;
+	}
 
-		//Writing palette data.
-		writeImage(dstFile, palette, PALETTE_SIZE);
+	const uint32_t pixelBytes = source.bitsPerPixel / 8;
+	BitmapImage strip;
+	strip.allocate(dstWidth, rows, source.bitsPerPixel);
+	uint32_t dstStride = strip.getStride();
+	std::vector<uint8_t> window;
+
+	for(uint32_t v0 = 0; v0 < dstHeight; v0 += rows) {
+		uint32_t vCount = (dstHeight - v0 < rows) ? dstHeight - v0 : rows;
+
+		for(uint32_t u0 = 0; u0 < dstWidth; u0 += tileWidth) {
+			uint32_t uCount = (dstWidth - u0 < tileWidth) ? dstWidth - u0 : tileWidth;
+			uint8_t *tile = strip.getData() + (size_t)u0 * pixelBytes;
+
+			//Source bounding box of the tile corners, widened by the interpolation margin.
+			double xMin = 1e300, xMax = -1e300, yMin = 1e300, yMax = -1e300;
+			for(uint32_t k = 0; k < 4; k++) {
+				double u = u0 + ((k & 1) ? uCount - 1 : 0);
+				double v = v0 + ((k & 2) ? vCount - 1 : 0);
+				double x = inverse.a * u + inverse.b * v + inverse.c;
+				double y = inverse.d * u + inverse.e * v + inverse.f;
+				xMin = (x < xMin) ? x : xMin; xMax = (x > xMax) ? x : xMax;
+				yMin = (y < yMin) ? y : yMin; yMax = (y > yMax) ? y : yMax;
+			}
+			int64_t x0 = (int64_t)floor(xMin) - 2, x1 = (int64_t)floor(xMax) + 3;
+			int64_t y0 = (int64_t)floor(yMin) - 2, y1 = (int64_t)floor(yMax) + 3;
+			if(x0 < 0) { x0 = 0; }
+			if(y0 < 0) { y0 = 0; }
+			if(x1 > source.width) { x1 = source.width; }
+			if(y1 > source.height) { y1 = source.height; }
+
+			if(x1 <= x0 || y1 <= y0) {
+				for(uint32_t i = 0; i < vCount; i++) { memset(tile + (size_t)i * dstStride, fill, (size_t)uCount * pixelBytes); }
+				continue;
+			}
 
-		//Translating the image data about X and Y axis.
-		for(uint32_t i = 0; i < getImageHeight() - Y; i++) {
-			for(uint32_t j = 0; j < getImageWidth() - X; j++) {
-				buffTransData[((i + Y) * rowByteData) + (j + X)] = buffGrayData[(i * rowByteData) + j];
+			//Reading whole rows when the box is wide or the rows need unpacking or expanding, otherwise only the box columns.
+			uint32_t wWidth = (uint32_t)(x1 - x0);
+			uint32_t wHeight = (uint32_t)(y1 - y0);
+			const uint8_t *wData;
+			uint32_t wStride;
+			if((uint64_t)wWidth * 2 >= source.width || !isNativeLayout(source.layout) || !source.colors.empty()) {
+				window.resize((size_t)wHeight * source.stride);
+				if(!readRows(source, (uint32_t)y0, wHeight, window.data())) { return false; }
+				wData = window.data() + x0 * pixelBytes;
+				wStride = source.stride;
+			} else {
+				wStride = wWidth * pixelBytes;
+				window.resize((size_t)wHeight * wStride);
+				StageTimer timer(activeTrace, STAGE_READ);
+				if(activeTrace) { activeTrace->bytesRead += (uint64_t)wHeight * wStride; }
+				for(uint32_t i = 0; i < wHeight; i++) {
+					uint64_t offset = source.offset + (uint64_t)(source.bottom + y0 + i) * source.fileStride +
+						(uint64_t)(source.left + x0) * pixelBytes;
+					if(!source.file.read(offset, &window[(size_t)i * wStride], wStride)) { return false; }
+				}
+				wData = window.data();
 			}
+
+			//Sampled at the positions of the whole image warp, the strips match it byte for byte.
+			warpAffineWindow(wData, wWidth, wHeight, wStride, x0, y0, tile, u0, v0, uCount, vCount, dstStride,
+				inverse, interp, fill, pixelBytes);
 		}
-		
-		//Writing translated image data.
-		writeImage(dstFile, buffTransData, getImageSize());
 
-		//Deleting heap memory.
-		delete[] buffGrayData;
-		buffGrayData = 0;
+		IoBuffer buffer = { strip.getData(), (size_t)vCount * dstStride };
+		if(!writeRows(writer, &buffer, 1)) { return false; }
+	}
 
-		delete[] buffTransData;
-		buffTransData = 0;
+	return true;
+}
 
-		result = true;
-	} catch(std::exception & e) {
-		std::cout << e.what() << std::endl;
+bool BitmapHandler::scaleStream(const uint8_t *srcFile, const uint8_t *dstFile, double X, double Y, const ResampleFilter filter) {
+	bool result = false;
+	try {
+		StripSource source;
+		if(!openStream(srcFile, source)) { return false; }
+
+		//Checking if the image is gray, 24 bit or 32 bit color.
+		if(!isGeometryDepth(source.bitsPerPixel)) { return false; }
+
+		//Indices of a color palette are interpolated as the colors they stand for.
+		expandIndexedColor(source);
+
+		//Calculating row data size.
+		if(X <= 0.0) { X = 1.0; }														//Failsafe operation
+		if(Y <= 0.0) { Y = 1.0; }
+
+		uint32_t sImageWidth = lround(source.width * X);
+		uint32_t sImageHeight = lround(source.height * Y);
+		if(sImageWidth == 0) { sImageWidth = 1; }
+		if(sImageHeight == 0) { sImageHeight = 1; }
+
+		FilterTable horTable, verTable;
+		buildFilterTable(source.width, sImageWidth, filter, horTable);
+		buildFilterTable(source.height, sImageHeight, filter, verTable);
+
+		AtomicFileWriter writer;
+		if(!beginStream(dstFile, writer, source, sImageWidth, sImageHeight, source.bitsPerPixel)) { return false; }
+
+		//Color passes run per plane, the window keeps its rows interleaved in between.
+		const uint32_t pixelBytes = source.bitsPerPixel / 8;
+		BitmapImage strip;
+		strip.allocate(sImageWidth, (stripRows < sImageHeight) ? stripRows : sImageHeight, source.bitsPerPixel);
+		uint32_t sStride = strip.getStride();
+		uint32_t wRow = sImageWidth * pixelBytes;
+		std::vector<uint8_t> raw;
+		std::vector<uint8_t> window;						//Horizontally resampled source rows [w0, w1)
+		int32_t w0 = 0, w1 = 0;
+
+		//Reads source rows [first, last) and resamples them into the window.
+		auto loadRows = [&](int32_t first, int32_t last, int32_t origin) -> bool {
+			if(last <= first) { return true; }
+			raw.resize((size_t)(last - first) * source.stride);
+			if(!readRows(source, first, last - first, raw.data())) { return false; }
+			runPlanes(raw.data(), source.width, last - first, source.stride,
+				&window[(size_t)(first - origin) * wRow], sImageWidth, last - first, wRow, pixelBytes,
+				[&](const uint8_t *in, uint32_t inStride, uint8_t *out, uint32_t outStride) {
+				resampleHorizontal(in, last - first, inStride, out, outStride, horTable);
+			});
+			return true;
+		};
+
+		for(uint32_t o0 = 0, o1 = 0; o0 < sImageHeight; o0 = o1) {
+			//Growing the strip while its source taps fit the strip height, at least one row.
+			int32_t lo = verTable.start[o0];
+			int32_t hi = verTable.start[o0] + verTable.taps[o0];
+			for(o1 = o0 + 1; o1 < sImageHeight && o1 - o0 < stripRows; o1++) {
+				int32_t nextLo = (verTable.start[o1] < lo) ? verTable.start[o1] : lo;
+				int32_t nextHi = (verTable.start[o1] + verTable.taps[o1] > hi) ? verTable.start[o1] + verTable.taps[o1] : hi;
+				if(nextHi - nextLo > (int32_t)stripRows) { break; }
+				lo = nextLo;
+				hi = nextHi;
+			}
+
+			//Keeping the rows shared with the previous window, reading the rest.
+			int32_t keepFirst = (lo > w0) ? lo : w0;
+			int32_t keepLast = (hi < w1) ? hi : w1;
+			if(keepLast <= keepFirst) { keepFirst = keepLast = lo; }
+
+			if(window.size() < (size_t)(hi - lo) * wRow) { window.resize((size_t)(hi - lo) * wRow); }
+			if(keepLast > keepFirst) {
+				memmove(&window[(size_t)(keepFirst - lo) * wRow], &window[(size_t)(keepFirst - w0) * wRow],
+					(size_t)(keepLast - keepFirst) * wRow);
+			}
+			if(!loadRows(lo, keepFirst, lo) || !loadRows(keepLast, hi, lo)) { return false; }
+			w0 = lo;
+			w1 = hi;
+
+			runPlanes(window.data(), sImageWidth, w1 - w0, wRow, strip.getData(), sImageWidth, o1 - o0, sStride, pixelBytes,
+				[&](const uint8_t *in, uint32_t inStride, uint8_t *out, uint32_t outStride) {
+				resampleVertical(in, inStride, w0, out, outStride, sImageWidth, o0, o1, verTable);
+			});
+
+			IoBuffer buffer = { strip.getData(), (size_t)(o1 - o0) * sStride };
+			if(!writeRows(writer, &buffer, 1)) { return false; }
+		}
+
+		result = commitRows(writer);
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::translateStream(const uint8_t *srcFile, const uint8_t *dstFile, const int32_t X, const int32_t Y, const uint8_t fill) {
+	bool result = false;
+	try {
+		StripSource source;
+		if(!openStream(srcFile, source)) { return false; }
+
+		//Checking if the image is gray, 24 bit or 32 bit color.
+		if(!isGeometryDepth(source.bitsPerPixel)) { return false; }
+
+		AtomicFileWriter writer;
+		if(!beginStream(dstFile, writer, source, source.width, source.height, source.bitsPerPixel)) { return false; }
+
+		//Color rows are moved as bytes like in memory.
+		int64_t pixelBytes = source.bitsPerPixel / 8;
+		int64_t width = source.width * pixelBytes;
+		int64_t shift = (int64_t)X * pixelBytes;
+		if(shift > width) { shift = width; }
+		if(shift < -width) { shift = -width; }
+
+		int64_t height = source.height;
+		uint32_t rows = (stripRows < source.height) ? stripRows : source.height;
+		BitmapImage srcStrip, dstStrip;
+		srcStrip.allocate(source.width, rows, source.bitsPerPixel);
+		dstStrip.allocate(source.width, rows, source.bitsPerPixel);
+
+		for(uint32_t first = 0; first < source.height; first += rows) {
+			uint32_t count = (source.height - first < rows) ? source.height - first : rows;
+
+			//Output rows [first, first + count) show source rows [first - Y, first + count - Y).
+			int64_t k0 = (int64_t)first - Y;
+			int64_t k1 = k0 + count;
+			if(k0 < 0) { k0 = 0; }
+			if(k1 > height) { k1 = height; }
+			if(k1 > k0 && !readRows(source, (uint32_t)k0, (uint32_t)(k1 - k0), srcStrip.getData())) { return false; }
+
+			ThreadPool::getShared().parallelFor(0, count, MIN_BAND_ROWS, [&](uint32_t bandFirst, uint32_t bandLast) {
+				for(uint32_t i = bandFirst; i < bandLast; i++) {
+					int64_t k = (int64_t)first + i - Y;
+					const uint8_t *srcRow = (k < k0 || k >= k1) ? 0 : srcStrip.getRow((uint32_t)(k - k0));
+					translateRow(srcRow, dstStrip.getRow(i), width, (int32_t)shift, fill);
+				}
+			});
+
+			IoBuffer strip = { dstStrip.getData(), (size_t)count * source.stride };
+			if(!writeRows(writer, &strip, 1)) { return false; }
+		}
+
+		result = commitRows(writer);
+	} catch(std::exception &e) {
+		reportError(e.what());
 	}
 	return result;
 }
@@ -427,31 +1591,411 @@ void BitmapHandler::readImage(const uint8_t *fileName, const uint32_t offset, ui
 		rimage.read((char *)buffer, size);
 		rimage.close();
 	} catch(std::exception & e) {
-		std::cout << e.what() << std::endl;
+		reportError(e.what());
 	}
 }
 
-void BitmapHandler::writeImage(const uint8_t *fileName, uint8_t *data, const uint32_t size) {
+bool BitmapHandler::writeImage(const uint8_t *fileName, const IoBuffer *buffers, const uint32_t count) {
+	bool result = false;
+	StageTimer timer(activeTrace, STAGE_WRITE);
 	try {
-		wimage.open((char *)fileName, std::ios::out | std::ios::binary | std::ios::app);
-		wimage.write((char *)data, size);
-		wimage.flush();
-		wimage.close();
+		result = writeFileAtomic((const char *)fileName, buffers, count);
+		if(!result) { reportError(std::string("Unable to write ") + (const char *)fileName); }
+		if(result && activeTrace) {
+			for(uint32_t i = 0; i < count; i++) { activeTrace->bytesWritten += buffers[i].size; }
+		}
 	} catch(std::exception & e) {
-		std::cout << e.what() << std::endl;
+		reportError(e.what());
 	}
+	return result;
 }
 
-void BitmapHandler::extractInfo(const uint8_t *data) {
+bool BitmapHandler::writeRows(AtomicFileWriter &writer, const IoBuffer *buffers, const uint32_t count) {
+	auto stream = std::find_if(rleStreams.begin(), rleStreams.end(), [&](const RleStream &s) { return s.writer == &writer; });
+	if(stream != rleStreams.end()) {
+		//Encoding every strip on its own, the encoded rows follow each other in the file.
+		bool result = true;
+		for(uint32_t i = 0; i < count && result; i++) {
+			uint32_t rows = (uint32_t)(buffers[i].size / stream->stride);
+			PixelBuffer encoded = BufferPool::getShared().acquire(rleBound(stream->width, rows));
+			size_t size = encodeRle8((const uint8_t *)buffers[i].data, stream->stride, stream->width, rows, encoded.data());
+			IoBuffer strip = { encoded.data(), size };
+
+			StageTimer timer(activeTrace, STAGE_WRITE);
+			result = writer.write(&strip, 1);
+			if(result && activeTrace) { activeTrace->bytesWritten += strip.size; }
+			stream->bytes += strip.size;
+		}
+		return result;
+	}
+
+	StageTimer timer(activeTrace, STAGE_WRITE);
+	bool result = writer.write(buffers, count);
+	if(result && activeTrace) {
+		for(uint32_t i = 0; i < count; i++) { activeTrace->bytesWritten += buffers[i].size; }
+	}
+	return result;
+}
+
+bool BitmapHandler::commitRows(AtomicFileWriter &writer) {
+	StageTimer timer(activeTrace, STAGE_WRITE);
+	auto stream = std::find_if(rleStreams.begin(), rleStreams.end(), [&](const RleStream &s) { return s.writer == &writer; });
+	if(stream != rleStreams.end()) {
+		RleStream encoded = *stream;
+		rleStreams.erase(stream);
+
+		//Ending the bitmap and filling in the sizes left open by beginStream().
+		static const uint8_t END_OF_BITMAP[2] = { 0, 1 };
+		IoBuffer end = { END_OF_BITMAP, sizeof(END_OF_BITMAP) };
+		encoded.bytes += sizeof(END_OF_BITMAP);
+		if(encoded.dataOffset + encoded.bytes > UINT32_MAX) { return false; }
+
+		uint32_t imageSize = (uint32_t)encoded.bytes;
+		uint32_t fileSize = encoded.dataOffset + imageSize;
+		if(!writer.write(&end, 1) || !writer.rewrite(FILE_INFO_ADD, &fileSize, sizeof(fileSize)) ||
+			!writer.rewrite(IMAGE_SIZE_ADD, &imageSize, sizeof(imageSize))) {
+			return false;
+		}
+		if(activeTrace) { activeTrace->bytesWritten += sizeof(END_OF_BITMAP); }
+	}
+	return writer.commit();
+}
+
+void BitmapHandler::reportError(const std::string &message) {
+	std::cout << message << std::endl;
+	if(activeTrace) { activeTrace->error = message; }
+}
+
+bool BitmapHandler::beginTrace(const char *operation, const uint8_t *fileName) {
+	if(!tracing || activeTrace) { return false; }
+
+	resetTrace(trace, operation);
+	if(fileName) { trace.file = (const char *)fileName; }
+	memset(&poolCounters, 0, sizeof(poolCounters));
+	BufferPool::setThreadCounters(&poolCounters);
+	activeTrace = &trace;
+	traceStart = std::chrono::steady_clock::now();
+	return true;
+}
+
+void BitmapHandler::endTrace(const bool result) {
+	double total = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - traceStart).count();
+	BufferPool::setThreadCounters(0);
+	activeTrace = 0;
+
+	trace.success = result;
+	trace.totalMs = total;
+	trace.stageMs[STAGE_ALLOCATE] = poolCounters.acquireMs;
+	trace.allocations = poolCounters.acquisitions;
+	trace.allocatedBytes = poolCounters.allocatedBytes;
+	trace.threads = getThreadCount();
+	trace.stripRows = stripRows;
+
+	//The kernel gets whatever the measured stages leave of the call
+	double other = trace.stageMs[STAGE_HEADER] + trace.stageMs[STAGE_READ] + trace.stageMs[STAGE_ALLOCATE] +
+		trace.stageMs[STAGE_WRITE];
+	trace.stageMs[STAGE_KERNEL] = std::max(0.0, total - other);
+
+	if(traceOutput) { writeTrace(traceOutput, trace); }
+}
+
+bool BitmapHandler::validateHeader(const uint64_t fileSize) {
+	if(!isImageFound()) { return false; }
+
+	uint64_t imageBytes = (uint64_t)BitmapImage::calcStride(getImageWidth(), getBitsPerPixel()) * getImageHeight();
+	uint64_t workingBytes = (uint64_t)BitmapImage::calcStride(getImageWidth(), layout.workingBits) * getImageHeight();
+
+	if(getImageWidth() == 0 || getImageHeight() == 0 || layout.format == PIXEL_UNSUPPORTED ||
+		getInfoHeaderSize() < INFO_HEADER_SIZE || imageBytes > UINT32_MAX || workingBytes > UINT32_MAX ||
+		getImageOffset() + pixelDataSize(fileSize) > fileSize) {
+		imageFound = false;
+		return false;
+	}
+	return true;
+}
+
+uint64_t BitmapHandler::pixelDataSize(const uint64_t fileSize) const {
+	if(!isRunLengthLayout(layout)) { return (uint64_t)BitmapImage::calcStride(getImageWidth(), getBitsPerPixel()) * getImageHeight(); }
+
+	//Encoders may leave the image size out, the pixels then run to the end of the file.
+	if(getImageSize()) { return getImageSize(); }
+	return (getImageOffset() < fileSize) ? fileSize - getImageOffset() : 0;
+}
+
+uint32_t BitmapHandler::createHeader(uint8_t *rawData, const uint32_t width, const uint32_t height, const uint16_t bpp,
+	const uint32_t hpm, const uint32_t vpm, const uint32_t compression, const uint32_t encodedSize) {
+	uint32_t paletteSize = (bpp == BIT_GRAY_IMAGE) ? PALETTE_SIZE : 0;
+	uint32_t dataSize = (compression == COMPRESSION_RGB) ? BitmapImage::calcStride(width, bpp) * height : encodedSize;
+
+	//Changing header data according to the image.
+	setFileSize(HEADER_SIZE + paletteSize + dataSize);
+	setReserved1(0);
+	setReserved2(0);
+	setImageOffset(HEADER_SIZE + paletteSize);
+	setInfoHeaderSize(HEADER_SIZE - IMAGE_INFO_ADD);
+	setImageWidth(width);
+	setImageHeight(height);
+	setColorPlane(1);
+	setBitsPerPixel(bpp);
+	setCompressionType(compression);
+	setImageSize(dataSize);
+	setHorPixPerMeter(hpm);
+	setVerPixPerMeter(vpm);
+	setColorUsed(paletteSize ? lround(pow(2, BIT_GRAY_IMAGE)) : 0);
+	setImpColorUsed(0);
+
+	//Creating header data.
+	rawData[0] = HEADER_B0;
+	rawData[1] = HEADER_B1;
+	memcpy(&rawData[FILE_INFO_ADD], &BMP_FH, sizeof(BMP_FH));
+	memcpy(&rawData[IMAGE_INFO_ADD], &BMP_IH, sizeof(BMP_IH));
+
+	return paletteSize;
+}
+
+bool BitmapHandler::openStream(const uint8_t *fileName, StripSource &source) {
+	bool result = false;
+	try {
+		StageTimer timer(activeTrace, STAGE_HEADER);
+		imageFound = false;
+		if(!source.file.open((const char *)fileName)) {
+			reportError(std::string("Unable to open ") + (const char *)fileName);
+			return false;
+		}
+
+		//Extracting and validating header info, the largest info header is read for its masks.
+		uint8_t rawData[HEADER_READ_SIZE];
+		uint32_t headerBytes = (source.file.getSize() < HEADER_READ_SIZE) ? (uint32_t)source.file.getSize() : HEADER_READ_SIZE;
+		if(headerBytes < HEADER_SIZE || !source.file.read(0, rawData, headerBytes)) { return false; }
+		if(activeTrace) { activeTrace->bytesRead += headerBytes; }
+		extractInfo(rawData, headerBytes);
+		if(!validateHeader(source.file.getSize())) { return false; }
+
+		//Handing out the rows of the region only, rows are stored bottom-up.
+		ImageRect window = { 0, 0, getImageWidth(), getImageHeight() };
+		if(hasRegion()) {
+			window = region;
+			if(!clipRect(window, getImageWidth(), getImageHeight())) { return false; }
+		}
+
+		source.offset = getImageOffset();
+		source.width = window.width;
+		source.height = window.height;
+		source.fileWidth = getImageWidth();
+		source.fileHeight = getImageHeight();
+		source.left = window.x;
+		source.bottom = getImageHeight() - window.y - window.height;
+		source.layout = layout;
+		source.bitsPerPixel = layout.workingBits;
+		source.stride = BitmapImage::calcStride(source.width, source.bitsPerPixel);
+		source.fileStride = BitmapImage::calcStride(source.fileWidth, getBitsPerPixel());
+		source.hPixPM = getHorPixPerMeter();
+		source.vPixPM = getVerPixPerMeter();
+		source.rle.reset();
+
+		//Reading palette data for indexed images.
+		uint64_t paletteOffset;
+		uint32_t paletteSize;
+		paletteLocation(paletteOffset, paletteSize);
+		source.palette.clear();
+		source.levels.clear();
+		source.colors.clear();
+		if(paletteSize) {
+			uint8_t entries[PALETTE_SIZE];
+			if(!source.file.read(paletteOffset, entries, paletteSize)) { return false; }
+			if(activeTrace) { activeTrace->bytesRead += paletteSize; }
+			preparePalette(entries, paletteSize, source.palette, source.levels);
+		}
+
+		//Encoded rows are decoded from chunks of the file as the strips ask for them.
+		if(isRunLengthLayout(layout)) {
+			source.rle.reset(new RleDecoder());
+			source.rle->reset(layout.format, source.fileWidth, source.fileHeight, pixelDataSize(source.file.getSize()),
+				source.levels.empty() ? 0 : source.levels.data());
+		}
+
+		result = true;
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+bool BitmapHandler::readRows(const StripSource &source, const uint32_t first, const uint32_t count, uint8_t *buffer) {
+	//Indices of a color palette are read as the 8 bit rows they are stored as and expanded at the end.
+	const bool expand = !source.colors.empty();
+	const uint16_t bitsPerPixel = expand ? BIT_GRAY_IMAGE : source.bitsPerPixel;
+	const uint32_t stride = expand ? BitmapImage::calcStride(source.width, BIT_GRAY_IMAGE) : source.stride;
+	PixelBuffer indices;
+	if(expand) { indices = BufferPool::getShared().acquire((size_t)count * stride); }
+	uint8_t *target = expand ? indices.data() : buffer;
+
+	//Rows narrower than the file rows are cut out of whole rows, or read column exact when stored as they are.
+	const bool windowed = source.width != source.fileWidth;
+	const uint32_t pixelBytes = bitsPerPixel / 8;
+	const uint32_t wholeStride = BitmapImage::calcStride(source.fileWidth, bitsPerPixel);
+	const uint32_t fileFirst = source.bottom + first;
+	auto cutColumns = [&](const uint8_t *rows) {
+		for(uint32_t i = 0; i < count; i++) {
+			memcpy(target + (size_t)i * stride, rows + (size_t)i * wholeStride + (size_t)source.left * pixelBytes,
+				(size_t)source.width * pixelBytes);
+		}
+		clearRowPadding(target, count, source.width * pixelBytes, stride);
+	};
+
+	bool result = false;
+	if(source.rle) {
+		StageTimer timer(activeTrace, STAGE_READ);
+		uint64_t fetched = source.rle->getFetchedBytes();
+		PixelBuffer whole;
+		if(windowed) { whole = BufferPool::getShared().acquire((size_t)count * wholeStride); }
+		result = source.rle->read(source.file, source.offset, fileFirst, count, windowed ? whole.data() : target,
+			windowed ? wholeStride : stride);
+		if(result && windowed) { cutColumns(whole.data()); }
+		if(activeTrace) { activeTrace->bytesRead += source.rle->getFetchedBytes() - fetched; }
+	} else {
+		bool native = isNativeLayout(source.layout);
+		PixelBuffer raw, whole;
+		if(!native) { raw = BufferPool::getShared().acquire((size_t)count * source.fileStride); }
+		if(!native && windowed) { whole = BufferPool::getShared().acquire((size_t)count * wholeStride); }
+
+		StageTimer timer(activeTrace, STAGE_READ);
+		if(native && windowed) {
+			//Reading the bytes of the window of every row.
+			if(activeTrace) { activeTrace->bytesRead += (uint64_t)count * source.width * pixelBytes; }
+			result = true;
+			for(uint32_t i = 0; i < count && result; i++) {
+				uint64_t offset = source.offset + (uint64_t)(fileFirst + i) * source.fileStride + (uint64_t)source.left * pixelBytes;
+				result = source.file.read(offset, target + (size_t)i * stride, (size_t)source.width * pixelBytes);
+			}
+			clearRowPadding(target, count, source.width * pixelBytes, stride);
+		} else if(native) {
+			if(activeTrace) { activeTrace->bytesRead += (uint64_t)count * stride; }
+			result = source.file.read(source.offset + (uint64_t)fileFirst * stride, target, (size_t)count * stride);
+		} else {
+			//Top-down files hold the requested rows in reverse order, in the same block the last one comes first.
+			if(activeTrace) { activeTrace->bytesRead += (uint64_t)count * source.fileStride; }
+			uint64_t fileRow = source.layout.topDown ? source.fileHeight - fileFirst - count : fileFirst;
+			result = source.file.read(source.offset + fileRow * source.fileStride, raw.data(), (size_t)count * source.fileStride);
+			if(result) {
+				const uint8_t *rows = source.layout.topDown ? raw.data() + (size_t)(count - 1) * source.fileStride : raw.data();
+				int64_t step = source.layout.topDown ? -(int64_t)source.fileStride : (int64_t)source.fileStride;
+				unpackRows(source.layout, rows, step, windowed ? whole.data() : target, windowed ? wholeStride : stride,
+					source.fileWidth, count, source.levels.empty() ? 0 : source.levels.data());
+				if(windowed) { cutColumns(whole.data()); }
+			}
+		}
+	}
+
+	if(result && expand) {
+		expandPaletteRows(target, stride, buffer, source.stride, source.width, count, source.colors.data());
+		clearRowPadding(buffer, count, source.width * 3, source.stride);
+	}
+	if(!result) { reportError("Unable to read image rows"); }
+	return result;
+}
+
+bool BitmapHandler::beginStream(const uint8_t *fileName, AtomicFileWriter &writer, const StripSource &source,
+	const uint32_t width, const uint32_t height, const uint16_t bpp) {
+	bool result = false;
+	try {
+		if((uint64_t)BitmapImage::calcStride(width, bpp) * height > UINT32_MAX - HEADER_SIZE - PALETTE_SIZE) { return false; }
+
+		//Encoded sizes are only known once all rows are written, commitRows() fills them in.
+		bool encode = rleOutput && bpp == BIT_GRAY_IMAGE;
+		rleStreams.erase(std::remove_if(rleStreams.begin(), rleStreams.end(),
+			[&](const RleStream &s) { return s.writer == &writer; }), rleStreams.end());
+
+		uint8_t rawData[HEADER_SIZE];
+		uint32_t paletteSize = createHeader(rawData, width, height, bpp, source.hPixPM, source.vPixPM,
+			encode ? COMPRESSION_RLE8 : COMPRESSION_RGB, 0);
+
+		//Creating palette data, keeping the source palette if it has one.
+		if(paletteSize) {
+			if(source.palette.size() == PALETTE_SIZE) {
+				memcpy(palette, source.palette.data(), PALETTE_SIZE);
+			} else {
+				createPalette();
+			}
+		}
+
+		if(!writer.open((const char *)fileName)) {
+			reportError(std::string("Unable to write ") + (const char *)fileName);
+			return false;
+		}
+
+		IoBuffer buffers[2] = {
+			{ rawData, HEADER_SIZE },
+			{ palette, paletteSize }
+		};
+		result = writeRows(writer, buffers, 2);
+
+		if(encode) {
+			RleStream stream = { &writer, width, BitmapImage::calcStride(width, bpp), HEADER_SIZE + paletteSize, 0 };
+			rleStreams.push_back(stream);
+		}
+	} catch(std::exception &e) {
+		reportError(e.what());
+	}
+	return result;
+}
+
+void BitmapHandler::extractInfo(const uint8_t *data, const uint64_t size) {
 	try {
 		imageFound = false;
 		if(data[0] == HEADER_B0 && data[1] == HEADER_B1) {
 			memcpy(&BMP_FH, &data[FILE_INFO_ADD], sizeof(BMP_FH));
 			memcpy(&BMP_IH, &data[IMAGE_INFO_ADD], sizeof(BMP_IH));
+
+			//A negative height marks rows stored top-down.
+			bool topDown = (int32_t)BMP_IH.imageHeight < 0;
+			if(topDown) { BMP_IH.imageHeight = 0u - BMP_IH.imageHeight; }
+
+			//Channel masks are part of V2 and later headers, otherwise they follow the info header.
+			uint32_t masks[4] = { 0 };
+			uint32_t maskCount = 0;
+			if(getInfoHeaderSize() >= INFO_V3_SIZE || getCompressionType() == COMPRESSION_ALPHABITFIELDS) { maskCount = 4; }
+			else if(getInfoHeaderSize() >= INFO_V2_SIZE || getCompressionType() == COMPRESSION_BITFIELDS) { maskCount = 3; }
+			if(IMAGE_INFO_ADD + INFO_HEADER_SIZE + maskCount * 4 <= size) {
+				memcpy(masks, &data[IMAGE_INFO_ADD + INFO_HEADER_SIZE], maskCount * 4);
+			}
+			describeLayout(getBitsPerPixel(), getCompressionType(), masks, topDown, layout);
 			imageFound = true;
 		}
 	} catch(std::exception &e) {
-		std::cout << e.what() << std::endl;
+		reportError(e.what());
+	}
+}
+
+void BitmapHandler::paletteLocation(uint64_t &offset, uint32_t &size) const {
+	offset = (uint64_t)IMAGE_INFO_ADD + getInfoHeaderSize();
+	size = 0;
+	if(getBitsPerPixel() > BIT_GRAY_IMAGE || offset >= getImageOffset()) { return; }
+
+	//Palettes have 2^bpp entries unless fewer are used, a palette running into the pixels is cut short.
+	uint64_t entries = getColorUsed() ? getColorUsed() : (1u << getBitsPerPixel());
+	if(entries > 256) { entries = 256; }
+	if(entries > (getImageOffset() - offset) / 4) { entries = (getImageOffset() - offset) / 4; }
+	size = (uint32_t)entries * 4;
+}
+
+void BitmapHandler::preparePalette(const uint8_t *entries, const uint32_t size, std::vector<uint8_t> &imagePalette,
+	std::vector<uint8_t> &levels) const {
+	imagePalette.assign(PALETTE_SIZE, 0);
+	memcpy(imagePalette.data(), entries, size);
+	levels.clear();
+	if(getBitsPerPixel() >= BIT_GRAY_IMAGE) { return; }
+
+	for(uint32_t i = 0; i < size; i += 4) {
+		if(entries[i] != entries[i + 1] || entries[i] != entries[i + 2]) { return; }
+	}
+
+	//Gray palette, the unpacked rows hold the gray values themselves.
+	levels.assign(256, 0);
+	for(uint32_t i = 0; i < size / 4; i++) { levels[i] = entries[i * 4]; }
+	for(uint32_t i = 0; i < 256; i++) {
+		imagePalette[i * 4] = imagePalette[i * 4 + 1] = imagePalette[i * 4 + 2] = (uint8_t)i;
+		imagePalette[i * 4 + 3] = 0;
 	}
 }
 
@@ -465,6 +2009,88 @@ void BitmapHandler::createPalette(void) {
 			palette[k++] = 0;
 		}
 	} catch(std::exception & e) {
-		std::cout << e.what() << std::endl;
+		reportError(e.what());
+	}
+}
+
+void BitmapHandler::copyAttributes(const BitmapImage &src, BitmapImage &dst) const {
+	dst.setHorPixPerMeter(src.getHorPixPerMeter());
+	dst.setVerPixPerMeter(src.getVerPixPerMeter());
+	if(src.getPaletteSize() == PALETTE_SIZE) {
+		dst.setPalette(src.getPalette(), src.getPaletteSize());
+	} else {
+		dst.createGrayPalette();
+	}
+}
+
+void BitmapHandler::rotationGeometry(const uint32_t width, const uint32_t height, double angle,
+	uint32_t &rWidth, uint32_t &rHeight, AffineMatrix &inverse) const {
+	angle = fmod(angle, 360.0);														//Failsafe operations
+	if(angle < 0.0) { angle += 360.0; }
+
+	double cosA = cos(toRadians(angle));
+	double sinA = sin(toRadians(angle));
+
+	//Bounding box of the rotated image.
+	rWidth = lround((height * fabs(sinA)) + (width * fabs(cosA)));
+	rHeight = lround((height * fabs(cosA)) + (width * fabs(sinA)));
+	if(rWidth == 0) { rWidth = 1; }
+	if(rHeight == 0) { rHeight = 1; }
+
+	//Rotation about the pixel centers, inverted to map output pixels onto the source.
+	//x' = x * cos(a) - y * sin(a)        x = x' * cos(a) + y' * sin(a)
+	//y' = x * sin(a) + y * cos(a)        y = y' * cos(a) - x' * sin(a)
+	double cxSrc = (width - 1) / 2.0;
+	double cySrc = (height - 1) / 2.0;
+	double cxRot = (rWidth - 1) / 2.0;
+	double cyRot = (rHeight - 1) / 2.0;
+
+	inverse.a = cosA;
+	inverse.b = sinA;
+	inverse.c = cxSrc - (cxRot * cosA) - (cyRot * sinA);
+	inverse.d = -sinA;
+	inverse.e = cosA;
+	inverse.f = cySrc + (cxRot * sinA) - (cyRot * cosA);
+}
+
+void BitmapHandler::transformGeometry(const uint32_t width, const uint32_t height, const std::vector<GeometryStep> &steps,
+	uint32_t &tWidth, uint32_t &tHeight, AffineMatrix &inverse) const {
+	tWidth = width;
+	tHeight = height;
+	inverse = identityAffine();
+
+	//Every step maps its output back onto its input, the steps are chained from
+	//the first to the last so the composed mapping goes from the final output
+	//to the source image.
+	for(const GeometryStep &step : steps) {
+		uint32_t outWidth = tWidth;
+		uint32_t outHeight = tHeight;
+		AffineMatrix stepInverse = identityAffine();
+
+		if(step.op == GEOMETRY_ROTATE) {
+			rotationGeometry(tWidth, tHeight, step.x, outWidth, outHeight, stepInverse);
+		} else if(step.op == GEOMETRY_SCALE) {
+			//Same sizes and sample positions as scaleImage().
+			//x = (x' + 0.5) * (width / width') - 0.5
+			double X = (step.x <= 0.0) ? 1.0 : step.x;
+			double Y = (step.y <= 0.0) ? 1.0 : step.y;
+			outWidth = lround(tWidth * X);
+			outHeight = lround(tHeight * Y);
+			if(outWidth == 0) { outWidth = 1; }
+			if(outHeight == 0) { outHeight = 1; }
+
+			stepInverse.a = (double)tWidth / outWidth;
+			stepInverse.c = 0.5 * stepInverse.a - 0.5;
+			stepInverse.e = (double)tHeight / outHeight;
+			stepInverse.f = 0.5 * stepInverse.e - 0.5;
+		} else if(step.op == GEOMETRY_TRANSLATE) {
+			//Output pixel (u, v) shows input pixel (u - X, v - Y).
+			stepInverse.c = -step.x;
+			stepInverse.f = -step.y;
+		}
+
+		inverse = composeAffine(inverse, stepInverse);
+		tWidth = outWidth;
+		tHeight = outHeight;
 	}
 }
@@ -1,7 +1,7 @@
 /*!
  * @author Syed Asad Amin
  * @date Nov 02nd, 2019
- * @version 1.0.6
+ * @version 1.2.12
  *          - 1.0.0 - Added file reading feature along with data extraction
  *          - 1.0.1 - Corrected data skip problem during file read.
  *          - 1.0.2 - Added data structure support.
@@ -9,6 +9,32 @@
  *			- 1.0.4 - Added gray scale translation support.
  *			- 1.0.5 - Added gray scale scaling support.
  *			- 1.0.6 - Added gray scale rotation support.
+ *			- 1.0.7 - Added in-memory image support for chaining operations.
+ *			- 1.0.8 - Added memory mapped zero-copy image loading.
+ *			- 1.0.9 - Added atomic single gather write of output images.
+ *			- 1.1.0 - Added SIMD gray scale kernels with selectable luma weights.
+ *			- 1.1.1 - Added row parallel execution on a shared thread pool.
+ *			- 1.1.2 - Added inverse mapping rotation with bilinear interpolation.
+ *			- 1.1.3 - Added separable resampling for scaling.
+ *			- 1.1.4 - Added in-place translation with signed offsets.
+ *			- 1.1.5 - Added strip streaming of file operations with bounded memory.
+ *			- 1.1.6 - Added cached header info.
+ *			- 1.1.7 - Added pooled aligned buffers without full clearing.
+ *			- 1.1.8 - Added fused single pass geometry pipeline.
+ *			- 1.1.9 - Added lookup table point operations.
+ *			- 1.2.0 - Added parallel image statistics.
+ *			- 1.2.1 - Added SIMD neighbourhood filters.
+ *			- 1.2.2 - Added pixel formats driven by the real header.
+ *			- 1.2.3 - Added per stage operation tracing.
+ *			- 1.2.4 - Added loading from file contents in memory.
+ *			- 1.2.5 - Added lossless right angle rotations.
+ *			- 1.2.6 - Added RLE8/RLE4 reading and RLE8 writing.
+ *			- 1.2.7 - Added single pass image pyramids.
+ *			- 1.2.8 - Added regions of interest.
+ *			- 1.2.9 - Added 24 bit color rotation, scaling and translation.
+ *			- 1.2.10 - Streamed warps sample at the positions of in-memory warps.
+ *			- 1.2.11 - Added 32 bit BGRA rotation, scaling and translation.
+ *			- 1.2.12 - Expanded color palette images to BGR24 before interpolating them.
  *
  * @desc This library is used to extract and manipulate the 'BMP' file data.
  *
@@ -33,19 +59,47 @@
 
 #pragma once
 
+#ifdef _MSC_VER
 #pragma comment(linker, "/STACK:10485760")
 #pragma comment(linker, "/HEAP:10485760")
+#endif
 
+#ifdef _WIN32
 #include <conio.h>
+#endif
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstdint>
 #include <cstddef>
 #include <cstring>
 #include <cmath>
+#include <chrono>
 
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "AffineWarp.h"
+#include "BitmapImage.h"
+#include "BitmapIndex.h"
+#include "BitmapIO.h"
+#include "BufferPool.h"
+#include "Filters.h"
+#include "GrayKernels.h"
+#include "ImageStats.h"
+#include "OperationTrace.h"
+#include "PixelFormat.h"
+#include "PointOps.h"
+#include "Pyramid.h"
+#include "Resampler.h"
+#include "RunLength.h"
+#include "ThreadPool.h"
+#include "Transpose.h"
 
 #ifndef M_PI 
 static const double M_PI = 3.1415926535897932384626433832795;
@@ -56,6 +110,7 @@ static const double M_PI = 3.1415926535897932384626433832795;
 static const uint8_t HEADER_SIZE		= 54;
 static const uint16_t PALETTE_SIZE		= 1024;
 
+static const uint8_t BIT_ALPHA_IMAGE	= 32;
 static const uint8_t BIT_COLOR_IMAGE	= 24;
 static const uint8_t BIT_GRAY_IMAGE		= 8;
 
@@ -63,8 +118,46 @@ static const uint8_t HEADER_B0			= 'B';		//Equivalent to 66 form ascii table
 static const uint8_t HEADER_B1			= 'M';		//Equivalent to 77 from ascii table
 static const uint8_t FILE_INFO_ADD		= 2;
 static const uint8_t IMAGE_INFO_ADD		= 14;
+static const uint8_t IMAGE_SIZE_ADD		= IMAGE_INFO_ADD + 20;	//Image size field of the info header
+static const uint32_t HEADER_READ_SIZE	= IMAGE_INFO_ADD + INFO_V5_SIZE;	//Largest header read from a file
 #endif
 
+static const uint32_t MIN_BAND_ROWS		= 16;		//Smallest row band given to a thread
+
+/*! Source image opened for strip streaming, pixel rows are read on demand */
+struct StripSource {
+	FileReader file;					/*! Positional reader of the source file */
+	uint64_t offset;					/*! File offset of the first (bottom) row */
+	uint32_t width;						/*! Width of the rows handed out, the region width if one is set */
+	uint32_t height;					/*! Number of rows handed out */
+	uint32_t stride;					/*! Row size in bytes of the rows handed out */
+	uint16_t bitsPerPixel;				/*! Bits per pixel of the rows handed out: 8/24/32 */
+	uint32_t hPixPM;					/*! Horizontal resolution */
+	uint32_t vPixPM;					/*! Vertical resolution */
+	std::vector<uint8_t> palette;		/*! Palette of indexed images if present */
+	PixelLayout layout;					/*! Layout of the rows in the file */
+	uint32_t fileStride;				/*! Row size in bytes in the file */
+	uint32_t fileWidth;					/*! Image width in the file */
+	uint32_t fileHeight;				/*! Image height in the file */
+	uint32_t left;						/*! First column of the rows handed out */
+	uint32_t bottom;					/*! First (bottom-up) row of the rows handed out */
+	std::vector<uint8_t> levels;		/*! Gray level of every palette index of 1/4 bit images, if gray */
+	std::unique_ptr<RleDecoder> rle;	/*! Decoder of run length encoded rows, null otherwise */
+	std::vector<uint8_t> colors;		/*! Palette the 8 bit indices are expanded through into BGR24 rows, empty otherwise */
+};
+
+/*! Streamed output file whose rows are RLE8 encoded as they are written */
+struct RleStream {
+	const AtomicFileWriter *writer;		/*! Writer of the file */
+	uint32_t width;						/*! Width of the encoded rows */
+	uint32_t stride;					/*! Stride of the rows handed to writeRows() */
+	uint32_t dataOffset;				/*! File offset of the encoded pixels */
+	uint64_t bytes;						/*! Encoded bytes written so far */
+};
+
+/*! Neighbourhood filter of a gray plane: src, width, height, srcStride, dst, dstStride */
+typedef std::function<void(const uint8_t *, uint32_t, uint32_t, uint32_t, uint8_t *, uint32_t)> PlaneFilter;
+
 class BitmapHandler {
 
 	public:
@@ -79,7 +172,8 @@ class BitmapHandler {
 		virtual ~BitmapHandler();
 
 		/*!
-		 * @brief Retrieves the image header info.
+		 * @brief Retrieves the image header info. Headers are cached, the file is
+		 *        only read again once its size or modification time changes.
 		 * @param [string] - Filename of the image.
 		 * @return None
 		 */
@@ -89,38 +183,412 @@ class BitmapHandler {
 		 * @brief Retrieves the image header info.
 		 * @param [string] - Source file that needs to be converted into gray.
 		 * @param [string] - File name of the gray scale image to be saved.
+		 * @param [LumaWeights] - Weights of the color channels, plain average by default.
+		 * @param [ImageStats] - If given, receives the statistics of the gray image,
+		 *        counted while each converted row is still in cache.
 		 * @return [boolean] - Set if conversion done successfully otherwise reset.
 		 */
-		bool convert2Gray(const uint8_t *srcFile, const uint8_t *dstFile);
+		bool convert2Gray(const uint8_t *srcFile, const uint8_t *dstFile, const LumaWeights weights = LUMA_AVERAGE,
+			ImageStats *stats = 0);
 
 		/*!
-		 * @brief Rotates the image at given angles.
+		 * @brief Rotates the gray, 24 or 32 bit color image at given angles about its
+		 *        center. The output is sized to the bounding box of the rotated
+		 *        image. Right angles are lossless.
 		 * @param [string] - Source file that needs to be rotated.
 		 * @param [string] - File name to write the rotated image to.
 		 * @param [double] - Rotation angle in degrees.
+		 * @param [Interpolation] - Sampling of the source, bilinear by default.
 		 * @return [boolean] - Set if rotation is done successfully otherwise reset.
 		 */
-		bool rotateImage(const uint8_t *srcFile, const uint8_t *dstFile, double angle);
+		bool rotateImage(const uint8_t *srcFile, const uint8_t *dstFile, double angle, const Interpolation interp = INTERP_BILINEAR);
 
 		/*!
-		 * @brief Scales the images on x and y axis.
+		 * @brief Scales the gray, 24 or 32 bit color images on x and y axis.
 		 * @param [string] - Source file that needs to be scaled.
 		 * @param [string] - File name to write the scaled image to.
 		 * @param [double] - Value to scale along x axis.
 		 * @param [double] - Value to scale along y axis.
+		 * @param [ResampleFilter] - Resampling filter, bilinear by default.
 		 * @return [boolean] - Set if scaled is done successfully otherwise reset.
 		 */
-		bool scaleImage(const uint8_t *srcFile, const uint8_t *dstFile, double X, double Y);
+		bool scaleImage(const uint8_t *srcFile, const uint8_t *dstFile, double X, double Y, const ResampleFilter filter = FILTER_BILINEAR);
 
 		/*!
-		 * @brief Translate the image on x and y axis.
+		 * @brief Translate the gray, 24 or 32 bit color image on x and y axis.
 		 * @param [string] - Source file that needs to be translated.
 		 * @param [string] - File name to write the translated image to.
-		 * @param [int] - Value to translate along x axis.
-		 * @param [int] - Value to translate along y axis.
+		 * @param [int] - Value to translate along x axis, may be negative.
+		 * @param [int] - Value to translate along y axis, may be negative.
+		 * @param [int] - Value of the exposed border pixels.
+		 * @return [boolean] - Set if translation is done successfully otherwise reset.
+		 */
+		bool translatedImage(const uint8_t *srcFile, const uint8_t *dstFile, const int32_t X, const int32_t Y, const uint8_t fill = 0);
+
+		/*!
+		 * @brief Applies a sequence of rotations, scalings and translations in one
+		 *        pass. The steps are composed into a single affine mapping, so every
+		 *        output pixel is interpolated once from the source. Output sizes
+		 *        follow the individual operations.
+		 * @param [string] - Source file that needs to be transformed.
+		 * @param [string] - File name to write the transformed image to.
+		 * @param [GeometryStep] - Steps in the order they are applied.
+		 * @param [Interpolation] - Sampling of the source, bilinear by default.
+		 * @param [int] - Value of pixels mapping outside the source.
+		 * @return [boolean] - Set if transformation is done successfully otherwise reset.
+		 */
+		bool transformImage(const uint8_t *srcFile, const uint8_t *dstFile, const std::vector<GeometryStep> &steps,
+			const Interpolation interp = INTERP_BILINEAR, const uint8_t fill = 0);
+
+		/*!
+		 * @brief Maps every pixel of the gray image through a lookup table. Tone
+		 *        adjustments composed with PointLut::then() cost a single pass.
+		 * @param [string] - Source gray file.
+		 * @param [string] - File name to write the mapped image to.
+		 * @param [PointLut] - Table to be applied.
+		 * @return [boolean] - Set if mapping is done successfully otherwise reset.
+		 */
+		bool applyLut(const uint8_t *srcFile, const uint8_t *dstFile, const PointLut &lut);
+
+		/*!
+		 * @brief Equalizes the histogram of the gray image.
+		 * @param [string] - Source gray file.
+		 * @param [string] - File name to write the equalized image to.
+		 * @return [boolean] - Set if equalization is done successfully otherwise reset.
+		 */
+		bool equalizeImage(const uint8_t *srcFile, const uint8_t *dstFile);
+
+		/*!
+		 * @brief Separable gaussian blur of the gray image.
+		 * @param [string] - Source gray file.
+		 * @param [string] - File name to write the blurred image to.
+		 * @param [double] - Standard deviation in pixels, the kernel reaches 3 sigma.
+		 * @return [boolean] - Set if filtering is done successfully otherwise reset.
+		 */
+		bool gaussianBlur(const uint8_t *srcFile, const uint8_t *dstFile, const double sigma);
+
+		/*!
+		 * @brief Mean filter of the gray image, the cost does not grow with the radius.
+		 * @param [string] - Source gray file.
+		 * @param [string] - File name to write the blurred image to.
+		 * @param [int] - Radius of the (2r + 1) x (2r + 1) window.
+		 * @return [boolean] - Set if filtering is done successfully otherwise reset.
+		 */
+		bool boxBlur(const uint8_t *srcFile, const uint8_t *dstFile, const uint32_t radius);
+
+		/*!
+		 * @brief Median filter of the gray image.
+		 * @param [string] - Source gray file.
+		 * @param [string] - File name to write the filtered image to.
+		 * @param [int] - Radius of the (2r + 1) x (2r + 1) window.
+		 * @return [boolean] - Set if filtering is done successfully otherwise reset.
+		 */
+		bool medianFilter(const uint8_t *srcFile, const uint8_t *dstFile, const uint32_t radius);
+
+		/*!
+		 * @brief Gradient image of the gray image.
+		 * @param [string] - Source gray file.
+		 * @param [string] - File name to write the gradient image to.
+		 * @param [GradientOperator] - Sobel by default.
+		 * @param [GradientOutput] - Magnitude by default.
+		 * @return [boolean] - Set if filtering is done successfully otherwise reset.
+		 */
+		bool gradientImage(const uint8_t *srcFile, const uint8_t *dstFile, const GradientOperator op = GRADIENT_SOBEL,
+			const GradientOutput output = GRADIENT_MAGNITUDE);
+
+		/*!
+		 * @brief Convolves the gray image with a square kernel.
+		 * @param [string] - Source gray file.
+		 * @param [string] - File name to write the filtered image to.
+		 * @param [float] - Row major kernel, 1, 9, 25, ... up to 15 x 15 weights.
+		 * @param [int] - Value added to every result.
+		 * @return [boolean] - Set if filtering is done successfully otherwise reset.
+		 */
+		bool convolveImage(const uint8_t *srcFile, const uint8_t *dstFile, const std::vector<float> &kernel, const int32_t bias = 0);
+
+		/*!
+		 * @brief Calculates histogram, extrema, mean, variance of an 8 bit gray or a
+		 *        24/32 bit color image file, the row padding is not counted.
+		 * @param [string] - Source file.
+		 * @param [ImageStats] - Calculated statistics.
+		 * @return [boolean] - Set if the statistics are calculated otherwise reset.
+		 */
+		bool computeStats(const uint8_t *fileName, ImageStats &stats);
+
+		/*!
+		 * @brief Writes the 1/2, 1/4, ... reductions of an 8, 24 or 32 bit image file.
+		 *        The source is streamed through once, every level is reduced from
+		 *        the rows of the level above as they complete and written out in
+		 *        strips, so all levels take one pass and the memory of a few rows.
+		 * @param [string] - Source file.
+		 * @param [string] - File names of the levels, the first one is the 1/2 level.
+		 *        Levels past the one of a single pixel are not written.
+		 * @param [PyramidFilter] - Reduce kernel, 2x2 box by default.
+		 * @return [boolean] - Set if all levels are written successfully otherwise reset.
+		 */
+		bool buildPyramid(const uint8_t *srcFile, const std::vector<std::string> &dstFiles,
+			const PyramidFilter filter = PYRAMID_BOX);
+
+		/*!
+		 * @brief Loads the image file into an in-memory image. The file is memory
+		 *        mapped once and the pixel rows are a zero-copy read-only view of it.
+		 * @param [string] - Source file that needs to be loaded.
+		 * @param [BitmapImage] - Image to load the pixel data and palette into.
+		 * @return [boolean] - Set if loading is done successfully otherwise reset.
+		 */
+		bool loadImage(const uint8_t *fileName, BitmapImage &image);
+
+		/*!
+		 * @brief Loads an image from the contents of a file already read into memory,
+		 *        the pixel rows are a zero-copy view of the buffer which is kept alive
+		 *        by the image.
+		 * @param [PixelBuffer] - Whole file contents.
+		 * @param [BitmapImage] - Image to load the pixel data and palette into.
+		 * @return [boolean] - Set if loading is done successfully otherwise reset.
+		 */
+		bool loadImage(const std::shared_ptr<const PixelBuffer> &file, BitmapImage &image);
+
+		/*!
+		 * @brief Saves the in-memory image to a file.
+		 * @param [string] - File name to write the image to.
+		 * @param [BitmapImage] - Image to be written.
+		 * @return [boolean] - Set if saving is done successfully otherwise reset.
+		 */
+		bool saveImage(const uint8_t *fileName, const BitmapImage &image);
+
+		/*!
+		 * @brief Converts the in-memory color image into gray scale.
+		 * @param [BitmapImage] - Source color image.
+		 * @param [BitmapImage] - Destination gray image (may be the source itself).
+		 * @param [LumaWeights] - Weights of the color channels, plain average by default.
+		 * @param [ImageStats] - If given, receives the statistics of the gray image.
+		 * @return [boolean] - Set if conversion done successfully otherwise reset.
+		 */
+		bool convert2Gray(const BitmapImage &src, BitmapImage &dst, const LumaWeights weights = LUMA_AVERAGE,
+			ImageStats *stats = 0);
+
+		/*!
+		 * @brief Rotates the in-memory image at given angles. Right angles move
+		 *        whole pixels through a blocked transpose, other angles sample color
+		 *        pixels with one source position for all three channels.
+		 * @param [BitmapImage] - Source gray, 24 or 32 bit color image.
+		 * @param [BitmapImage] - Destination image (may be the source itself).
+		 * @param [double] - Rotation angle in degrees.
+		 * @param [Interpolation] - Sampling of the source, bilinear by default.
+		 * @return [boolean] - Set if rotation is done successfully otherwise reset.
+		 */
+		bool rotateImage(const BitmapImage &src, BitmapImage &dst, double angle, const Interpolation interp = INTERP_BILINEAR);
+
+		/*!
+		 * @brief Scales the in-memory image on x and y axis, color images plane by plane.
+		 * @param [BitmapImage] - Source gray, 24 or 32 bit color image.
+		 * @param [BitmapImage] - Destination image (may be the source itself).
+		 * @param [double] - Value to scale along x axis.
+		 * @param [double] - Value to scale along y axis.
+		 * @param [ResampleFilter] - Resampling filter, bilinear by default. FILTER_AREA
+		 *        averages the covered source pixels and suits large downscales.
+		 * @return [boolean] - Set if scaled is done successfully otherwise reset.
+		 */
+		bool scaleImage(const BitmapImage &src, BitmapImage &dst, double X, double Y, const ResampleFilter filter = FILTER_BILINEAR);
+
+		/*!
+		 * @brief Translate the in-memory image on x and y axis. Color rows are moved
+		 *        as they are, the fill value is used for every channel.
+		 * @param [BitmapImage] - Source gray, 24 or 32 bit color image.
+		 * @param [BitmapImage] - Destination image, passing the source itself translates
+		 *        in place without a second buffer.
+		 * @param [int] - Value to translate along x axis, may be negative.
+		 * @param [int] - Value to translate along y axis, may be negative.
+		 * @param [int] - Value of the exposed border pixels.
 		 * @return [boolean] - Set if translation is done successfully otherwise reset.
 		 */
-		bool translatedImage(const uint8_t *srcFile, const uint8_t *dstFile, const uint32_t X, const uint32_t Y);
+		bool translatedImage(const BitmapImage &src, BitmapImage &dst, const int32_t X, const int32_t Y, const uint8_t fill = 0);
+
+		/*!
+		 * @brief Applies a sequence of geometry steps to the in-memory image in one pass.
+		 * @param [BitmapImage] - Source gray, 24 or 32 bit color image.
+		 * @param [BitmapImage] - Destination image (may be the source itself).
+		 * @param [GeometryStep] - Steps in the order they are applied.
+		 * @param [Interpolation] - Sampling of the source, bilinear by default.
+		 * @param [int] - Value of pixels mapping outside the source.
+		 * @return [boolean] - Set if transformation is done successfully otherwise reset.
+		 */
+		bool transformImage(const BitmapImage &src, BitmapImage &dst, const std::vector<GeometryStep> &steps,
+			const Interpolation interp = INTERP_BILINEAR, const uint8_t fill = 0);
+
+		/*!
+		 * @brief Maps every pixel of the in-memory gray image through a lookup table.
+		 * @param [BitmapImage] - Source gray image.
+		 * @param [BitmapImage] - Destination image, passing the source itself maps
+		 *        in place without a second buffer.
+		 * @param [PointLut] - Table to be applied.
+		 * @return [boolean] - Set if mapping is done successfully otherwise reset.
+		 */
+		bool applyLut(const BitmapImage &src, BitmapImage &dst, const PointLut &lut);
+
+		/*!
+		 * @brief Equalizes the histogram of the in-memory gray image.
+		 * @param [BitmapImage] - Source gray image.
+		 * @param [BitmapImage] - Destination image (may be the source itself).
+		 * @return [boolean] - Set if equalization is done successfully otherwise reset.
+		 */
+		bool equalizeImage(const BitmapImage &src, BitmapImage &dst);
+
+		/*!
+		 * @brief Gaussian blur of the in-memory gray image.
+		 * @param [BitmapImage] - Source gray image.
+		 * @param [BitmapImage] - Destination image (may be the source itself).
+		 * @param [double] - Standard deviation in pixels.
+		 * @return [boolean] - Set if filtering is done successfully otherwise reset.
+		 */
+		bool gaussianBlur(const BitmapImage &src, BitmapImage &dst, const double sigma);
+
+		/*!
+		 * @brief Mean filter of the in-memory gray image.
+		 * @param [BitmapImage] - Source gray image.
+		 * @param [BitmapImage] - Destination image (may be the source itself).
+		 * @param [int] - Radius of the window.
+		 * @return [boolean] - Set if filtering is done successfully otherwise reset.
+		 */
+		bool boxBlur(const BitmapImage &src, BitmapImage &dst, const uint32_t radius);
+
+		/*!
+		 * @brief Median filter of the in-memory gray image.
+		 * @param [BitmapImage] - Source gray image.
+		 * @param [BitmapImage] - Destination image (may be the source itself).
+		 * @param [int] - Radius of the window.
+		 * @return [boolean] - Set if filtering is done successfully otherwise reset.
+		 */
+		bool medianFilter(const BitmapImage &src, BitmapImage &dst, const uint32_t radius);
+
+		/*!
+		 * @brief Gradient image of the in-memory gray image.
+		 * @param [BitmapImage] - Source gray image.
+		 * @param [BitmapImage] - Destination image (may be the source itself).
+		 * @param [GradientOperator] - Sobel by default.
+		 * @param [GradientOutput] - Magnitude by default.
+		 * @return [boolean] - Set if filtering is done successfully otherwise reset.
+		 */
+		bool gradientImage(const BitmapImage &src, BitmapImage &dst, const GradientOperator op = GRADIENT_SOBEL,
+			const GradientOutput output = GRADIENT_MAGNITUDE);
+
+		/*!
+		 * @brief Convolves the in-memory gray image with a square kernel.
+		 * @param [BitmapImage] - Source gray image.
+		 * @param [BitmapImage] - Destination image (may be the source itself).
+		 * @param [float] - Row major kernel, 1, 9, 25, ... up to 15 x 15 weights.
+		 * @param [int] - Value added to every result.
+		 * @return [boolean] - Set if filtering is done successfully otherwise reset.
+		 */
+		bool convolveImage(const BitmapImage &src, BitmapImage &dst, const std::vector<float> &kernel, const int32_t bias = 0);
+
+		/*!
+		 * @brief Calculates the statistics of the in-memory image in parallel row bands.
+		 * @param [BitmapImage] - Gray or color image.
+		 * @param [ImageStats] - Calculated statistics.
+		 * @return [boolean] - Set if the statistics are calculated otherwise reset.
+		 */
+		bool computeStats(const BitmapImage &image, ImageStats &stats);
+
+		/*!
+		 * @brief Builds the 1/2, 1/4, ... reductions of the in-memory image in one pass
+		 *        over its rows, see buildPyramid() of files.
+		 * @param [BitmapImage] - Source 8, 24 or 32 bit image.
+		 * @param [BitmapImage] - Receives the levels, the 1/2 level first.
+		 * @param [int] - Number of levels, fewer once a level is a single pixel.
+		 * @param [PyramidFilter] - Reduce kernel, 2x2 box by default.
+		 * @return [boolean] - Set if the levels are built successfully otherwise reset.
+		 */
+		bool buildPyramid(const BitmapImage &src, std::vector<BitmapImage> &levels, const uint32_t count,
+			const PyramidFilter filter = PYRAMID_BOX);
+
+		/*!
+		 * @brief Sets the number of threads used by all operations of the library.
+		 *        Must not be called while an operation is running.
+		 * @param [int] - Number of threads, 0 for one per core.
+		 * @return None
+		 */
+		static void setThreadCount(const uint32_t threads);
+
+		/*!
+		 * @brief Returns the number of threads used by the operations.
+		 * @param None
+		 * @return [int] - Number of threads.
+		 */
+		static uint32_t getThreadCount(void);
+
+		/*!
+		 * @brief Limits the memory of idle pixel buffers kept for reuse by the
+		 *        operations, 0 frees them all and disables reuse.
+		 * @param [int] - Most idle bytes kept.
+		 * @return None
+		 */
+		static void setBufferCacheLimit(const size_t bytes);
+
+		/*!
+		 * @brief Sets the strip height of the file based operations. With a non-zero
+		 *        height images are streamed through in strips of about that many rows
+		 *        instead of being loaded whole, bounding the peak memory.
+		 * @param [int] - Rows per strip, 0 to process whole images (default).
+		 * @return None
+		 */
+		inline void setStripRows(const uint32_t rows) { stripRows = rows; }
+
+		/*!
+		 * @brief Returns the strip height of the file based operations.
+		 * @param None
+		 * @return [int] - Rows per strip, 0 when whole images are processed.
+		 */
+		inline uint32_t getStripRows(void) const { return stripRows; }
+
+		/*!
+		 * @brief Enables the tracing of the operations. Each call then records the
+		 *        wall time of its stages, the bytes read and written and the buffers
+		 *        it took, readable with getLastTrace() afterwards. Disabled tracing
+		 *        costs one pointer check per stage.
+		 * @param [boolean] - Set to trace the calls, reset to stop (default).
+		 * @return None
+		 */
+		inline void setTracing(const bool enable) { tracing = enable; }
+		inline bool isTracing(void) const { return tracing; }
+
+		/*!
+		 * @brief Returns the trace of the last call made while tracing was enabled.
+		 * @param None
+		 * @return [OperationTrace] - Timings and counters of the call.
+		 */
+		inline const OperationTrace &getLastTrace(void) const { return trace; }
+
+		/*!
+		 * @brief Appends the trace of every traced call to the file as a JSON line.
+		 *        The file may be shared by several handlers.
+		 * @param [FILE] - Open output file, null to stop writing (default).
+		 * @return None
+		 */
+		inline void setTraceOutput(FILE *file) { traceOutput = file; }
+
+		/*!
+		 * @brief Enables RLE8 encoding of the 8 bit images written, whole or
+		 *        streamed. Whole images that would not shrink stay uncompressed.
+		 *        Run length encoded images are always read.
+		 * @param [boolean] - Set to encode, reset to write uncompressed (default).
+		 * @return None
+		 */
+		inline void setRunLengthOutput(const bool enable) { rleOutput = enable; }
+		inline bool isRunLengthOutput(void) const { return rleOutput; }
+
+		/*!
+		 * @brief Limits the file based operations to a window of their source, as if
+		 *        the window was the whole image. Only the rows of the window are read
+		 *        or mapped, windows of uncompressed 8/24/32 bit rows are loaded as a
+		 *        zero-copy view striding over the file rows.
+		 * @param [ImageRect] - Window from the top-left corner, clipped to every
+		 *        source, an empty window for the whole image (default).
+		 * @return None
+		 */
+		inline void setRegion(const ImageRect &rect) { region = rect; }
+		inline const ImageRect &getRegion(void) const { return region; }
+		inline bool hasRegion(void) const { return region.width && region.height; }
 
 		//GETTERS
 
@@ -141,6 +609,8 @@ class BitmapHandler {
 		inline uint32_t getVerPixPerMeter(void) const { return BMP_IH.vPixPM; }
 		inline uint32_t getColorUsed(void) const { return BMP_IH.colorUsed; }
 		inline uint32_t getImpColorUsed(void) const { return BMP_IH.impColorUsed; }
+		inline bool isTopDown(void) const { return layout.topDown; }
+		inline const PixelLayout &getPixelLayout(void) const { return layout; }
 
 		//SETTERS
 
@@ -172,21 +642,239 @@ class BitmapHandler {
 		void readImage(const uint8_t *fileName, const uint32_t offset, uint8_t *buffer, const uint32_t size);
 
 		/*!
-		 * @brief Reads the given image file into the data buffer.
-		 * @param [string] - Source file that needs to be read.
-		 * @param [int] - Offset cursor location if needed.
-		 * @param [string] - Raw data buffer.
-		 * @param [int] - Size of the data to be read.
+		 * @brief Writes the given buffers as the complete image file. Data is gathered
+		 *        into a temporary file and renamed into place, replacing any old file.
+		 * @param [string] - File name to write the image to.
+		 * @param [IoBuffer] - Header, palette and pixel buffers in file order.
+		 * @param [int] - Number of buffers.
+		 * @return [boolean] - Set if writing is done successfully otherwise reset.
+		 */
+		bool writeImage(const uint8_t *fileName, const IoBuffer *buffers, const uint32_t count);
+
+		/*!
+		 * @brief Parses the header of a whole file in memory and loads its pixels.
+		 * @param [string] - File contents.
+		 * @param [int] - Size of the contents in bytes.
+		 * @param [shared_ptr] - Owner keeping the contents alive for a zero-copy view.
+		 * @param [BitmapImage] - Image to load the pixel data and palette into.
+		 * @return [boolean] - Set if loading is done successfully otherwise reset.
+		 */
+		bool decodeImage(const uint8_t *data, const uint64_t size, const std::shared_ptr<const void> &owner,
+			BitmapImage &image);
+
+		/*!
+		 * @brief Writes buffers of a streamed output file, traced as writing. After
+		 *        the header the rows are RLE8 encoded if beginStream() chose it.
+		 * @param [AtomicFileWriter] - Open writer.
+		 * @param [IoBuffer] - Buffers in file order.
+		 * @param [int] - Number of buffers.
+		 * @return [boolean] - Set if writing is done successfully otherwise reset.
+		 */
+		bool writeRows(AtomicFileWriter &writer, const IoBuffer *buffers, const uint32_t count);
+
+		/*!
+		 * @brief Completes a streamed output file, traced as writing. Encoded files
+		 *        get their end of bitmap code and their sizes in the header.
+		 * @param [AtomicFileWriter] - Open writer.
+		 * @return [boolean] - Set if the file is in place otherwise reset.
+		 */
+		bool commitRows(AtomicFileWriter &writer);
+
+		/*!
+		 * @brief Prints an error and keeps it in the trace of the current call.
+		 * @param [string] - Error message.
 		 * @return None
 		 */
-		void writeImage(const uint8_t *fileName, uint8_t *data, const uint32_t size);
+		void reportError(const std::string &message);
 
 		/*!
-		 * @brief Extracts header info to data structure.
+		 * @brief Starts the trace of a call when tracing is enabled and no call
+		 *        is traced yet, calls made by a traced call add to its trace.
+		 * @param [string] - Name of the operation.
+		 * @param [string] - File the call works on, may be null.
+		 * @return [boolean] - Set if the trace is started otherwise reset.
+		 */
+		bool beginTrace(const char *operation, const uint8_t *fileName);
+
+		/*!
+		 * @brief Completes the trace started by beginTrace() and writes it out.
+		 * @param [boolean] - Result of the call.
+		 * @return None
+		 */
+		void endTrace(const bool result);
+
+		/*!
+		 * @brief Checks the extracted header describes an image the library supports.
+		 * @param [int] - Size of the whole file in bytes.
+		 * @return [boolean] - Set if the image is supported otherwise reset.
+		 */
+		bool validateHeader(const uint64_t fileSize);
+
+		/*!
+		 * @brief Returns the size of the pixel data stored in the file, the encoded
+		 *        size of run length encoded images.
+		 * @param [int] - Size of the whole file in bytes.
+		 * @return [int] - Size in bytes.
+		 */
+		uint64_t pixelDataSize(const uint64_t fileSize) const;
+
+		/*!
+		 * @brief Fills the header fields and raw header data of an image to be written.
+		 * @param [string] - Raw header data of HEADER_SIZE bytes.
+		 * @param [int] - Image width.
+		 * @param [int] - Image height.
+		 * @param [int] - Bits per pixel.
+		 * @param [int] - Horizontal resolution.
+		 * @param [int] - Vertical resolution.
+		 * @param [int] - Compression type, COMPRESSION_RGB or COMPRESSION_RLE8.
+		 * @param [int] - Size of the encoded pixels, if known.
+		 * @return [int] - Size of the palette following the header.
+		 */
+		uint32_t createHeader(uint8_t *rawData, const uint32_t width, const uint32_t height, const uint16_t bpp,
+			const uint32_t hpm, const uint32_t vpm, const uint32_t compression = COMPRESSION_RGB,
+			const uint32_t encodedSize = 0);
+
+		/*!
+		 * @brief Opens the image file for strip streaming and reads its header and palette.
+		 * @param [string] - Source file to be streamed.
+		 * @param [StripSource] - Source to be opened.
+		 * @return [boolean] - Set if the image is opened successfully otherwise reset.
+		 */
+		bool openStream(const uint8_t *fileName, StripSource &source);
+
+		/*!
+		 * @brief Reads consecutive pixel rows of the streamed source, rows of other
+		 *        layouts than the working one are unpacked and top-down rows flipped.
+		 * @param [StripSource] - Opened source.
+		 * @param [int] - First (bottom-up) row.
+		 * @param [int] - Number of rows.
+		 * @param [string] - Buffer of 'count' rows of the source stride.
+		 * @return [boolean] - Set if reading is done successfully otherwise reset.
+		 */
+		bool readRows(const StripSource &source, const uint32_t first, const uint32_t count, uint8_t *buffer);
+
+		/*!
+		 * @brief Starts the streamed output file by writing its header and palette.
+		 * @param [string] - File name to write the image to.
+		 * @param [AtomicFileWriter] - Writer receiving the pixel strips afterwards.
+		 * @param [StripSource] - Source providing resolution and palette.
+		 * @param [int] - Output width.
+		 * @param [int] - Output height.
+		 * @param [int] - Output bits per pixel.
+		 * @return [boolean] - Set if the header is written successfully otherwise reset.
+		 */
+		bool beginStream(const uint8_t *fileName, AtomicFileWriter &writer, const StripSource &source,
+			const uint32_t width, const uint32_t height, const uint16_t bpp);
+
+		/*!
+		 * @brief Streaming versions of the file based operations, see setStripRows().
+		 */
+		bool convert2GrayStream(const uint8_t *srcFile, const uint8_t *dstFile, const LumaWeights weights, ImageStats *stats);
+		bool rotateStream(const uint8_t *srcFile, const uint8_t *dstFile, const double angle, const Interpolation interp);
+		bool scaleStream(const uint8_t *srcFile, const uint8_t *dstFile, double X, double Y, const ResampleFilter filter);
+		bool translateStream(const uint8_t *srcFile, const uint8_t *dstFile, const int32_t X, const int32_t Y, const uint8_t fill);
+		bool transformStream(const uint8_t *srcFile, const uint8_t *dstFile, const std::vector<GeometryStep> &steps,
+			const Interpolation interp, const uint8_t fill);
+		bool lutStream(const uint8_t *srcFile, const uint8_t *dstFile, const PointLut &lut);
+		bool equalizeStream(const uint8_t *srcFile, const uint8_t *dstFile);
+		bool statsStream(const uint8_t *fileName, ImageStats &stats);
+
+		/*!
+		 * @brief Runs a neighbourhood filter on the in-memory gray image.
+		 * @param [string] - Name of the operation for the trace.
+		 * @param [BitmapImage] - Source gray image.
+		 * @param [BitmapImage] - Destination image (may be the source itself).
+		 * @param [PlaneFilter] - Filter writing a plane of the same size.
+		 * @return [boolean] - Set if filtering is done successfully otherwise reset.
+		 */
+		bool filterImage(const char *operation, const BitmapImage &src, BitmapImage &dst, const PlaneFilter &filter);
+
+		/*!
+		 * @brief Runs a neighbourhood filter on the gray file, in memory or in strips.
+		 *        Strips are read with 'radius' extra rows on both sides, so the
+		 *        output equals the one of the whole image.
+		 * @param [string] - Name of the operation for the trace.
+		 * @param [string] - Source gray file.
+		 * @param [string] - File name to write the filtered image to.
+		 * @param [int] - Rows of the source a filtered row depends on, on each side.
+		 * @param [PlaneFilter] - Filter writing a plane of the same size.
+		 * @return [boolean] - Set if filtering is done successfully otherwise reset.
+		 */
+		bool filterFile(const char *operation, const uint8_t *srcFile, const uint8_t *dstFile, const uint32_t radius,
+			const PlaneFilter &filter);
+
+		/*!
+		 * @brief Streams the output of an inverse mapping in strips, every strip is
+		 *        split into column tiles whose source rows fit the strip height.
+		 * @param [StripSource] - Opened gray, 24 or 32 bit color source.
+		 * @param [AtomicFileWriter] - Writer of the output file.
+		 * @param [int] - Output width.
+		 * @param [int] - Output height.
+		 * @param [AffineMatrix] - Output to source mapping.
+		 * @param [Interpolation] - Sampling of the source.
+		 * @param [int] - Value of pixels mapping outside the source.
+		 * @return [boolean] - Set if all strips are written successfully otherwise reset.
+		 */
+		bool warpStrips(const StripSource &source, AtomicFileWriter &writer, const uint32_t dstWidth, const uint32_t dstHeight,
+			const AffineMatrix &inverse, const Interpolation interp, const uint8_t fill);
+
+		/*!
+		 * @brief Calculates the bounding box and the inverse mapping of a rotation
+		 *        about the image center.
+		 * @param [int] - Source width.
+		 * @param [int] - Source height.
+		 * @param [double] - Rotation angle in degrees.
+		 * @param [int] - Width of the rotated image.
+		 * @param [int] - Height of the rotated image.
+		 * @param [AffineMatrix] - Output to source mapping.
+		 * @return None
+		 */
+		void rotationGeometry(const uint32_t width, const uint32_t height, double angle,
+			uint32_t &rWidth, uint32_t &rHeight, AffineMatrix &inverse) const;
+
+		/*!
+		 * @brief Calculates the output size and the composed inverse mapping of a
+		 *        sequence of geometry steps.
+		 * @param [int] - Source width.
+		 * @param [int] - Source height.
+		 * @param [GeometryStep] - Steps in the order they are applied.
+		 * @param [int] - Width of the transformed image.
+		 * @param [int] - Height of the transformed image.
+		 * @param [AffineMatrix] - Output to source mapping.
+		 * @return None
+		 */
+		void transformGeometry(const uint32_t width, const uint32_t height, const std::vector<GeometryStep> &steps,
+			uint32_t &tWidth, uint32_t &tHeight, AffineMatrix &inverse) const;
+
+		/*!
+		 * @brief Extracts header info to data structure. Top-down images get their
+		 *        height made positive, the pixel layout follows the header.
 		 * @param [string] - Raw data for information extraction.
+		 * @param [int] - Bytes available, channel masks are read when present.
+		 * @return None
+		 */
+		void extractInfo(const uint8_t *data, const uint64_t size);
+
+		/*!
+		 * @brief Locates the palette of an indexed image in the file.
+		 * @param [int] - File offset of the palette.
+		 * @param [int] - Size of the palette in bytes, 0 if there is none.
 		 * @return None
 		 */
-		void extractInfo(const uint8_t *data);
+		void paletteLocation(uint64_t &offset, uint32_t &size) const;
+
+		/*!
+		 * @brief Pads the palette read from the file to 256 entries. The gray palette
+		 *        of a 1/4 bit image is turned into levels the rows are unpacked to,
+		 *        the image then gets the identity gray palette.
+		 * @param [string] - Palette entries read from the file.
+		 * @param [int] - Size of the entries in bytes.
+		 * @param [string] - Receives the palette of PALETTE_SIZE bytes.
+		 * @param [string] - Receives the levels or is emptied.
+		 * @return None
+		 */
+		void preparePalette(const uint8_t *entries, const uint32_t size, std::vector<uint8_t> &imagePalette,
+			std::vector<uint8_t> &levels) const;
 
 		/*!
 		 * @brief Create color palette for gray scale images.
@@ -195,6 +883,14 @@ class BitmapHandler {
 		 */
 		void createPalette(void);
 
+		/*!
+		 * @brief Copies resolution and palette of the source into a new image.
+		 * @param [BitmapImage] - Source image.
+		 * @param [BitmapImage] - Destination image.
+		 * @return None
+		 */
+		void copyAttributes(const BitmapImage &src, BitmapImage &dst) const;
+
 		/*!
 		 * @brief Converts the given angle in radian into degrees
 		 * @param [double] - Angle in radians
@@ -210,11 +906,25 @@ class BitmapHandler {
 		inline double toRadians(const double deg) const { return deg * M_PI / 180.0; }
 
 	private:
+		friend class TraceScope;
+
 		std::ifstream rimage;
-		std::ofstream wimage;
 
 		bool imageFound;
+		uint32_t stripRows;
 		uint8_t palette[PALETTE_SIZE];
+		PixelLayout layout;
+
+		bool rleOutput;
+		std::vector<RleStream> rleStreams;		/*! Open streamed outputs whose rows are encoded */
+		ImageRect region;						/*! Window of the sources, empty for whole images */
+
+		bool tracing;
+		OperationTrace trace;					/*! Trace of the last traced call */
+		OperationTrace *activeTrace;			/*! 'trace' while a call is traced, otherwise null */
+		PoolCounters poolCounters;				/*! Buffers taken by the traced call */
+		std::chrono::steady_clock::time_point traceStart;
+		FILE *traceOutput;
 
 		/*! Struct for BMP File Header */
 		struct {
@@ -230,7 +940,7 @@ class BitmapHandler {
 			uint32_t imageWidth;            /*! Image width */
 			uint32_t imageHeight;           /*! Image height */
 			uint16_t colorPlane;            /*! Color plane: 1/0*/
-			uint16_t bitsPerPixel;          /*! Bits per pixel: 8/16/24 */
+			uint16_t bitsPerPixel;          /*! Bits per pixel: 1/4/8/16/24/32 */
 			uint32_t compressionType;       /*! Compression type: 0 None */
 			uint32_t imageSize;             /*! Image size */
 			uint32_t hPixPM;                /*! Horizontal resolution */
@@ -0,0 +1,414 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.3
+ *          - 1.0.0 - Added memory mapped file reader.
+ *          - 1.0.1 - Added atomic gather writer.
+ *          - 1.0.2 - Added positional reader and streaming atomic writer.
+ *          - 1.0.3 - Added rewriting of written bytes.
+ *
+ * @desc Platform file I/O helpers used by the BitmapHandler library.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include "BitmapIO.h"
+
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+
+#include <atomic>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#endif
+
+static std::atomic<uint32_t> tempCounter(0);
+
+/*!
+ * @brief Creates a unique temporary name next to the destination file.
+ * @param [string] - Destination file name.
+ * @return [string] - Temporary file name.
+ */
+static std::string tempFileName(const char *fileName) {
+	char suffix[48];
+#ifdef _WIN32
+	unsigned long pid = (unsigned long)GetCurrentProcessId();
+#else
+	unsigned long pid = (unsigned long)getpid();
+#endif
+	snprintf(suffix, sizeof(suffix), ".%lu.%u.tmp", pid, (unsigned)tempCounter++);
+	return std::string(fileName) + suffix;
+}
+
+bool writeFileAtomic(const char *fileName, const IoBuffer *buffers, const uint32_t count) {
+	AtomicFileWriter writer;
+	if(!writer.open(fileName)) { return false; }
+	if(!writer.write(buffers, count)) { return false; }
+	return writer.commit();
+}
+
+MappedFile::MappedFile() {
+	data = 0;
+	size = 0;
+#ifdef _WIN32
+	fileHandle = INVALID_HANDLE_VALUE;
+	mapHandle = 0;
+#endif
+}
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+FileReader::FileReader() {
+	size = 0;
+#ifdef _WIN32
+	fileHandle = INVALID_HANDLE_VALUE;
+#else
+	fd = -1;
+#endif
+}
+
+FileReader::~FileReader() {
+	close();
+}
+
+AtomicFileWriter::AtomicFileWriter() {
+	failed = false;
+#ifdef _WIN32
+	fileHandle = INVALID_HANDLE_VALUE;
+#else
+	fd = -1;
+#endif
+}
+
+AtomicFileWriter::~AtomicFileWriter() {
+	abort();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const char *fileName, const bool sequential) {
+	close();
+
+	DWORD flags = FILE_ATTRIBUTE_NORMAL | (sequential ? FILE_FLAG_SEQUENTIAL_SCAN : 0);
+	fileHandle = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, flags, 0);
+	if(fileHandle == INVALID_HANDLE_VALUE) { return false; }
+
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) { close(); return false; }
+
+	mapHandle = CreateFileMappingA(fileHandle, 0, PAGE_READONLY, 0, 0, 0);
+	if(mapHandle == 0) { close(); return false; }
+
+	data = (const uint8_t *)MapViewOfFile(mapHandle, FILE_MAP_READ, 0, 0, 0);
+	if(data == 0) { close(); return false; }
+
+	size = (uint64_t)fileSize.QuadPart;
+	return true;
+}
+
+void MappedFile::close(void) {
+	if(data) { UnmapViewOfFile(data); }
+	if(mapHandle) { CloseHandle(mapHandle); }
+	if(fileHandle != INVALID_HANDLE_VALUE) { CloseHandle(fileHandle); }
+
+	data = 0;
+	size = 0;
+	mapHandle = 0;
+	fileHandle = INVALID_HANDLE_VALUE;
+}
+
+bool FileReader::open(const char *fileName) {
+	close();
+
+	fileHandle = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if(fileHandle == INVALID_HANDLE_VALUE) { return false; }
+
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(fileHandle, &fileSize)) { close(); return false; }
+
+	size = (uint64_t)fileSize.QuadPart;
+	return true;
+}
+
+bool FileReader::read(const uint64_t offset, void *buffer, const size_t size) const {
+	uint8_t *data = (uint8_t *)buffer;
+	uint64_t position = offset;
+	size_t remaining = size;
+
+	while(remaining > 0) {
+		OVERLAPPED ov;
+		memset(&ov, 0, sizeof(ov));
+		ov.Offset = (DWORD)position;
+		ov.OffsetHigh = (DWORD)(position >> 32);
+
+		DWORD chunk = (DWORD)(remaining > 0x40000000 ? 0x40000000 : remaining);
+		DWORD done = 0;
+		if(!ReadFile(fileHandle, data, chunk, &done, &ov) || done == 0) { return false; }
+
+		data += done;
+		position += done;
+		remaining -= done;
+	}
+	return true;
+}
+
+void FileReader::close(void) {
+	if(fileHandle != INVALID_HANDLE_VALUE) { CloseHandle(fileHandle); }
+	fileHandle = INVALID_HANDLE_VALUE;
+	size = 0;
+}
+
+bool AtomicFileWriter::open(const char *fileName) {
+	abort();
+
+	this->fileName = fileName;
+	tempName = tempFileName(fileName);
+	failed = false;
+
+	fileHandle = CreateFileA(tempName.c_str(), GENERIC_WRITE, 0, 0, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, 0);
+	return fileHandle != INVALID_HANDLE_VALUE;
+}
+
+bool AtomicFileWriter::write(const IoBuffer *buffers, const uint32_t count) {
+	if(fileHandle == INVALID_HANDLE_VALUE || failed) { return false; }
+
+	//WriteFileGather needs unbuffered page aligned buffers, so each buffer is written in turn.
+	for(uint32_t i = 0; i < count; i++) {
+		const uint8_t *data = (const uint8_t *)buffers[i].data;
+		size_t remaining = buffers[i].size;
+		while(remaining > 0) {
+			DWORD chunk = (DWORD)(remaining > 0x40000000 ? 0x40000000 : remaining);
+			DWORD written = 0;
+			if(!WriteFile(fileHandle, data, chunk, &written, 0) || written == 0) { failed = true; return false; }
+			data += written;
+			remaining -= written;
+		}
+	}
+	return true;
+}
+
+bool AtomicFileWriter::rewrite(const uint64_t offset, const void *data, const size_t size) {
+	if(fileHandle == INVALID_HANDLE_VALUE || failed) { return false; }
+
+	OVERLAPPED ov;
+	memset(&ov, 0, sizeof(ov));
+	ov.Offset = (DWORD)offset;
+	ov.OffsetHigh = (DWORD)(offset >> 32);
+
+	//Writing at an offset moves the file pointer, it is put back to the end for the next append.
+	DWORD written = 0;
+	LARGE_INTEGER zero;
+	zero.QuadPart = 0;
+	if(!WriteFile(fileHandle, data, (DWORD)size, &written, &ov) || written != size ||
+		!SetFilePointerEx(fileHandle, zero, 0, FILE_END)) {
+		failed = true;
+		return false;
+	}
+	return true;
+}
+
+bool AtomicFileWriter::commit(void) {
+	if(fileHandle == INVALID_HANDLE_VALUE) { return false; }
+
+	CloseHandle(fileHandle);
+	fileHandle = INVALID_HANDLE_VALUE;
+
+	bool result = !failed && MoveFileExA(tempName.c_str(), fileName.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+	if(!result) { DeleteFileA(tempName.c_str()); }
+	tempName.clear();
+	return result;
+}
+
+void AtomicFileWriter::abort(void) {
+	if(fileHandle != INVALID_HANDLE_VALUE) {
+		CloseHandle(fileHandle);
+		DeleteFileA(tempName.c_str());
+	}
+	fileHandle = INVALID_HANDLE_VALUE;
+	tempName.clear();
+}
+
+#else
+
+bool MappedFile::open(const char *fileName, const bool sequential) {
+	close();
+
+	int fd = ::open(fileName, O_RDONLY);
+	if(fd < 0) { return false; }
+
+	struct stat st;
+	if(fstat(fd, &st) != 0 || st.st_size == 0) { ::close(fd); return false; }
+
+	void *addr = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);													//Mapping stays valid after close.
+	if(addr == MAP_FAILED) { return false; }
+
+	if(sequential) { madvise(addr, (size_t)st.st_size, MADV_SEQUENTIAL); }
+
+	data = (const uint8_t *)addr;
+	size = (uint64_t)st.st_size;
+	return true;
+}
+
+void MappedFile::close(void) {
+	if(data) { munmap((void *)data, (size_t)size); }
+
+	data = 0;
+	size = 0;
+}
+
+bool FileReader::open(const char *fileName) {
+	close();
+
+	fd = ::open(fileName, O_RDONLY);
+	if(fd < 0) { return false; }
+
+	struct stat st;
+	if(fstat(fd, &st) != 0) { close(); return false; }
+
+	size = (uint64_t)st.st_size;
+	return true;
+}
+
+bool FileReader::read(const uint64_t offset, void *buffer, const size_t size) const {
+	uint8_t *data = (uint8_t *)buffer;
+	uint64_t position = offset;
+	size_t remaining = size;
+
+	while(remaining > 0) {
+		ssize_t done = pread(fd, data, remaining, (off_t)position);
+		if(done < 0 && errno == EINTR) { continue; }
+		if(done <= 0) { return false; }
+
+		data += done;
+		position += (uint64_t)done;
+		remaining -= (size_t)done;
+	}
+	return true;
+}
+
+void FileReader::close(void) {
+	if(fd >= 0) { ::close(fd); }
+	fd = -1;
+	size = 0;
+}
+
+bool AtomicFileWriter::open(const char *fileName) {
+	abort();
+
+	this->fileName = fileName;
+	tempName = tempFileName(fileName);
+	failed = false;
+
+	fd = ::open(tempName.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+	return fd >= 0;
+}
+
+bool AtomicFileWriter::write(const IoBuffer *buffers, const uint32_t count) {
+	if(fd < 0 || failed) { return false; }
+
+	struct iovec iov[16];
+	uint32_t first = 0;
+
+	//Gather writing all the buffers, a short write resumes where it stopped.
+	while(first < count) {
+		int n = 0;
+		for(uint32_t i = first; i < count && n < (int)(sizeof(iov) / sizeof(iov[0])); i++) {
+			if(buffers[i].size == 0) { continue; }
+			iov[n].iov_base = (void *)buffers[i].data;
+			iov[n].iov_len = buffers[i].size;
+			n++;
+		}
+		if(n == 0) { break; }
+
+		ssize_t written = writev(fd, iov, n);
+		if(written < 0) {
+			if(errno == EINTR) { continue; }
+			failed = true;
+			return false;
+		}
+
+		//Skipping completely written buffers and finishing a partially written one.
+		size_t done = (size_t)written;
+		while(first < count && done >= buffers[first].size) { done -= buffers[first++].size; }
+		if(done > 0) {
+			size_t size = buffers[first].size - done;
+			const uint8_t *data = (const uint8_t *)buffers[first].data + done;
+			while(size > 0) {
+				ssize_t w = ::write(fd, data, size);
+				if(w < 0 && errno == EINTR) { continue; }
+				if(w <= 0) { failed = true; return false; }
+				data += w;
+				size -= (size_t)w;
+			}
+			first++;
+		}
+	}
+	return true;
+}
+
+bool AtomicFileWriter::rewrite(const uint64_t offset, const void *data, const size_t size) {
+	if(fd < 0 || failed) { return false; }
+
+	const uint8_t *bytes = (const uint8_t *)data;
+	uint64_t position = offset;
+	size_t remaining = size;
+	while(remaining > 0) {
+		ssize_t w = pwrite(fd, bytes, remaining, (off_t)position);
+		if(w < 0 && errno == EINTR) { continue; }
+		if(w <= 0) { failed = true; return false; }
+		bytes += w;
+		position += (uint64_t)w;
+		remaining -= (size_t)w;
+	}
+	return true;
+}
+
+bool AtomicFileWriter::commit(void) {
+	if(fd < 0) { return false; }
+
+	bool result = (::close(fd) == 0) && !failed;
+	fd = -1;
+
+	if(result) { result = rename(tempName.c_str(), fileName.c_str()) == 0; }
+	if(!result) { unlink(tempName.c_str()); }
+	tempName.clear();
+	return result;
+}
+
+void AtomicFileWriter::abort(void) {
+	if(fd >= 0) {
+		::close(fd);
+		unlink(tempName.c_str());
+	}
+	fd = -1;
+	tempName.clear();
+}
+
+#endif
@@ -0,0 +1,219 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.3
+ *          - 1.0.0 - Added memory mapped file reader.
+ *          - 1.0.1 - Added atomic gather writer.
+ *          - 1.0.2 - Added positional reader and streaming atomic writer.
+ *          - 1.0.3 - Added rewriting of written bytes.
+ *
+ * @desc Platform file I/O helpers used by the BitmapHandler library.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <string>
+
+/*! Single buffer of a gather write */
+struct IoBuffer {
+	const void *data;					/*! Start of the buffer */
+	size_t size;						/*! Size of the buffer in bytes */
+};
+
+/*!
+ * @brief Writes the buffers to a temporary file in the destination directory
+ *        with one gather write, then renames it over the destination so readers
+ *        never observe a partially written file.
+ * @param [string] - Destination file name.
+ * @param [IoBuffer] - Buffers to be written in order.
+ * @param [int] - Number of buffers.
+ * @return [boolean] - Set if the file is written and committed otherwise reset.
+ */
+bool writeFileAtomic(const char *fileName, const IoBuffer *buffers, const uint32_t count);
+
+class MappedFile {
+
+	public:
+		/*!
+		 * @brief Constructor of the class initializing all the data variable(s).
+		 */
+		MappedFile();
+
+		/*!
+		 * @brief Destructor, unmaps the file if still mapped.
+		 */
+		virtual ~MappedFile();
+
+		/*!
+		 * @brief Maps the whole file read-only into memory.
+		 * @param [string] - Name of the file to be mapped.
+		 * @param [boolean] - Set to hint the kernel for sequential access.
+		 * @return [boolean] - Set if mapping is done successfully otherwise reset.
+		 */
+		bool open(const char *fileName, const bool sequential = true);
+
+		/*!
+		 * @brief Unmaps the file.
+		 * @param None
+		 * @return None
+		 */
+		void close(void);
+
+		//GETTERS
+
+		inline bool isOpen(void) const { return data != 0; }
+		inline const uint8_t *getData(void) const { return data; }
+		inline uint64_t getSize(void) const { return size; }
+
+	private:
+		MappedFile(const MappedFile &);
+		MappedFile &operator=(const MappedFile &);
+
+		const uint8_t *data;
+		uint64_t size;
+
+#ifdef _WIN32
+		void *fileHandle;
+		void *mapHandle;
+#endif
+};
+
+class FileReader {
+
+	public:
+		/*!
+		 * @brief Constructor of the class initializing all the data variable(s).
+		 */
+		FileReader();
+
+		/*!
+		 * @brief Destructor, closes the file if still open.
+		 */
+		virtual ~FileReader();
+
+		/*!
+		 * @brief Opens the file for positional reads.
+		 * @param [string] - Name of the file to be read.
+		 * @return [boolean] - Set if the file is opened otherwise reset.
+		 */
+		bool open(const char *fileName);
+
+		/*!
+		 * @brief Reads exactly 'size' bytes at the given offset, without moving
+		 *        any shared file position so reads may come from several threads.
+		 * @param [int] - File offset.
+		 * @param [string] - Buffer to read into.
+		 * @param [int] - Number of bytes.
+		 * @return [boolean] - Set if all bytes are read otherwise reset.
+		 */
+		bool read(const uint64_t offset, void *buffer, const size_t size) const;
+
+		/*!
+		 * @brief Closes the file.
+		 * @param None
+		 * @return None
+		 */
+		void close(void);
+
+		//GETTERS
+
+		inline uint64_t getSize(void) const { return size; }
+
+	private:
+		FileReader(const FileReader &);
+		FileReader &operator=(const FileReader &);
+
+		uint64_t size;
+#ifdef _WIN32
+		void *fileHandle;
+#else
+		int fd;
+#endif
+};
+
+class AtomicFileWriter {
+
+	public:
+		/*!
+		 * @brief Constructor of the class initializing all the data variable(s).
+		 */
+		AtomicFileWriter();
+
+		/*!
+		 * @brief Destructor, discards the temporary file if not committed.
+		 */
+		virtual ~AtomicFileWriter();
+
+		/*!
+		 * @brief Creates the temporary file next to the destination.
+		 * @param [string] - Destination file name.
+		 * @return [boolean] - Set if the temporary file is created otherwise reset.
+		 */
+		bool open(const char *fileName);
+
+		/*!
+		 * @brief Appends the buffers to the temporary file with one gather write.
+		 * @param [IoBuffer] - Buffers to be written in order.
+		 * @param [int] - Number of buffers.
+		 * @return [boolean] - Set if all bytes are written otherwise reset.
+		 */
+		bool write(const IoBuffer *buffers, const uint32_t count);
+
+		/*!
+		 * @brief Overwrites bytes already written, e.g. sizes in a header that are
+		 *        only known at the end. Later writes still append.
+		 * @param [int] - File offset.
+		 * @param [string] - Bytes to be written.
+		 * @param [int] - Number of bytes.
+		 * @return [boolean] - Set if all bytes are written otherwise reset.
+		 */
+		bool rewrite(const uint64_t offset, const void *data, const size_t size);
+
+		/*!
+		 * @brief Closes the temporary file and renames it over the destination.
+		 * @param None
+		 * @return [boolean] - Set if the file is committed otherwise reset.
+		 */
+		bool commit(void);
+
+		/*!
+		 * @brief Closes and deletes the temporary file.
+		 * @param None
+		 * @return None
+		 */
+		void abort(void);
+
+	private:
+		AtomicFileWriter(const AtomicFileWriter &);
+		AtomicFileWriter &operator=(const AtomicFileWriter &);
+
+		std::string fileName;
+		std::string tempName;
+		bool failed;
+#ifdef _WIN32
+		void *fileHandle;
+#else
+		int fd;
+#endif
+};
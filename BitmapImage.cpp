@@ -0,0 +1,187 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.3
+ *          - 1.0.0 - Added in-memory image container.
+ *          - 1.0.1 - Added zero-copy read-only views over external memory.
+ *          - 1.0.2 - Added pooled aligned pixel buffers.
+ *          - 1.0.3 - Added strided views and cropping.
+ *
+ * @desc In-memory 'BMP' pixel container used to chain BitmapHandler
+ *       operations without writing intermediate files to disk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include "BitmapImage.h"
+
+BitmapImage::BitmapImage() {
+	width = 0;
+	height = 0;
+	bitsPerPixel = 0;
+	stride = 0;
+	hPixPM = 0;
+	vPixPM = 0;
+	dataSize = 0;
+	view = 0;
+}
+
+BitmapImage::BitmapImage(const uint32_t width, const uint32_t height, const uint16_t bpp) {
+	hPixPM = 0;
+	vPixPM = 0;
+	dataSize = 0;
+	view = 0;
+	create(width, height, bpp);
+}
+
+BitmapImage::BitmapImage(const BitmapImage &other) {
+	view = 0;
+	*this = other;
+}
+
+BitmapImage &BitmapImage::operator=(const BitmapImage &other) {
+	if(this == &other) { return *this; }
+
+	width = other.width;
+	height = other.height;
+	bitsPerPixel = other.bitsPerPixel;
+	stride = other.stride;
+	hPixPM = other.hPixPM;
+	vPixPM = other.vPixPM;
+	dataSize = other.dataSize;
+	palette = other.palette;
+
+	//Views are shared, owned pixels are copied.
+	view = other.view;
+	viewOwner = other.viewOwner;
+	pixels.release();
+	if(!view && dataSize) {
+		pixels = BufferPool::getShared().acquire(dataSize);
+		memcpy(pixels.data(), other.pixels.data(), dataSize);
+	}
+	return *this;
+}
+
+bool BitmapImage::create(const uint32_t width, const uint32_t height, const uint16_t bpp) {
+	if(!allocate(width, height, bpp)) { return false; }
+	memset(pixels.data(), 0, dataSize);
+	return true;
+}
+
+bool BitmapImage::allocate(const uint32_t width, const uint32_t height, const uint16_t bpp) {
+	this->width = width;
+	this->height = height;
+	this->bitsPerPixel = bpp;
+	this->stride = calcStride(width, bpp);
+
+	view = 0;
+	viewOwner.reset();
+
+	//Reusing the current buffer when it is large enough, otherwise taking one from the pool.
+	dataSize = stride * height;
+	if(pixels.size() < dataSize || pixels.size() > dataSize * 2) {
+		pixels.release();
+		pixels = BufferPool::getShared().acquire(dataSize);
+	}
+	palette.clear();
+
+	clearRowPadding(pixels.data(), height, (uint32_t)(((uint64_t)width * bpp + 7) / 8), stride);
+	return !pixels.empty();
+}
+
+void BitmapImage::wrap(const uint8_t *data, const uint32_t width, const uint32_t height, const uint16_t bpp,
+	const std::shared_ptr<const void> &owner, const uint32_t stride) {
+	this->width = width;
+	this->height = height;
+	this->bitsPerPixel = bpp;
+	this->stride = stride ? stride : calcStride(width, bpp);
+
+	pixels.release();
+	palette.clear();
+	dataSize = calcStride(width, bpp) * height;
+
+	view = data;
+	viewOwner = owner;
+}
+
+bool BitmapImage::crop(ImageRect rect, BitmapImage &dst) const {
+	if((bitsPerPixel & 7) != 0 || !clipRect(rect, width, height)) { return false; }
+
+	//Rows are stored bottom-up, the window starts at its bottom row.
+	uint32_t pixelBytes = bitsPerPixel / 8;
+	const uint8_t *first = getRow(height - rect.y - rect.height) + (size_t)rect.x * pixelBytes;
+
+	BitmapImage window;
+	if(view) {
+		window.wrap(first, rect.width, rect.height, bitsPerPixel, viewOwner, stride);
+	} else {
+		window.allocate(rect.width, rect.height, bitsPerPixel);
+		for(uint32_t i = 0; i < rect.height; i++) {
+			memcpy(window.getRow(i), first + (size_t)i * stride, (size_t)rect.width * pixelBytes);
+		}
+	}
+	window.hPixPM = hPixPM;
+	window.vPixPM = vPixPM;
+	window.palette = palette;
+
+	dst = std::move(window);
+	return true;
+}
+
+void BitmapImage::release(void) {
+	width = 0;
+	height = 0;
+	bitsPerPixel = 0;
+	stride = 0;
+	dataSize = 0;
+
+	pixels.release();
+	std::vector<uint8_t>().swap(palette);
+
+	view = 0;
+	viewOwner.reset();
+}
+
+void BitmapImage::createGrayPalette(void) {
+	palette.resize(256 * 4);
+
+	uint16_t k = 0;
+	for(uint16_t i = 0; i < 256; i++) {
+		for(uint8_t j = 0; j < 3; j++) {
+			palette[k++] = (uint8_t)i;
+		}
+		palette[k++] = 0;
+	}
+}
+
+void BitmapImage::detach(void) {
+	PixelBuffer copy = BufferPool::getShared().acquire(dataSize);
+	if(isPacked()) {
+		memcpy(copy.data(), view, dataSize);
+	} else {
+		uint32_t packed = calcStride(width, bitsPerPixel);
+		uint32_t rowBytes = (uint32_t)(((uint64_t)width * bitsPerPixel + 7) / 8);
+		for(uint32_t i = 0; i < height; i++) { memcpy(copy.data() + (size_t)i * packed, view + (size_t)i * stride, rowBytes); }
+		clearRowPadding(copy.data(), height, rowBytes, packed);
+		stride = packed;
+	}
+	pixels = std::move(copy);
+	view = 0;
+	viewOwner.reset();
+}
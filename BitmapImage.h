@@ -0,0 +1,211 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.4
+ *          - 1.0.0 - Added in-memory image container.
+ *          - 1.0.1 - Added zero-copy read-only views over external memory.
+ *          - 1.0.2 - Added pooled aligned pixel buffers.
+ *          - 1.0.3 - Added strided views and cropping.
+ *          - 1.0.4 - Fixed row addressing of strided views detached by getRow().
+ *
+ * @desc In-memory 'BMP' pixel container used to chain BitmapHandler
+ *       operations without writing intermediate files to disk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include <memory>
+#include <vector>
+
+#include "BufferPool.h"
+
+/*! Rectangular window of an image, from the top-left corner as it is displayed */
+struct ImageRect {
+	uint32_t x;							/*! Left column */
+	uint32_t y;							/*! Top row */
+	uint32_t width;						/*! Width in pixels, 0 for none */
+	uint32_t height;					/*! Height in pixels, 0 for none */
+};
+
+/*!
+ * @brief Clips a window to an image.
+ * @param [ImageRect] - Window, clipped in place.
+ * @param [int] - Image width.
+ * @param [int] - Image height.
+ * @return [boolean] - Set if some of the window is inside the image otherwise reset.
+ */
+inline bool clipRect(ImageRect &rect, const uint32_t width, const uint32_t height) {
+	if(rect.x >= width || rect.y >= height || rect.width == 0 || rect.height == 0) { return false; }
+	if(rect.width > width - rect.x) { rect.width = width - rect.x; }
+	if(rect.height > height - rect.y) { rect.height = height - rect.y; }
+	return true;
+}
+
+class BitmapImage {
+
+	public:
+		/*!
+		 * @brief Constructor creating an empty image.
+		 */
+		BitmapImage();
+
+		/*!
+		 * @brief Constructor allocating a zeroed image of the given geometry.
+		 * @param [int] - Image width in pixels.
+		 * @param [int] - Image height in pixels.
+		 * @param [int] - Bits per pixel.
+		 */
+		BitmapImage(const uint32_t width, const uint32_t height, const uint16_t bpp);
+
+		/*!
+		 * @brief Copy constructor, copies the pixels into a buffer of its own.
+		 */
+		BitmapImage(const BitmapImage &other);
+		BitmapImage &operator=(const BitmapImage &other);
+
+		BitmapImage(BitmapImage &&other) = default;
+		BitmapImage &operator=(BitmapImage &&other) = default;
+
+		/*!
+		 * @brief (Re)allocates a zeroed pixel buffer for the given geometry.
+		 * @param [int] - Image width in pixels.
+		 * @param [int] - Image height in pixels.
+		 * @param [int] - Bits per pixel.
+		 * @return [boolean] - Set if allocation is done successfully otherwise reset.
+		 */
+		bool create(const uint32_t width, const uint32_t height, const uint16_t bpp);
+
+		/*!
+		 * @brief (Re)allocates the pixel buffer from the shared pool without clearing
+		 *        it, only the row padding is zeroed. For outputs that are completely
+		 *        written afterwards.
+		 * @param [int] - Image width in pixels.
+		 * @param [int] - Image height in pixels.
+		 * @param [int] - Bits per pixel.
+		 * @return [boolean] - Set if allocation is done successfully otherwise reset.
+		 */
+		bool allocate(const uint32_t width, const uint32_t height, const uint16_t bpp);
+
+		/*!
+		 * @brief Wraps external read-only pixel rows without copying them.
+		 *        The first mutable access copies the rows into owned memory.
+		 * @param [string] - First (bottom) row of the pixel data.
+		 * @param [int] - Image width in pixels.
+		 * @param [int] - Image height in pixels.
+		 * @param [int] - Bits per pixel.
+		 * @param [pointer] - Owner kept alive as long as the view is in use.
+		 * @param [int] - Distance of the rows in bytes, 0 for the padded row size.
+		 *        Wider rows make a view of a window of larger rows.
+		 * @return None
+		 */
+		void wrap(const uint8_t *data, const uint32_t width, const uint32_t height, const uint16_t bpp,
+			const std::shared_ptr<const void> &owner, const uint32_t stride = 0);
+
+		/*!
+		 * @brief Cuts a window out of an 8, 24 or 32 bit image. Views give a view of
+		 *        the same memory striding over the window rows, owned pixels are
+		 *        copied. Resolution and palette are kept.
+		 * @param [ImageRect] - Window, clipped to the image.
+		 * @param [BitmapImage] - Receives the window (may be this image).
+		 * @return [boolean] - Set if the window is inside the image otherwise reset.
+		 */
+		bool crop(ImageRect rect, BitmapImage &dst) const;
+
+		/*!
+		 * @brief Releases the pixel buffer and palette, the buffer goes back to the pool.
+		 * @param None
+		 * @return None
+		 */
+		void release(void);
+
+		/*!
+		 * @brief Creates the identity gray scale palette (256 BGRA entries).
+		 * @param None
+		 * @return None
+		 */
+		void createGrayPalette(void);
+
+		/*!
+		 * @brief Calculates the padded row size of a 'BMP' image.
+		 * @param [int] - Image width in pixels.
+		 * @param [int] - Bits per pixel.
+		 * @return [int] - Row size in bytes (multiple of 4).
+		 */
+		static inline uint32_t calcStride(const uint32_t width, const uint16_t bpp) {
+			return (((bpp * width) + 31) / 32) * 4;
+		}
+
+		//GETTERS
+
+		inline bool isEmpty(void) const { return dataSize == 0; }
+		inline bool isView(void) const { return view != 0; }
+		inline bool isPacked(void) const { return stride == calcStride(width, bitsPerPixel); }
+
+		inline uint32_t getWidth(void) const { return width; }
+		inline uint32_t getHeight(void) const { return height; }
+		inline uint16_t getBitsPerPixel(void) const { return bitsPerPixel; }
+		inline uint32_t getStride(void) const { return stride; }
+		inline uint32_t getDataSize(void) const { return dataSize; }	/*! Size of the rows once packed */
+		inline uint32_t getHorPixPerMeter(void) const { return hPixPM; }
+		inline uint32_t getVerPixPerMeter(void) const { return vPixPM; }
+
+		inline uint8_t *getData(void) { if(view) { detach(); } return pixels.data(); }
+		inline const uint8_t *getData(void) const { return view ? view : pixels.data(); }
+
+		//Detaching a view repacks the rows, so the stride is read once the data is owned.
+		inline uint8_t *getRow(const uint32_t row) { uint8_t *data = getData(); return data + (size_t)row * stride; }
+		inline const uint8_t *getRow(const uint32_t row) const { const uint8_t *data = getData(); return data + (size_t)row * stride; }
+
+		inline const uint8_t *getPalette(void) const { return palette.empty() ? 0 : palette.data(); }
+		inline uint32_t getPaletteSize(void) const { return (uint32_t)palette.size(); }
+
+		//SETTERS
+
+		inline void setHorPixPerMeter(const uint32_t hpm) { hPixPM = hpm; }
+		inline void setVerPixPerMeter(const uint32_t vpm) { vPixPM = vpm; }
+		inline void setPalette(const uint8_t *data, const uint32_t size) { palette.assign(data, data + size); }
+
+	private:
+		/*!
+		 * @brief Copies the viewed rows into owned memory, packing strided rows.
+		 * @param None
+		 * @return None
+		 */
+		void detach(void);
+
+		uint32_t width;
+		uint32_t height;
+		uint16_t bitsPerPixel;
+		uint32_t stride;
+		uint32_t hPixPM;
+		uint32_t vPixPM;
+		uint32_t dataSize;
+
+		PixelBuffer pixels;					/*! Bottom-up rows, 'stride' bytes each */
+		std::vector<uint8_t> palette;		/*! BGRA palette entries */
+
+		const uint8_t *view;				/*! External rows when wrapping, otherwise null */
+		std::shared_ptr<const void> viewOwner;
+};
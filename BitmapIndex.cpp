@@ -0,0 +1,280 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.1
+ *          - 1.0.0 - Added header metadata cache and directory index.
+ *          - 1.0.1 - Made heights of top-down images positive.
+ *
+ * @desc Header metadata of 'BMP' files without re-reading them: a cache keyed
+ *       by path, size and modification time, and an on-disk directory index
+ *       that can be filtered by dimensions and bit depth.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include "BitmapIndex.h"
+
+#include <cstring>
+
+#include <filesystem>
+#include <iostream>
+
+#include "BitmapIO.h"
+#include "ThreadPool.h"
+
+namespace fs = std::filesystem;
+
+static const char INDEX_MAGIC[8]		= { 'B', 'M', 'P', 'I', 'N', 'D', 'E', 'X' };
+static const uint32_t INDEX_VERSION		= 1;
+static const uint32_t INDEX_BAND_FILES	= 64;		//Smallest number of headers read by a thread
+
+/*! Leading block of an index file, followed by the records and the names */
+struct IndexFileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t recordSize;
+	uint64_t count;
+	uint64_t namesSize;
+};
+
+/*!
+ * @brief Converts a modification time into a plain time stamp.
+ * @param [file_time_type] - Modification time.
+ * @return [int] - Time stamp, only comparable on the same system.
+ */
+static int64_t toTimeStamp(const fs::file_time_type &time) {
+	return (int64_t)time.time_since_epoch().count();
+}
+
+/*!
+ * @brief Fills the header fields of an index record from the raw header.
+ * @param [string] - Raw header of BMP_HEADER_BYTES bytes.
+ * @param [IndexRecord] - Record to be filled.
+ * @return None
+ */
+static void parseHeader(const uint8_t *header, IndexRecord &record) {
+	memcpy(&record.imageOffset, &header[10], 4);
+	memcpy(&record.infoHeaderSize, &header[14], 4);
+	memcpy(&record.imageWidth, &header[18], 4);
+	memcpy(&record.imageHeight, &header[22], 4);
+	memcpy(&record.colorPlane, &header[26], 2);
+	memcpy(&record.bitsPerPixel, &header[28], 2);
+	memcpy(&record.compressionType, &header[30], 4);
+	memcpy(&record.imageSize, &header[34], 4);
+	memcpy(&record.hPixPM, &header[38], 4);
+	memcpy(&record.vPixPM, &header[42], 4);
+	memcpy(&record.colorUsed, &header[46], 4);
+	memcpy(&record.impColorUsed, &header[50], 4);
+	record.reserved = 0;
+
+	//Top-down images store a negative height.
+	if((int32_t)record.imageHeight < 0) { record.imageHeight = 0u - record.imageHeight; }
+}
+
+bool statFile(const char *fileName, uint64_t &size, int64_t &modified) {
+	std::error_code ec;
+	fs::path path(fileName);
+	size = (uint64_t)fs::file_size(path, ec);
+	if(ec) { return false; }
+	modified = toTimeStamp(fs::last_write_time(path, ec));
+	return !ec;
+}
+
+bool readBitmapHeader(const char *fileName, uint8_t *header) {
+	FileReader reader;
+	if(!reader.open(fileName) || reader.getSize() < BMP_HEADER_BYTES) { return false; }
+	if(!reader.read(0, header, BMP_HEADER_BYTES)) { return false; }
+	return header[0] == 'B' && header[1] == 'M';
+}
+
+MetadataCache::MetadataCache() {
+	hits = 0;
+	misses = 0;
+}
+
+bool MetadataCache::lookup(const char *fileName, uint8_t *header) {
+	uint64_t size;
+	int64_t modified;
+	if(!statFile(fileName, size, modified)) { return false; }
+
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+		std::unordered_map<std::string, Entry>::const_iterator it = entries.find(fileName);
+		if(it != entries.end() && it->second.fileSize == size && it->second.modified == modified) {
+			memcpy(header, it->second.header, BMP_HEADER_BYTES);
+			hits++;
+			return true;
+		}
+		misses++;
+	}
+
+	//Reading outside the lock, other lookups are not held up by the disk.
+	Entry entry;
+	entry.fileSize = size;
+	entry.modified = modified;
+	if(!readBitmapHeader(fileName, entry.header)) { return false; }
+	memcpy(header, entry.header, BMP_HEADER_BYTES);
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	entries[fileName] = entry;
+	return true;
+}
+
+void MetadataCache::clear(void) {
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	entries.clear();
+}
+
+MetadataCache &MetadataCache::getShared(void) {
+	static MetadataCache cache;
+	return cache;
+}
+
+bool BitmapIndex::build(const char *dir) {
+	try {
+		//Previous records by path, unchanged files are taken over as they are.
+		std::unordered_map<std::string, uint32_t> previous;
+		for(uint32_t i = 0; i < records.size(); i++) { previous[getPath(i)] = i; }
+
+		std::vector<IndexRecord> scanned;
+		std::vector<char> scannedNames;
+		std::vector<uint32_t> pending;					//Records whose header must be read
+
+		for(const fs::directory_entry &entry : fs::recursive_directory_iterator(dir, fs::directory_options::skip_permission_denied)) {
+			std::error_code ec;
+			if(!entry.is_regular_file(ec)) { continue; }
+
+			std::string ext = entry.path().extension().string();
+			for(char &c : ext) { c = (char)tolower((unsigned char)c); }
+			if(ext != ".bmp") { continue; }
+
+			std::string path = entry.path().string();
+			IndexRecord record;
+			memset(&record, 0, sizeof(record));
+			record.fileSize = (uint64_t)entry.file_size(ec);
+			if(ec) { continue; }
+			record.modified = toTimeStamp(entry.last_write_time(ec));
+			if(ec) { continue; }
+
+			std::unordered_map<std::string, uint32_t>::const_iterator it = previous.find(path);
+			if(it != previous.end() && records[it->second].fileSize == record.fileSize &&
+				records[it->second].modified == record.modified) {
+				record = records[it->second];
+			} else {
+				pending.push_back((uint32_t)scanned.size());
+			}
+
+			record.nameOffset = scannedNames.size();
+			scannedNames.insert(scannedNames.end(), path.begin(), path.end());
+			scannedNames.push_back(0);
+			scanned.push_back(record);
+		}
+
+		//Reading the new and changed headers in parallel, files that are not
+		//'BMP' files are marked and dropped afterwards.
+		std::vector<uint8_t> valid(scanned.size(), 1);
+		ThreadPool::getShared().parallelFor(0, (uint32_t)pending.size(), INDEX_BAND_FILES, [&](uint32_t first, uint32_t last) {
+			uint8_t header[BMP_HEADER_BYTES];
+			for(uint32_t i = first; i < last; i++) {
+				IndexRecord &record = scanned[pending[i]];
+				if(readBitmapHeader(&scannedNames[record.nameOffset], header)) {
+					parseHeader(header, record);
+				} else {
+					valid[pending[i]] = 0;
+				}
+			}
+		});
+
+		records.clear();
+		names.clear();
+		for(uint32_t i = 0; i < scanned.size(); i++) {
+			if(!valid[i]) { continue; }
+			IndexRecord record = scanned[i];
+			const char *path = &scannedNames[record.nameOffset];
+			record.nameOffset = names.size();
+			names.insert(names.end(), path, path + strlen(path) + 1);
+			records.push_back(record);
+		}
+		return true;
+	} catch(std::exception &e) {
+		std::cout << e.what() << std::endl;
+	}
+	return false;
+}
+
+bool BitmapIndex::save(const char *fileName) const {
+	IndexFileHeader header;
+	memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+	header.version = INDEX_VERSION;
+	header.recordSize = sizeof(IndexRecord);
+	header.count = records.size();
+	header.namesSize = names.size();
+
+	IoBuffer buffers[3] = {
+		{ &header, sizeof(header) },
+		{ records.data(), records.size() * sizeof(IndexRecord) },
+		{ names.data(), names.size() }
+	};
+	return writeFileAtomic(fileName, buffers, 3);
+}
+
+bool BitmapIndex::load(const char *fileName) {
+	records.clear();
+	names.clear();
+
+	FileReader reader;
+	IndexFileHeader header;
+	if(!reader.open(fileName) || !reader.read(0, &header, sizeof(header))) { return false; }
+
+	if(memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) != 0 || header.version != INDEX_VERSION ||
+		header.recordSize != sizeof(IndexRecord) ||
+		sizeof(header) + header.count * sizeof(IndexRecord) + header.namesSize != reader.getSize()) {
+		return false;
+	}
+
+	//Two reads, the records and all names in one block each.
+	records.resize((size_t)header.count);
+	names.resize((size_t)header.namesSize);
+	if(!reader.read(sizeof(header), records.data(), records.size() * sizeof(IndexRecord)) ||
+		!reader.read(sizeof(header) + records.size() * sizeof(IndexRecord), names.data(), names.size())) {
+		records.clear();
+		names.clear();
+		return false;
+	}
+
+	//Rejecting names outside the blob or not terminated.
+	for(const IndexRecord &record : records) {
+		if(record.nameOffset >= names.size()) { records.clear(); names.clear(); return false; }
+	}
+	if(!names.empty() && names.back() != 0) { records.clear(); names.clear(); return false; }
+	return true;
+}
+
+void BitmapIndex::query(const IndexQuery &filter, std::vector<uint32_t> &matches) const {
+	matches.clear();
+	for(uint32_t i = 0; i < records.size(); i++) {
+		const IndexRecord &record = records[i];
+		if(filter.minWidth && record.imageWidth < filter.minWidth) { continue; }
+		if(filter.maxWidth && record.imageWidth > filter.maxWidth) { continue; }
+		if(filter.minHeight && record.imageHeight < filter.minHeight) { continue; }
+		if(filter.maxHeight && record.imageHeight > filter.maxHeight) { continue; }
+		if(filter.bitsPerPixel && record.bitsPerPixel != filter.bitsPerPixel) { continue; }
+		matches.push_back(i);
+	}
+}
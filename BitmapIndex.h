@@ -0,0 +1,180 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.0
+ *          - 1.0.0 - Added header metadata cache and directory index.
+ *
+ * @desc Header metadata of 'BMP' files without re-reading them: a cache keyed
+ *       by path, size and modification time, and an on-disk directory index
+ *       that can be filtered by dimensions and bit depth.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static const uint32_t BMP_HEADER_BYTES	= 54;		//File header and info header
+
+/*! Header fields of one indexed file, the contents of BMP_FH / BMP_IH */
+struct IndexRecord {
+	uint64_t fileSize;					/*! Size of the file on disk */
+	int64_t modified;					/*! Modification time stamp */
+	uint64_t nameOffset;				/*! Offset of the path in the name blob */
+	uint32_t imageOffset;				/*! Image data offset */
+	uint32_t infoHeaderSize;			/*! Info header size */
+	uint32_t imageWidth;				/*! Image width */
+	uint32_t imageHeight;				/*! Image height */
+	uint16_t colorPlane;				/*! Color plane */
+	uint16_t bitsPerPixel;				/*! Bits per pixel */
+	uint32_t compressionType;			/*! Compression type */
+	uint32_t imageSize;					/*! Image size */
+	uint32_t hPixPM;					/*! Horizontal resolution */
+	uint32_t vPixPM;					/*! Vertical resolution */
+	uint32_t colorUsed;					/*! Color used */
+	uint32_t impColorUsed;				/*! Important color used */
+	uint32_t reserved;					/*! Keeps records 8 byte aligned */
+};
+
+/*! Filter of an index query, zero bounds are not checked */
+struct IndexQuery {
+	uint32_t minWidth;
+	uint32_t maxWidth;
+	uint32_t minHeight;
+	uint32_t maxHeight;
+	uint16_t bitsPerPixel;
+};
+
+/*!
+ * @brief Reads the size and modification time of a file.
+ * @param [string] - File name.
+ * @param [int] - File size.
+ * @param [int] - Modification time stamp.
+ * @return [boolean] - Set if the file exists otherwise reset.
+ */
+bool statFile(const char *fileName, uint64_t &size, int64_t &modified);
+
+/*!
+ * @brief Reads the header bytes of a 'BMP' file.
+ * @param [string] - File name.
+ * @param [string] - Buffer of BMP_HEADER_BYTES bytes.
+ * @return [boolean] - Set if the file starts with a 'BMP' header otherwise reset.
+ */
+bool readBitmapHeader(const char *fileName, uint8_t *header);
+
+class MetadataCache {
+
+	public:
+		/*!
+		 * @brief Constructor of the class initializing all the data variable(s).
+		 */
+		MetadataCache();
+
+		/*!
+		 * @brief Returns the raw header of the file, reading it only if the file
+		 *        is not cached yet or its size or modification time changed.
+		 * @param [string] - File name.
+		 * @param [string] - Buffer of BMP_HEADER_BYTES bytes.
+		 * @return [boolean] - Set if the file is a 'BMP' file otherwise reset.
+		 */
+		bool lookup(const char *fileName, uint8_t *header);
+
+		/*!
+		 * @brief Drops all cached headers.
+		 * @param None
+		 * @return None
+		 */
+		void clear(void);
+
+		//GETTERS
+
+		inline uint64_t getHits(void) const { return hits; }
+		inline uint64_t getMisses(void) const { return misses; }
+
+		/*!
+		 * @brief Returns the cache shared by the whole library.
+		 * @param None
+		 * @return [MetadataCache] - Shared cache.
+		 */
+		static MetadataCache &getShared(void);
+
+	private:
+		/*! Cached header with the file state it was read from */
+		struct Entry {
+			uint64_t fileSize;
+			int64_t modified;
+			uint8_t header[BMP_HEADER_BYTES];
+		};
+
+		std::unordered_map<std::string, Entry> entries;
+		std::mutex cacheMutex;
+		uint64_t hits;
+		uint64_t misses;
+};
+
+class BitmapIndex {
+
+	public:
+		/*!
+		 * @brief Scans the directory and its sub directories for '.bmp' files and
+		 *        indexes their headers. Files already in the index with the same
+		 *        size and modification time are not opened again.
+		 * @param [string] - Directory to be scanned.
+		 * @return [boolean] - Set if the scan is done successfully otherwise reset.
+		 */
+		bool build(const char *dir);
+
+		/*!
+		 * @brief Writes the index to a file.
+		 * @param [string] - Index file name.
+		 * @return [boolean] - Set if writing is done successfully otherwise reset.
+		 */
+		bool save(const char *fileName) const;
+
+		/*!
+		 * @brief Reads an index written by save().
+		 * @param [string] - Index file name.
+		 * @return [boolean] - Set if reading is done successfully otherwise reset.
+		 */
+		bool load(const char *fileName);
+
+		/*!
+		 * @brief Returns the records matching the query.
+		 * @param [IndexQuery] - Filter.
+		 * @param [int] - Indices of the matching records.
+		 * @return None
+		 */
+		void query(const IndexQuery &filter, std::vector<uint32_t> &matches) const;
+
+		//GETTERS
+
+		inline uint32_t getCount(void) const { return (uint32_t)records.size(); }
+		inline const IndexRecord &getRecord(const uint32_t i) const { return records[i]; }
+		inline const char *getPath(const uint32_t i) const { return &names[records[i].nameOffset]; }
+
+	private:
+		std::vector<IndexRecord> records;
+		std::vector<char> names;			/*! Null terminated paths */
+};
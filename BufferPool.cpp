@@ -0,0 +1,214 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.1
+ *          - 1.0.0 - Added aligned pixel buffer pool.
+ *          - 1.0.1 - Added per thread request counters.
+ *
+ * @desc Pool of 64 byte aligned pixel buffers bucketed by size, reused across
+ *       operations so large images do not fault in and clear fresh memory.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include "BufferPool.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include <chrono>
+#include <new>
+
+//Counters of the requests of the current thread, null when not counted.
+static thread_local PoolCounters *threadCounters = 0;
+
+/*!
+ * @brief Allocates an aligned block.
+ */
+static uint8_t *alignedAlloc(const size_t size) {
+#ifdef _WIN32
+	void *ptr = _aligned_malloc(size, POOL_ALIGNMENT);
+#else
+	void *ptr = 0;
+	if(posix_memalign(&ptr, POOL_ALIGNMENT, size) != 0) { ptr = 0; }
+#endif
+	if(ptr == 0) { throw std::bad_alloc(); }
+	return (uint8_t *)ptr;
+}
+
+/*!
+ * @brief Frees a block of alignedAlloc().
+ */
+static void alignedFree(uint8_t *ptr) {
+#ifdef _WIN32
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+PixelBuffer::PixelBuffer() {
+	ptr = 0;
+	bytes = 0;
+	capacity = 0;
+	pool = 0;
+}
+
+PixelBuffer::~PixelBuffer() {
+	release();
+}
+
+PixelBuffer::PixelBuffer(PixelBuffer &&other) {
+	ptr = other.ptr;
+	bytes = other.bytes;
+	capacity = other.capacity;
+	pool = other.pool;
+	other.ptr = 0;
+	other.bytes = 0;
+	other.capacity = 0;
+	other.pool = 0;
+}
+
+PixelBuffer &PixelBuffer::operator=(PixelBuffer &&other) {
+	if(this != &other) {
+		release();
+		ptr = other.ptr;
+		bytes = other.bytes;
+		capacity = other.capacity;
+		pool = other.pool;
+		other.ptr = 0;
+		other.bytes = 0;
+		other.capacity = 0;
+		other.pool = 0;
+	}
+	return *this;
+}
+
+void PixelBuffer::release(void) {
+	if(ptr) { pool->recycle(ptr, capacity); }
+	ptr = 0;
+	bytes = 0;
+	capacity = 0;
+	pool = 0;
+}
+
+BufferPool::BufferPool(const size_t cacheLimit) {
+	this->cacheLimit = cacheLimit;
+	cachedBytes = 0;
+	allocatedBytes = 0;
+	reuseCount = 0;
+}
+
+BufferPool::~BufferPool() {
+	trim();
+}
+
+size_t BufferPool::sizeClass(const size_t size) {
+	if(size <= POOL_ALIGNMENT) { return POOL_ALIGNMENT; }
+
+	//Step of a quarter of the enclosing power of two, at most 25% is wasted.
+	size_t power = POOL_ALIGNMENT;
+	while(power < size) { power <<= 1; }
+	size_t step = (power / 4 > POOL_ALIGNMENT) ? power / 4 : POOL_ALIGNMENT;
+	return (size + step - 1) / step * step;
+}
+
+PixelBuffer BufferPool::acquire(const size_t size) {
+	PixelBuffer buffer;
+	if(size == 0) { return buffer; }
+
+	PoolCounters *counters = threadCounters;
+	std::chrono::steady_clock::time_point start;
+	if(counters) { start = std::chrono::steady_clock::now(); }
+
+	size_t capacity = sizeClass(size);
+	uint8_t *ptr = 0;
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+		std::map<size_t, std::vector<uint8_t *> >::iterator it = idle.find(capacity);
+		if(it != idle.end() && !it->second.empty()) {
+			ptr = it->second.back();
+			it->second.pop_back();
+			cachedBytes -= capacity;
+			reuseCount++;
+		} else {
+			allocatedBytes += capacity;
+		}
+	}
+	bool fresh = (ptr == 0);
+	if(fresh) { ptr = alignedAlloc(capacity); }
+
+	if(counters) {
+		counters->acquisitions++;
+		counters->allocatedBytes += fresh ? capacity : 0;
+		counters->acquireMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	buffer.ptr = ptr;
+	buffer.bytes = size;
+	buffer.capacity = capacity;
+	buffer.pool = this;
+	return buffer;
+}
+
+void BufferPool::recycle(uint8_t *ptr, const size_t capacity) {
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+		if(cachedBytes + capacity <= cacheLimit) {
+			idle[capacity].push_back(ptr);
+			cachedBytes += capacity;
+			return;
+		}
+	}
+	alignedFree(ptr);
+}
+
+void BufferPool::trim(void) {
+	std::lock_guard<std::mutex> lock(poolMutex);
+	for(std::map<size_t, std::vector<uint8_t *> >::iterator it = idle.begin(); it != idle.end(); ++it) {
+		for(uint8_t *ptr : it->second) { alignedFree(ptr); }
+	}
+	idle.clear();
+	cachedBytes = 0;
+}
+
+void BufferPool::setCacheLimit(const size_t limit) {
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+		cacheLimit = limit;
+		if(cachedBytes <= cacheLimit) { return; }
+	}
+	trim();
+}
+
+void BufferPool::setThreadCounters(PoolCounters *counters) {
+	threadCounters = counters;
+}
+
+BufferPool &BufferPool::getShared(void) {
+	static BufferPool *pool = new BufferPool();
+	return *pool;
+}
+
+void clearRowPadding(uint8_t *data, const uint32_t rows, const uint32_t rowBytes, const uint32_t stride) {
+	if(rowBytes >= stride) { return; }
+	for(uint32_t i = 0; i < rows; i++) {
+		memset(data + (size_t)i * stride + rowBytes, 0, stride - rowBytes);
+	}
+}
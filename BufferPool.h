@@ -0,0 +1,182 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.1
+ *          - 1.0.0 - Added aligned pixel buffer pool.
+ *          - 1.0.1 - Added per thread request counters.
+ *
+ * @desc Pool of 64 byte aligned pixel buffers bucketed by size, reused across
+ *       operations so large images do not fault in and clear fresh memory.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+static const size_t POOL_ALIGNMENT		= 64;						//Cache line, also fits AVX loads
+static const size_t POOL_CACHE_LIMIT	= (size_t)512 << 20;		//Idle bytes kept by default
+
+class BufferPool;
+
+/*! Pool requests of one thread, counted while set with BufferPool::setThreadCounters() */
+struct PoolCounters {
+	uint64_t acquisitions;				/*! Buffers taken from the pool */
+	uint64_t allocatedBytes;			/*! Bytes allocated fresh for them */
+	double acquireMs;					/*! Wall time spent taking them */
+};
+
+class PixelBuffer {
+
+	public:
+		/*!
+		 * @brief Constructor creating an empty buffer.
+		 */
+		PixelBuffer();
+
+		/*!
+		 * @brief Destructor, returns the memory to its pool.
+		 */
+		virtual ~PixelBuffer();
+
+		PixelBuffer(PixelBuffer &&other);
+		PixelBuffer &operator=(PixelBuffer &&other);
+
+		/*!
+		 * @brief Returns the memory to its pool and empties the buffer.
+		 * @param None
+		 * @return None
+		 */
+		void release(void);
+
+		//GETTERS
+
+		inline uint8_t *data(void) const { return ptr; }
+		inline size_t size(void) const { return bytes; }
+		inline bool empty(void) const { return ptr == 0; }
+
+	private:
+		friend class BufferPool;
+
+		PixelBuffer(const PixelBuffer &);
+		PixelBuffer &operator=(const PixelBuffer &);
+
+		uint8_t *ptr;
+		size_t bytes;						/*! Requested size */
+		size_t capacity;					/*! Size class of the block */
+		BufferPool *pool;
+};
+
+class BufferPool {
+
+	public:
+		/*!
+		 * @brief Constructor of the class initializing all the data variable(s).
+		 * @param [int] - Most bytes of idle buffers kept for reuse.
+		 */
+		explicit BufferPool(const size_t cacheLimit = POOL_CACHE_LIMIT);
+
+		/*!
+		 * @brief Destructor, frees the idle buffers. Buffers still in use must not
+		 *        outlive the pool.
+		 */
+		virtual ~BufferPool();
+
+		/*!
+		 * @brief Returns an aligned buffer of at least 'size' bytes, reusing an idle
+		 *        buffer of the same size class if there is one. The contents are
+		 *        undefined. Throws std::bad_alloc if no memory is available.
+		 * @param [int] - Size in bytes.
+		 * @return [PixelBuffer] - Buffer going back to the pool when destroyed.
+		 */
+		PixelBuffer acquire(const size_t size);
+
+		/*!
+		 * @brief Frees all idle buffers.
+		 * @param None
+		 * @return None
+		 */
+		void trim(void);
+
+		//GETTERS
+
+		inline size_t getCachedBytes(void) const { return cachedBytes; }
+		inline uint64_t getAllocatedBytes(void) const { return allocatedBytes; }
+		inline uint64_t getReuseCount(void) const { return reuseCount; }
+
+		//SETTERS
+
+		void setCacheLimit(const size_t limit);
+
+		/*!
+		 * @brief Sets the counters the requests of the calling thread are added to.
+		 * @param [PoolCounters] - Counters, null to stop counting (default).
+		 * @return None
+		 */
+		static void setThreadCounters(PoolCounters *counters);
+
+		/*!
+		 * @brief Returns the pool shared by the whole library. It is never destroyed,
+		 *        so images released during static destruction are safe.
+		 * @param None
+		 * @return [BufferPool] - Shared pool.
+		 */
+		static BufferPool &getShared(void);
+
+	private:
+		friend class PixelBuffer;
+
+		BufferPool(const BufferPool &);
+		BufferPool &operator=(const BufferPool &);
+
+		/*!
+		 * @brief Takes a buffer back, keeping it if the cache limit allows.
+		 */
+		void recycle(uint8_t *ptr, const size_t capacity);
+
+		/*!
+		 * @brief Rounds the size up to its class, four classes per power of two.
+		 */
+		static size_t sizeClass(const size_t size);
+
+		std::map<size_t, std::vector<uint8_t *> > idle;
+		std::mutex poolMutex;
+
+		size_t cacheLimit;
+		size_t cachedBytes;
+		uint64_t allocatedBytes;
+		uint64_t reuseCount;
+};
+
+/*!
+ * @brief Clears the padding bytes at the end of every row, the only bytes of
+ *        a pooled image that no operation writes.
+ * @param [string] - First row.
+ * @param [int] - Number of rows.
+ * @param [int] - Bytes of pixel data per row.
+ * @param [int] - Row stride in bytes.
+ * @return None
+ */
+void clearRowPadding(uint8_t *data, const uint32_t rows, const uint32_t rowBytes, const uint32_t stride);
@@ -0,0 +1,92 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.0
+ *          - 1.0.0 - Added runtime SIMD level detection.
+ *
+ * @desc Runtime CPU feature detection used to dispatch SIMD kernels.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include "CpuFeatures.h"
+
+#include <atomic>
+
+#if defined(BITMAP_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+static std::atomic<int> simdLimit(SIMD_AVX2);
+
+/*!
+ * @brief Queries the CPU for the supported instruction sets.
+ * @param None
+ * @return [SimdLevel] - Highest supported level.
+ */
+static SimdLevel querySimdLevel(void) {
+#if !defined(BITMAP_X86)
+	return SIMD_SCALAR;
+#elif defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	bool sse2 = (info[3] & (1 << 26)) != 0;
+	bool ssse3 = (info[2] & (1 << 9)) != 0;
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+
+	bool avx2 = false;
+	if(maxLeaf >= 7 && osxsave && avx) {
+		//YMM state must be enabled by the OS.
+		bool ymm = (_xgetbv(0) & 0x6) == 0x6;
+		__cpuidex(info, 7, 0);
+		avx2 = ymm && (info[1] & (1 << 5)) != 0;
+	}
+
+	if(avx2 && ssse3) { return SIMD_AVX2; }
+	if(ssse3) { return SIMD_SSSE3; }
+	if(sse2) { return SIMD_SSE2; }
+	return SIMD_SCALAR;
+#else
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("ssse3")) { return SIMD_AVX2; }
+	if(__builtin_cpu_supports("ssse3")) { return SIMD_SSSE3; }
+	if(__builtin_cpu_supports("sse2")) { return SIMD_SSE2; }
+	return SIMD_SCALAR;
+#endif
+}
+
+SimdLevel detectSimdLevel(void) {
+	static const SimdLevel level = querySimdLevel();
+	return level;
+}
+
+SimdLevel getSimdLevel(void) {
+	int limit = simdLimit.load(std::memory_order_relaxed);
+	int level = detectSimdLevel();
+	return (SimdLevel)(level < limit ? level : limit);
+}
+
+void setSimdLevelLimit(const SimdLevel level) {
+	simdLimit.store(level, std::memory_order_relaxed);
+}
@@ -0,0 +1,70 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.0
+ *          - 1.0.0 - Added runtime SIMD level detection.
+ *
+ * @desc Runtime CPU feature detection used to dispatch SIMD kernels.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BITMAP_X86 1
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SIMD_TARGET(isa)
+#else
+#define SIMD_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+/*! Instruction set levels a kernel can be dispatched to */
+enum SimdLevel {
+	SIMD_SCALAR = 0,				/*! Portable C++ */
+	SIMD_SSE2,						/*! SSE2 */
+	SIMD_SSSE3,						/*! SSE2 + SSSE3 (pshufb) */
+	SIMD_AVX2						/*! AVX2 */
+};
+
+/*!
+ * @brief Detects the highest SIMD level supported by the CPU and the OS.
+ * @param None
+ * @return [SimdLevel] - Supported level, cached after the first call.
+ */
+SimdLevel detectSimdLevel(void);
+
+/*!
+ * @brief Returns the SIMD level kernels should use, the detected level
+ *        capped by setSimdLevelLimit().
+ * @param None
+ * @return [SimdLevel] - Level to dispatch to.
+ */
+SimdLevel getSimdLevel(void);
+
+/*!
+ * @brief Caps the SIMD level used by the kernels, e.g. for benchmarks.
+ * @param [SimdLevel] - Highest level allowed.
+ * @return None
+ */
+void setSimdLevelLimit(const SimdLevel level);
@@ -0,0 +1,436 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.0
+ *          - 1.0.0 - Added read ahead of whole files.
+ *
+ * @desc Reads whole files ahead of their processing with a bounded number of
+ *       reads and bytes in flight, through io_uring where the kernel offers it
+ *       and reader threads otherwise.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include "FilePrefetcher.h"
+#include "BitmapIO.h"
+
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define DIP_IO_URING
+#endif
+#endif
+
+#ifdef DIP_IO_URING
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+static const size_t READ_CHUNK = 8u << 20;				//Largest single read of the ring
+
+#ifdef DIP_IO_URING
+
+/*! Minimal io_uring instance for positional reads, used by one thread only */
+class IoRing {
+
+	public:
+		IoRing() : ringFd(-1), sqMap(0), cqMap(0), sqSize(0), cqSize(0), sqes(0), pending(0) { }
+
+		~IoRing() {
+			if(sqes) { munmap(sqes, sqeSize); }
+			if(cqMap && cqMap != sqMap) { munmap(cqMap, cqSize); }
+			if(sqMap) { munmap(sqMap, sqSize); }
+			if(ringFd >= 0) { close(ringFd); }
+		}
+
+		/*!
+		 * @brief Creates the instance, fails on kernels without io_uring or where
+		 *        it is disabled.
+		 * @param [int] - Number of reads in flight.
+		 * @return [boolean] - Set if the ring is usable otherwise reset.
+		 */
+		bool open(const uint32_t entries) {
+			struct io_uring_params params;
+			memset(&params, 0, sizeof(params));
+			ringFd = (int)syscall(__NR_io_uring_setup, entries, &params);
+			if(ringFd < 0) { return false; }
+
+			//Mapping the submission and completion rings, one mapping holds both on newer kernels.
+			sqSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+			cqSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+			bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+			if(single && cqSize > sqSize) { sqSize = cqSize; }
+
+			void *map = mmap(0, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+			if(map == MAP_FAILED) { return false; }
+			sqMap = (uint8_t *)map;
+			if(single) {
+				cqMap = sqMap;
+			} else {
+				map = mmap(0, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+				if(map == MAP_FAILED) { return false; }
+				cqMap = (uint8_t *)map;
+			}
+			sqeSize = params.sq_entries * sizeof(struct io_uring_sqe);
+			map = mmap(0, sqeSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+			if(map == MAP_FAILED) { sqes = 0; return false; }
+			sqes = (struct io_uring_sqe *)map;
+
+			sqTail = (uint32_t *)(sqMap + params.sq_off.tail);
+			sqMask = *(uint32_t *)(sqMap + params.sq_off.ring_mask);
+			sqArray = (uint32_t *)(sqMap + params.sq_off.array);
+			cqHead = (uint32_t *)(cqMap + params.cq_off.head);
+			cqTail = (uint32_t *)(cqMap + params.cq_off.tail);
+			cqMask = *(uint32_t *)(cqMap + params.cq_off.ring_mask);
+			cqes = (struct io_uring_cqe *)(cqMap + params.cq_off.cqes);
+			return true;
+		}
+
+		/*!
+		 * @brief Queues a vectored read, submitted by the next wait().
+		 * @param [int] - File descriptor.
+		 * @param [iovec] - Buffer, must stay valid until the read completes.
+		 * @param [int] - File offset.
+		 * @param [int] - Value returned with the completion.
+		 * @return None
+		 */
+		void read(const int fd, const struct iovec *iov, const uint64_t offset, const uint64_t tag) {
+			uint32_t tail = *sqTail;
+			uint32_t index = tail & sqMask;
+			struct io_uring_sqe *sqe = &sqes[index];
+			memset(sqe, 0, sizeof(*sqe));
+			sqe->opcode = IORING_OP_READV;
+			sqe->fd = fd;
+			sqe->addr = (uint64_t)(uintptr_t)iov;
+			sqe->len = 1;
+			sqe->off = offset;
+			sqe->user_data = tag;
+			sqArray[index] = index;
+			__atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+			pending++;
+		}
+
+		/*!
+		 * @brief Submits the queued reads and waits for at least one completion.
+		 * @param None
+		 * @return [boolean] - Set if the kernel accepted the call otherwise reset.
+		 */
+		bool wait(void) {
+			while(true) {
+				int done = (int)syscall(__NR_io_uring_enter, ringFd, pending, 1, IORING_ENTER_GETEVENTS, 0, 0);
+				if(done >= 0) { pending -= ((uint32_t)done < pending) ? (uint32_t)done : pending; return true; }
+				if(errno != EINTR && errno != EAGAIN && errno != EBUSY) { return false; }
+			}
+		}
+
+		/*!
+		 * @brief Takes one completion if there is one.
+		 * @param [int] - Receives the tag of the read.
+		 * @param [int] - Receives the bytes read or a negative error number.
+		 * @return [boolean] - Set if a completion is taken otherwise reset.
+		 */
+		bool complete(uint64_t &tag, int32_t &res) {
+			uint32_t head = *cqHead;
+			if(head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) { return false; }
+			const struct io_uring_cqe *cqe = &cqes[head & cqMask];
+			tag = cqe->user_data;
+			res = cqe->res;
+			__atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+			return true;
+		}
+
+	private:
+		IoRing(const IoRing &);
+		IoRing &operator=(const IoRing &);
+
+		int ringFd;
+		uint8_t *sqMap;
+		uint8_t *cqMap;
+		size_t sqSize;
+		size_t cqSize;
+		size_t sqeSize;
+		struct io_uring_sqe *sqes;
+		uint32_t *sqTail;
+		uint32_t *sqArray;
+		uint32_t sqMask;
+		uint32_t *cqHead;
+		uint32_t *cqTail;
+		uint32_t cqMask;
+		struct io_uring_cqe *cqes;
+		uint32_t pending;						/*! Reads queued but not submitted yet */
+};
+
+#else
+
+/*! Stand-in where io_uring is not available, reader threads are used instead */
+class IoRing {
+
+	public:
+		inline bool open(const uint32_t entries) { (void)entries; return false; }
+};
+
+#endif
+
+FilePrefetcher::FilePrefetcher() {
+	nextName = 0;
+	published = 0;
+	limit = 0;
+	reserved = 0;
+	depth = 1;
+	stopping = false;
+	usingRing = false;
+}
+
+FilePrefetcher::~FilePrefetcher() {
+	stop();
+}
+
+bool FilePrefetcher::start(const std::vector<std::string> &fileNames, const uint32_t depth, const size_t byteLimit,
+	const bool allowRing) {
+	stop();
+
+	names = fileNames;
+	nextName = 0;
+	published = 0;
+	limit = byteLimit;
+	reserved = 0;
+	this->depth = depth ? depth : 1;
+	stopping = false;
+	ready.clear();
+
+	//One thread drives the ring, otherwise every read in flight has its own thread.
+	usingRing = false;
+	if(allowRing) {
+		ring.reset(new IoRing());
+		usingRing = ring->open(this->depth);
+		if(!usingRing) { ring.reset(); }
+	}
+
+	try {
+		if(usingRing) {
+			readers.emplace_back(&FilePrefetcher::ringLoop, this);
+		} else {
+			for(uint32_t i = 0; i < this->depth; i++) { readers.emplace_back(&FilePrefetcher::threadLoop, this); }
+		}
+	} catch(std::exception &e) {
+		stop();
+		return false;
+	}
+	return true;
+}
+
+bool FilePrefetcher::next(PrefetchedFile &file) {
+	std::unique_lock<std::mutex> lock(stateMutex);
+	readyCond.wait(lock, [this]() { return stopping || !ready.empty() || published == names.size(); });
+	if(ready.empty()) { return false; }
+
+	file = std::move(ready.front());
+	ready.pop_front();
+	return true;
+}
+
+void FilePrefetcher::release(const size_t bytes) {
+	std::lock_guard<std::mutex> lock(stateMutex);
+	reserved -= (bytes < reserved) ? bytes : reserved;
+	budgetCond.notify_all();
+}
+
+void FilePrefetcher::stop(void) {
+	{
+		std::lock_guard<std::mutex> lock(stateMutex);
+		stopping = true;
+		readyCond.notify_all();
+		budgetCond.notify_all();
+	}
+	for(std::thread &t : readers) { t.join(); }
+	readers.clear();
+	ring.reset();
+	ready.clear();
+}
+
+bool FilePrefetcher::reserve(const size_t bytes, const bool wait) {
+	std::unique_lock<std::mutex> lock(stateMutex);
+	auto fits = [&]() { return reserved == 0 || reserved + bytes <= limit; };
+	if(wait) { budgetCond.wait(lock, [&]() { return stopping || fits(); }); }
+	if(stopping || !fits()) { return false; }
+
+	reserved += bytes;
+	return true;
+}
+
+void FilePrefetcher::publish(PrefetchedFile &&file) {
+	std::lock_guard<std::mutex> lock(stateMutex);
+	ready.push_back(std::move(file));
+	published++;
+	if(published == names.size()) { readyCond.notify_all(); } else { readyCond.notify_one(); }
+}
+
+void FilePrefetcher::threadLoop(void) {
+	while(true) {
+		size_t index;
+		{
+			std::lock_guard<std::mutex> lock(stateMutex);
+			if(stopping || nextName >= names.size()) { return; }
+			index = nextName++;
+		}
+
+		PrefetchedFile file;
+		file.index = (uint32_t)index;
+		file.bytes = 0;
+
+		FileReader reader;
+		if(reader.open(names[index].c_str()) && reader.getSize() > 0 && reader.getSize() <= SIZE_MAX) {
+			size_t size = (size_t)reader.getSize();
+			if(!reserve(size, true)) { return; }
+
+			PixelBuffer buffer = BufferPool::getShared().acquire(size);
+			if(reader.read(0, buffer.data(), size)) {
+				file.bytes = size;
+				file.data = std::make_shared<PixelBuffer>(std::move(buffer));
+			} else {
+				release(size);
+			}
+		}
+		publish(std::move(file));
+	}
+}
+
+#ifdef DIP_IO_URING
+
+void FilePrefetcher::ringLoop(void) {
+	//A slot per read in flight, each reads its file in chunks until it is complete.
+	struct ReadSlot {
+		int fd;
+		uint64_t done;
+		struct iovec iov;
+		PrefetchedFile file;
+	};
+	std::vector<ReadSlot> slots(depth);
+	std::vector<uint32_t> idle;
+	for(uint32_t i = 0; i < depth; i++) { slots[i].fd = -1; idle.push_back(depth - 1 - i); }
+
+	auto queueChunk = [&](const uint32_t s) {
+		ReadSlot &slot = slots[s];
+		size_t remaining = slot.file.bytes - (size_t)slot.done;
+		slot.iov.iov_base = slot.file.data->data() + slot.done;
+		slot.iov.iov_len = (remaining < READ_CHUNK) ? remaining : READ_CHUNK;
+		ring->read(slot.fd, &slot.iov, slot.done, s);
+	};
+
+	auto finish = [&](const uint32_t s, const bool ok) {
+		ReadSlot &slot = slots[s];
+		close(slot.fd);
+		slot.fd = -1;
+		if(!ok) {
+			release(slot.file.bytes);
+			slot.file.bytes = 0;
+			slot.file.data.reset();
+		}
+		publish(std::move(slot.file));
+		idle.push_back(s);
+	};
+
+	while(true) {
+		//Starting further files while slots are free, waiting for bytes only when nothing is in flight.
+		while(!idle.empty()) {
+			size_t index;
+			{
+				std::lock_guard<std::mutex> lock(stateMutex);
+				if(stopping || nextName >= names.size()) { break; }
+				index = nextName;
+			}
+
+			PrefetchedFile file;
+			file.index = (uint32_t)index;
+			file.bytes = 0;
+
+			struct stat st;
+			int fd = -1;
+			if(stat(names[index].c_str(), &st) == 0 && st.st_size > 0 && (uint64_t)st.st_size <= SIZE_MAX) {
+				if(!reserve((size_t)st.st_size, idle.size() == depth)) { break; }
+				file.bytes = (size_t)st.st_size;
+				fd = ::open(names[index].c_str(), O_RDONLY);
+				if(fd < 0) { release(file.bytes); file.bytes = 0; }
+			}
+			{
+				std::lock_guard<std::mutex> lock(stateMutex);
+				nextName++;
+			}
+			if(fd < 0) { publish(std::move(file)); continue; }
+
+			uint32_t s = idle.back();
+			idle.pop_back();
+			slots[s].fd = fd;
+			slots[s].done = 0;
+			slots[s].file = std::move(file);
+			slots[s].file.data = std::make_shared<PixelBuffer>(BufferPool::getShared().acquire(slots[s].file.bytes));
+			queueChunk(s);
+		}
+		if(idle.size() == depth) {
+			std::lock_guard<std::mutex> lock(stateMutex);
+			if(stopping || nextName >= names.size()) { break; }
+			continue;
+		}
+
+		if(!ring->wait()) {
+			//The kernel refused the ring, files in flight are completed with blocking
+			//reads and the remaining ones are read like without a ring.
+			for(uint32_t s = 0; s < depth; s++) {
+				if(slots[s].fd < 0) { continue; }
+				size_t size = slots[s].file.bytes;
+				uint8_t *data = slots[s].file.data->data();
+				while(slots[s].done < size) {
+					ssize_t done = pread(slots[s].fd, data + slots[s].done, size - (size_t)slots[s].done, (off_t)slots[s].done);
+					if(done < 0 && errno == EINTR) { continue; }
+					if(done <= 0) { break; }
+					slots[s].done += (uint64_t)done;
+				}
+				finish(s, slots[s].done == size);
+			}
+			threadLoop();
+			return;
+		}
+
+		uint64_t tag;
+		int32_t res;
+		while(ring->complete(tag, res)) {
+			uint32_t s = (uint32_t)tag;
+			if(res == -EINTR || res == -EAGAIN) { queueChunk(s); continue; }
+			if(res <= 0) { finish(s, false); continue; }
+
+			slots[s].done += (uint64_t)res;
+			if(slots[s].done < slots[s].file.bytes) { queueChunk(s); } else { finish(s, true); }
+		}
+	}
+}
+
+#else
+
+void FilePrefetcher::ringLoop(void) {
+	threadLoop();
+}
+
+#endif
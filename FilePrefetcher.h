@@ -0,0 +1,152 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.0
+ *          - 1.0.0 - Added read ahead of whole files.
+ *
+ * @desc Reads whole files ahead of their processing with a bounded number of
+ *       reads and bytes in flight, through io_uring where the kernel offers it
+ *       and reader threads otherwise.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BufferPool.h"
+
+class IoRing;
+
+/*! One file read ahead of its processing */
+struct PrefetchedFile {
+	uint32_t index;						/*! Position of the file in the list given to start() */
+	size_t bytes;						/*! Bytes reserved for the file, to be released */
+	std::shared_ptr<PixelBuffer> data;	/*! Contents of the file, null if it could not be read */
+};
+
+class FilePrefetcher {
+
+	public:
+		/*!
+		 * @brief Constructor of the class initializing all the data variable(s).
+		 */
+		FilePrefetcher();
+
+		/*!
+		 * @brief Destructor, stops reading and waits for the readers.
+		 */
+		virtual ~FilePrefetcher();
+
+		/*!
+		 * @brief Starts reading the files in list order. At most 'depth' reads are
+		 *        in flight and a read waits while the bytes read but not released
+		 *        would exceed the limit (a single file larger than it is read alone).
+		 * @param [vector] - Names of the files.
+		 * @param [int] - Number of reads in flight, at least 1.
+		 * @param [int] - Limit of the bytes held by read files.
+		 * @param [boolean] - Set to use io_uring if available, reset for reader threads.
+		 * @return [boolean] - Set if reading is started otherwise reset.
+		 */
+		bool start(const std::vector<std::string> &fileNames, const uint32_t depth, const size_t byteLimit,
+			const bool allowRing = true);
+
+		/*!
+		 * @brief Waits for the next file read, files come in the order their reads
+		 *        complete. May be called from several threads.
+		 * @param [PrefetchedFile] - Receives the file.
+		 * @return [boolean] - Set if a file is returned, reset once every file has been.
+		 */
+		bool next(PrefetchedFile &file);
+
+		/*!
+		 * @brief Gives back the bytes of a file once it is done with, so further
+		 *        reads can start.
+		 * @param [int] - Bytes of the file (PrefetchedFile::bytes).
+		 * @return None
+		 */
+		void release(const size_t bytes);
+
+		/*!
+		 * @brief Stops reading and waits for the readers, files not taken yet are dropped.
+		 * @param None
+		 * @return None
+		 */
+		void stop(void);
+
+		//GETTERS
+
+		inline bool isUsingRing(void) const { return usingRing; }
+
+	private:
+		FilePrefetcher(const FilePrefetcher &);
+		FilePrefetcher &operator=(const FilePrefetcher &);
+
+		/*!
+		 * @brief Reads files with blocking positional reads, one of 'depth' threads.
+		 */
+		void threadLoop(void);
+
+		/*!
+		 * @brief Keeps up to 'depth' reads queued on the io_uring instance, the only
+		 *        reader thread.
+		 */
+		void ringLoop(void);
+
+		/*!
+		 * @brief Reserves bytes for a file within the limit.
+		 * @param [int] - Bytes of the file.
+		 * @param [boolean] - Set to wait for released bytes, reset to fail instead.
+		 * @return [boolean] - Set if reserved, reset if not (or reading is stopped).
+		 */
+		bool reserve(const size_t bytes, const bool wait);
+
+		/*!
+		 * @brief Hands a read (or failed) file to next().
+		 * @param [PrefetchedFile] - File to be handed over.
+		 * @return None
+		 */
+		void publish(PrefetchedFile &&file);
+
+		std::vector<std::string> names;
+		size_t nextName;						/*! Index of the next file to be read */
+		size_t published;						/*! Files handed to next() so far */
+		size_t limit;
+		size_t reserved;						/*! Bytes of files not released yet */
+		uint32_t depth;
+		bool stopping;
+		bool usingRing;
+
+		std::deque<PrefetchedFile> ready;
+		std::vector<std::thread> readers;
+		std::unique_ptr<IoRing> ring;			/*! io_uring instance, null with reader threads */
+		std::mutex stateMutex;
+		std::condition_variable readyCond;		/*! Signals next() */
+		std::condition_variable budgetCond;		/*! Signals reserve() */
+};
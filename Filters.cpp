@@ -0,0 +1,526 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.0
+ *          - 1.0.0 - Added convolution, gaussian, box, gradient and median filters.
+ *
+ * @desc Neighbourhood filters on 8 bit gray planes in fixed point arithmetic,
+ *       with AVX2 kernels selected at runtime, column tiles and row bands run
+ *       in parallel. Borders replicate the outermost pixels.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include "Filters.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <vector>
+
+#include "CpuFeatures.h"
+#include "ThreadPool.h"
+
+#ifdef BITMAP_X86
+#include <immintrin.h>
+#endif
+
+static const int32_t GAUSS_ONE			= 1 << 14;		//Q14 weight sum of the gaussian taps
+static const int32_t GAUSS_MID_SHIFT	= 7;			//Vertical pass output is Q7
+static const int32_t CONV_SHIFT			= 10;			//Q10 weights of generic kernels
+static const uint32_t ROW_SLACK			= 32;			//Extra elements read past the end by vector loads
+
+//Compare exchange pairs of the 3x3 median network, the median ends up in 4.
+static const uint8_t MEDIAN9_PAIRS[19][2] = {
+	{ 1, 2 }, { 4, 5 }, { 7, 8 }, { 0, 1 }, { 3, 4 }, { 6, 7 }, { 1, 2 }, { 4, 5 }, { 7, 8 }, { 0, 3 },
+	{ 5, 8 }, { 4, 7 }, { 3, 6 }, { 1, 4 }, { 2, 5 }, { 4, 7 }, { 4, 2 }, { 6, 4 }, { 4, 2 }
+};
+
+/*!
+ * @brief Clamps a row or column index into [0, count).
+ */
+static inline uint32_t clampIndex(const int64_t index, const uint32_t count) {
+	if(index < 0) { return 0; }
+	if(index >= (int64_t)count) { return count - 1; }
+	return (uint32_t)index;
+}
+
+/*!
+ * @brief Clips a value into the 8 bit range.
+ */
+static inline uint8_t clip8(const int32_t value) {
+	return (uint8_t)((value < 0) ? 0 : (value > 255) ? 255 : value);
+}
+
+/*!
+ * @brief Checks whether the AVX2 kernels may be used.
+ */
+static inline bool useAvx2(void) {
+#ifdef BITMAP_X86
+	return getSimdLevel() >= SIMD_AVX2;
+#else
+	return false;
+#endif
+}
+
+#ifdef BITMAP_X86
+
+/*!
+ * @brief Vertical gaussian pass of 16 columns per iteration, pairs of rows are
+ *        interleaved so one madd applies two taps.
+ * @return [int] - Number of columns done.
+ */
+SIMD_TARGET("avx2")
+static uint32_t verticalRowAvx2(const uint8_t *const *rows, const uint32_t taps, const int16_t *weights,
+	int16_t *out, const uint32_t count) {
+	const __m256i round = _mm256_set1_epi32(1 << (GAUSS_MID_SHIFT - 1));
+	uint32_t j = 0;
+	for(; j + 16 <= count; j += 16) {
+		__m256i lo = _mm256_setzero_si256(), hi = _mm256_setzero_si256();
+		for(uint32_t k = 0; k < taps; k += 2) {
+			__m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(rows[k] + j)));
+			__m256i b = _mm256_setzero_si256();
+			int16_t wb = 0;
+			if(k + 1 < taps) {
+				b = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(rows[k + 1] + j)));
+				wb = weights[k + 1];
+			}
+			__m256i w = _mm256_set1_epi32((uint16_t)weights[k] | ((uint32_t)(uint16_t)wb << 16));
+			lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), w));
+			hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), w));
+		}
+		lo = _mm256_srai_epi32(_mm256_add_epi32(lo, round), GAUSS_MID_SHIFT);
+		hi = _mm256_srai_epi32(_mm256_add_epi32(hi, round), GAUSS_MID_SHIFT);
+
+		//Packing per lane undoes the per lane unpacks.
+		_mm256_storeu_si256((__m256i *)(out + j), _mm256_packs_epi32(lo, hi));
+	}
+	return j;
+}
+
+/*!
+ * @brief Horizontal taps of 16 outputs per iteration, neighbouring inputs are
+ *        interleaved so one madd applies two taps. The sums are added to 'acc'.
+ * @return [int] - Number of outputs done.
+ */
+SIMD_TARGET("avx2")
+static uint32_t accumulateRowAvx2(const int16_t *src, const uint32_t taps, const int16_t *weights,
+	int32_t *acc, const uint32_t count) {
+	uint32_t j = 0;
+	for(; j + 16 <= count; j += 16) {
+		__m256i lo = _mm256_setzero_si256(), hi = _mm256_setzero_si256();
+		for(uint32_t k = 0; k < taps; k += 2) {
+			__m256i a = _mm256_loadu_si256((const __m256i *)(src + j + k));
+			__m256i b = _mm256_loadu_si256((const __m256i *)(src + j + k + 1));
+			int16_t wb = (k + 1 < taps) ? weights[k + 1] : 0;
+			__m256i w = _mm256_set1_epi32((uint16_t)weights[k] | ((uint32_t)(uint16_t)wb << 16));
+			lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), w));
+			hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), w));
+		}
+
+		//lo holds outputs 0-3 and 8-11, hi 4-7 and 12-15.
+		__m256i first = _mm256_permute2x128_si256(lo, hi, 0x20);
+		__m256i second = _mm256_permute2x128_si256(lo, hi, 0x31);
+		__m256i *a0 = (__m256i *)(acc + j);
+		__m256i *a1 = (__m256i *)(acc + j + 8);
+		_mm256_storeu_si256(a0, _mm256_add_epi32(_mm256_loadu_si256(a0), first));
+		_mm256_storeu_si256(a1, _mm256_add_epi32(_mm256_loadu_si256(a1), second));
+	}
+	return j;
+}
+
+/*!
+ * @brief 3x3 gradient of 16 interior pixels per iteration.
+ * @return [int] - Number of pixels done.
+ */
+SIMD_TARGET("avx2")
+static uint32_t gradientRowAvx2(const uint8_t *r0, const uint8_t *r1, const uint8_t *r2, uint8_t *out,
+	const uint32_t count, const int16_t side, const int16_t center, const GradientOutput output) {
+	const __m256i ws = _mm256_set1_epi16(side);
+	const __m256i wc = _mm256_set1_epi16(center);
+	uint32_t j = 0;
+	for(; j + 16 <= count; j += 16) {
+		//Inputs are columns j - 1, j and j + 1 relative to 'out'.
+		__m256i a0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(r0 + j - 1)));
+		__m256i a1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(r0 + j)));
+		__m256i a2 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(r0 + j + 1)));
+		__m256i b0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(r1 + j - 1)));
+		__m256i b2 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(r1 + j + 1)));
+		__m256i c0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(r2 + j - 1)));
+		__m256i c1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(r2 + j)));
+		__m256i c2 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(r2 + j + 1)));
+
+		__m256i gx = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_add_epi16(_mm256_sub_epi16(a2, a0), _mm256_sub_epi16(c2, c0)), ws),
+			_mm256_mullo_epi16(_mm256_sub_epi16(b2, b0), wc));
+		__m256i gy = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_add_epi16(_mm256_sub_epi16(c0, a0), _mm256_sub_epi16(c2, a2)), ws),
+			_mm256_mullo_epi16(_mm256_sub_epi16(c1, a1), wc));
+
+		__m256i value;
+		if(output == GRADIENT_X) {
+			value = _mm256_abs_epi16(gx);
+		} else if(output == GRADIENT_Y) {
+			value = _mm256_abs_epi16(gy);
+		} else {
+			__m256i lo = _mm256_unpacklo_epi16(gx, gy);
+			__m256i hi = _mm256_unpackhi_epi16(gx, gy);
+			lo = _mm256_cvtps_epi32(_mm256_sqrt_ps(_mm256_cvtepi32_ps(_mm256_madd_epi16(lo, lo))));
+			hi = _mm256_cvtps_epi32(_mm256_sqrt_ps(_mm256_cvtepi32_ps(_mm256_madd_epi16(hi, hi))));
+			value = _mm256_packs_epi32(lo, hi);
+		}
+
+		__m256i bytes = _mm256_permute4x64_epi64(_mm256_packus_epi16(value, value), 0xD8);
+		_mm_storeu_si128((__m128i *)(out + j), _mm256_castsi256_si128(bytes));
+	}
+	return j;
+}
+
+/*!
+ * @brief 3x3 median of 32 interior pixels per iteration with the sorting network.
+ * @return [int] - Number of pixels done.
+ */
+SIMD_TARGET("avx2")
+static uint32_t median3RowAvx2(const uint8_t *r0, const uint8_t *r1, const uint8_t *r2, uint8_t *out, const uint32_t count) {
+	uint32_t j = 0;
+	for(; j + 32 <= count; j += 32) {
+		__m256i p[9];
+		const uint8_t *rows[3] = { r0, r1, r2 };
+		for(uint32_t k = 0; k < 3; k++) {
+			p[k * 3] = _mm256_loadu_si256((const __m256i *)(rows[k] + j - 1));
+			p[k * 3 + 1] = _mm256_loadu_si256((const __m256i *)(rows[k] + j));
+			p[k * 3 + 2] = _mm256_loadu_si256((const __m256i *)(rows[k] + j + 1));
+		}
+		for(uint32_t k = 0; k < 19; k++) {
+			__m256i a = p[MEDIAN9_PAIRS[k][0]], b = p[MEDIAN9_PAIRS[k][1]];
+			p[MEDIAN9_PAIRS[k][0]] = _mm256_min_epu8(a, b);
+			p[MEDIAN9_PAIRS[k][1]] = _mm256_max_epu8(a, b);
+		}
+		_mm256_storeu_si256((__m256i *)(out + j), p[4]);
+	}
+	return j;
+}
+
+#endif
+
+/*!
+ * @brief Vertical gaussian pass of one row of the tile, Q14 weights give a Q7 result.
+ */
+static void verticalRow(const uint8_t *const *rows, const uint32_t taps, const int16_t *weights, int16_t *out,
+	const uint32_t count, const bool avx2) {
+	uint32_t j = 0;
+#ifdef BITMAP_X86
+	if(avx2) { j = verticalRowAvx2(rows, taps, weights, out, count); }
+#else
+	(void)avx2;
+#endif
+	for(; j < count; j++) {
+		int32_t acc = 0;
+		for(uint32_t k = 0; k < taps; k++) { acc += weights[k] * rows[k][j]; }
+		out[j] = (int16_t)((acc + (1 << (GAUSS_MID_SHIFT - 1))) >> GAUSS_MID_SHIFT);
+	}
+}
+
+/*!
+ * @brief Adds the horizontal taps over the padded row to the accumulators.
+ */
+static void accumulateRow(const int16_t *src, const uint32_t taps, const int16_t *weights, int32_t *acc,
+	const uint32_t count, const bool avx2) {
+	uint32_t j = 0;
+#ifdef BITMAP_X86
+	if(avx2) { j = accumulateRowAvx2(src, taps, weights, acc, count); }
+#else
+	(void)avx2;
+#endif
+	for(; j < count; j++) {
+		int32_t sum = 0;
+		for(uint32_t k = 0; k < taps; k++) { sum += weights[k] * src[j + k]; }
+		acc[j] += sum;
+	}
+}
+
+/*!
+ * @brief Rounds the fixed point accumulators into pixels.
+ */
+static void finishRow(const int32_t *acc, uint8_t *out, const uint32_t count, const int32_t shift, const int32_t bias) {
+	const int32_t round = 1 << (shift - 1);
+	for(uint32_t j = 0; j < count; j++) { out[j] = clip8(((acc[j] + round) >> shift) + bias); }
+}
+
+bool convolvePlane(const uint8_t *src, const uint32_t width, const uint32_t height, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const float *kernel, const uint32_t size, const int32_t bias) {
+	if(size == 0 || (size & 1) == 0 || size > FILTER_MAX_SIZE || width == 0 || height == 0) { return false; }
+
+	//Q10 weights, one row of taps per kernel row.
+	std::vector<int16_t> weights(size * size);
+	for(uint32_t i = 0; i < size * size; i++) {
+		long w = lround(kernel[i] * (1 << CONV_SHIFT));
+		weights[i] = (int16_t)((w > 32767) ? 32767 : (w < -32767) ? -32767 : w);
+	}
+
+	int32_t radius = (int32_t)size / 2;
+	bool avx2 = useAvx2();
+
+	ThreadPool::getShared().parallelFor(0, height, FILTER_BAND_ROWS, [&](uint32_t first, uint32_t last) {
+		std::vector<int16_t> padded(FILTER_TILE_COLS + 2 * radius + ROW_SLACK, 0);
+		std::vector<int32_t> acc(FILTER_TILE_COLS + ROW_SLACK);
+
+		for(uint32_t x0 = 0; x0 < width; x0 += FILTER_TILE_COLS) {
+			uint32_t count = (width - x0 < FILTER_TILE_COLS) ? width - x0 : FILTER_TILE_COLS;
+
+			for(uint32_t y = first; y < last; y++) {
+				memset(acc.data(), 0, count * sizeof(int32_t));
+				for(uint32_t ky = 0; ky < size; ky++) {
+					//Widening the tile of the source row with replicated borders.
+					const uint8_t *in = src + (size_t)clampIndex((int64_t)y + ky - radius, height) * srcStride;
+					for(uint32_t t = 0; t < count + 2 * radius; t++) {
+						padded[t] = in[clampIndex((int64_t)x0 + t - radius, width)];
+					}
+					accumulateRow(padded.data(), size, &weights[ky * size], acc.data(), count, avx2);
+				}
+				finishRow(acc.data(), dst + (size_t)y * dstStride + x0, count, CONV_SHIFT, bias);
+			}
+		}
+	});
+	return true;
+}
+
+bool gaussianPlane(const uint8_t *src, const uint32_t width, const uint32_t height, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const double sigma) {
+	if(sigma <= 0.0 || width == 0 || height == 0) { return false; }
+
+	int32_t radius = (int32_t)ceil(3.0 * sigma);
+	if(radius < 1) { radius = 1; }
+	if(radius > (int32_t)FILTER_MAX_RADIUS) { return false; }
+	uint32_t taps = 2 * radius + 1;
+
+	//Q14 taps summing up to exactly one, the rounding error goes to the center.
+	std::vector<double> g(taps);
+	double total = 0.0;
+	for(uint32_t k = 0; k < taps; k++) {
+		double d = (double)k - radius;
+		g[k] = exp(-(d * d) / (2.0 * sigma * sigma));
+		total += g[k];
+	}
+	std::vector<int16_t> weights(taps);
+	int32_t sum = 0;
+	for(uint32_t k = 0; k < taps; k++) {
+		weights[k] = (int16_t)lround(g[k] / total * GAUSS_ONE);
+		sum += weights[k];
+	}
+	weights[radius] = (int16_t)(weights[radius] + GAUSS_ONE - sum);
+
+	bool avx2 = useAvx2();
+
+	//Per tile and row the vertical pass filters the columns under the tile and its
+	//margins into Q7, the horizontal pass then reads that row from L1.
+	ThreadPool::getShared().parallelFor(0, height, FILTER_BAND_ROWS, [&](uint32_t first, uint32_t last) {
+		std::vector<int16_t> column(FILTER_TILE_COLS + 2 * radius + ROW_SLACK, 0);
+		std::vector<int32_t> acc(FILTER_TILE_COLS + ROW_SLACK);
+		std::vector<const uint8_t *> rows(taps);
+
+		for(uint32_t x0 = 0; x0 < width; x0 += FILTER_TILE_COLS) {
+			uint32_t count = (width - x0 < FILTER_TILE_COLS) ? width - x0 : FILTER_TILE_COLS;
+			int64_t c0 = (int64_t)x0 - radius;
+			int64_t c1 = (int64_t)x0 + count + radius;
+			uint32_t v0 = (c0 < 0) ? 0 : (uint32_t)c0;
+			uint32_t v1 = (c1 > width) ? width : (uint32_t)c1;
+			int16_t *mid = column.data() + (v0 - c0);
+
+			for(uint32_t y = first; y < last; y++) {
+				for(uint32_t k = 0; k < taps; k++) {
+					rows[k] = src + (size_t)clampIndex((int64_t)y + k - radius, height) * srcStride + v0;
+				}
+				verticalRow(rows.data(), taps, weights.data(), mid, v1 - v0, avx2);
+
+				//Columns beyond the image replicate the border columns.
+				for(int64_t t = 0; t < (int64_t)v0 - c0; t++) { column[t] = mid[0]; }
+				for(int64_t t = v1 - c0; t < c1 - c0; t++) { column[t] = mid[v1 - v0 - 1]; }
+
+				memset(acc.data(), 0, count * sizeof(int32_t));
+				accumulateRow(column.data(), taps, weights.data(), acc.data(), count, avx2);
+				finishRow(acc.data(), dst + (size_t)y * dstStride + x0, count, 14 + GAUSS_MID_SHIFT, 0);
+			}
+		}
+	});
+	return true;
+}
+
+void boxPlane(const uint8_t *src, const uint32_t width, const uint32_t height, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const uint32_t radius) {
+	if(width == 0 || height == 0) { return; }
+
+	//Dividing by the window area through a 32 bit reciprocal.
+	uint64_t area = (uint64_t)(2 * radius + 1) * (2 * radius + 1);
+	uint64_t reciprocal = ((1ull << 32) + area / 2) / area;
+
+	ThreadPool::getShared().parallelFor(0, height, FILTER_BAND_ROWS, [&](uint32_t first, uint32_t last) {
+		//Column sums of the window rows, moved down by one row per output row.
+		std::vector<uint32_t> columns(width, 0);
+		std::vector<uint32_t> padded(width + 2 * radius + 1);
+		for(int64_t k = -(int64_t)radius; k <= (int64_t)radius; k++) {
+			const uint8_t *in = src + (size_t)clampIndex((int64_t)first + k, height) * srcStride;
+			for(uint32_t x = 0; x < width; x++) { columns[x] += in[x]; }
+		}
+
+		for(uint32_t y = first; y < last; y++) {
+			//Row sums slide over the column sums, borders are replicated.
+			for(uint32_t t = 0; t < width + 2 * radius + 1; t++) {
+				padded[t] = columns[clampIndex((int64_t)t - radius, width)];
+			}
+			uint64_t sum = 0;
+			for(uint32_t t = 0; t < 2 * radius + 1; t++) { sum += padded[t]; }
+
+			uint8_t *out = dst + (size_t)y * dstStride;
+			for(uint32_t x = 0; x < width; x++) {
+				out[x] = (uint8_t)((sum * reciprocal + (1ull << 31)) >> 32);
+				sum += padded[x + 2 * radius + 1] - (uint64_t)padded[x];
+			}
+
+			if(y + 1 < last) {
+				const uint8_t *enter = src + (size_t)clampIndex((int64_t)y + radius + 1, height) * srcStride;
+				const uint8_t *leave = src + (size_t)clampIndex((int64_t)y - radius, height) * srcStride;
+				for(uint32_t x = 0; x < width; x++) { columns[x] += (uint32_t)enter[x] - leave[x]; }
+			}
+		}
+	});
+}
+
+void gradientPlane(const uint8_t *src, const uint32_t width, const uint32_t height, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const GradientOperator op, const GradientOutput output) {
+	if(width == 0 || height == 0) { return; }
+
+	int16_t side = (op == GRADIENT_SCHARR) ? 3 : 1;
+	int16_t center = (op == GRADIENT_SCHARR) ? 10 : 2;
+	bool avx2 = useAvx2();
+
+	ThreadPool::getShared().parallelFor(0, height, FILTER_BAND_ROWS, [&](uint32_t first, uint32_t last) {
+		for(uint32_t y = first; y < last; y++) {
+			const uint8_t *r0 = src + (size_t)clampIndex((int64_t)y - 1, height) * srcStride;
+			const uint8_t *r1 = src + (size_t)y * srcStride;
+			const uint8_t *r2 = src + (size_t)clampIndex((int64_t)y + 1, height) * srcStride;
+			uint8_t *out = dst + (size_t)y * dstStride;
+
+			auto pixel = [&](uint32_t x) {
+				uint32_t xl = clampIndex((int64_t)x - 1, width), xr = clampIndex((int64_t)x + 1, width);
+				int32_t gx = side * ((r0[xr] - r0[xl]) + (r2[xr] - r2[xl])) + center * (r1[xr] - r1[xl]);
+				int32_t gy = side * ((r2[xl] - r0[xl]) + (r2[xr] - r0[xr])) + center * (r2[x] - r0[x]);
+				int32_t value;
+				if(output == GRADIENT_X) { value = abs(gx); }
+				else if(output == GRADIENT_Y) { value = abs(gy); }
+				else { value = (int32_t)lrintf(sqrtf((float)(gx * gx + gy * gy))); }
+				out[x] = clip8(value);
+			};
+
+			//Interior columns go through the vector kernel, border columns clamp.
+			uint32_t x = 0;
+			pixel(x++);
+#ifdef BITMAP_X86
+			if(avx2 && width > 2) { x += gradientRowAvx2(r0 + 1, r1 + 1, r2 + 1, out + 1, width - 2, side, center, output); }
+#else
+			(void)avx2;
+#endif
+			for(; x < width; x++) { pixel(x); }
+		}
+	});
+}
+
+/*!
+ * @brief Median of the window with a sliding histogram (Huang), the histogram
+ *        moves by one column per pixel and the median by the change in counts.
+ */
+static void medianRowHistogram(const uint8_t *src, const uint32_t width, const uint32_t height, const uint32_t srcStride,
+	uint8_t *out, const uint32_t y, const uint32_t radius) {
+	uint32_t histogram[256];
+	memset(histogram, 0, sizeof(histogram));
+
+	int64_t r = radius;
+	uint32_t half = ((2 * radius + 1) * (2 * radius + 1)) / 2;
+	std::vector<const uint8_t *> rows(2 * radius + 1);
+	for(int64_t k = -r; k <= r; k++) { rows[k + r] = src + (size_t)clampIndex((int64_t)y + k, height) * srcStride; }
+
+	for(const uint8_t *row : rows) {
+		for(int64_t k = -r; k <= r; k++) { histogram[row[clampIndex(k, width)]]++; }
+	}
+
+	//'below' counts the window pixels under the current median.
+	uint32_t median = 0, below = 0;
+	while(below + histogram[median] <= half) { below += histogram[median++]; }
+
+	for(uint32_t x = 0; x < width; x++) {
+		out[x] = (uint8_t)median;
+		if(x + 1 == width) { break; }
+
+		uint32_t leave = clampIndex((int64_t)x - r, width);
+		uint32_t enter = clampIndex((int64_t)x + r + 1, width);
+		for(const uint8_t *row : rows) {
+			uint8_t a = row[leave], b = row[enter];
+			histogram[a]--;
+			if(a < median) { below--; }
+			histogram[b]++;
+			if(b < median) { below++; }
+		}
+
+		while(below > half) { below -= histogram[--median]; }
+		while(below + histogram[median] <= half) { below += histogram[median++]; }
+	}
+}
+
+void medianPlane(const uint8_t *src, const uint32_t width, const uint32_t height, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const uint32_t radius) {
+	if(width == 0 || height == 0) { return; }
+	bool avx2 = useAvx2();
+
+	ThreadPool::getShared().parallelFor(0, height, FILTER_BAND_ROWS, [&](uint32_t first, uint32_t last) {
+		for(uint32_t y = first; y < last; y++) {
+			uint8_t *out = dst + (size_t)y * dstStride;
+			if(radius == 0) {
+				memcpy(out, src + (size_t)y * srcStride, width);
+				continue;
+			}
+			if(radius > 1) {
+				medianRowHistogram(src, width, height, srcStride, out, y, radius);
+				continue;
+			}
+
+			const uint8_t *r0 = src + (size_t)clampIndex((int64_t)y - 1, height) * srcStride;
+			const uint8_t *r1 = src + (size_t)y * srcStride;
+			const uint8_t *r2 = src + (size_t)clampIndex((int64_t)y + 1, height) * srcStride;
+
+			auto pixel = [&](uint32_t x) {
+				uint32_t xl = clampIndex((int64_t)x - 1, width), xr = clampIndex((int64_t)x + 1, width);
+				uint8_t p[9] = { r0[xl], r0[x], r0[xr], r1[xl], r1[x], r1[xr], r2[xl], r2[x], r2[xr] };
+				for(uint32_t k = 0; k < 19; k++) {
+					uint8_t a = p[MEDIAN9_PAIRS[k][0]], b = p[MEDIAN9_PAIRS[k][1]];
+					p[MEDIAN9_PAIRS[k][0]] = (a < b) ? a : b;
+					p[MEDIAN9_PAIRS[k][1]] = (a < b) ? b : a;
+				}
+				out[x] = p[4];
+			};
+
+			uint32_t x = 0;
+			pixel(x++);
+#ifdef BITMAP_X86
+			if(avx2 && width > 2) { x += median3RowAvx2(r0 + 1, r1 + 1, r2 + 1, out + 1, width - 2); }
+#else
+			(void)avx2;
+#endif
+			for(; x < width; x++) { pixel(x); }
+		}
+	});
+}
@@ -0,0 +1,127 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.0
+ *          - 1.0.0 - Added convolution, gaussian, box, gradient and median filters.
+ *
+ * @desc Neighbourhood filters on 8 bit gray planes in fixed point arithmetic,
+ *       with AVX2 kernels selected at runtime, column tiles and row bands run
+ *       in parallel. Borders replicate the outermost pixels.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/*! Derivative operator of gradient images */
+enum GradientOperator {
+	GRADIENT_SOBEL = 0,				/*! [1 2 1] smoothing, [-1 0 1] derivative */
+	GRADIENT_SCHARR					/*! [3 10 3] smoothing, [-1 0 1] derivative */
+};
+
+/*! Value written to a gradient image */
+enum GradientOutput {
+	GRADIENT_MAGNITUDE = 0,			/*! sqrt(gx^2 + gy^2) */
+	GRADIENT_X,						/*! |gx| */
+	GRADIENT_Y						/*! |gy| */
+};
+
+static const uint32_t FILTER_BAND_ROWS		= 16;		//Smallest row band given to a thread
+static const uint32_t FILTER_TILE_COLS		= 1024;		//Columns per tile of the separable passes
+static const uint32_t FILTER_MAX_SIZE		= 15;		//Largest side of a generic kernel
+static const uint32_t FILTER_MAX_RADIUS		= 64;		//Largest gaussian radius
+
+/*!
+ * @brief Convolves the plane with a square kernel. Weights are converted to
+ *        Q10 fixed point, so they are limited to +/-31.99.
+ *        out = clip(sum(kernel * in) + bias)
+ * @param [string] - Source plane.
+ * @param [int] - Plane width.
+ * @param [int] - Plane height.
+ * @param [int] - Source row stride in bytes.
+ * @param [string] - Destination plane, must not overlap the source.
+ * @param [int] - Destination row stride in bytes.
+ * @param [float] - Row major kernel of 'size' x 'size' weights.
+ * @param [int] - Kernel side, odd and at most FILTER_MAX_SIZE.
+ * @param [int] - Value added to every result.
+ * @return [boolean] - Set if the kernel is valid otherwise reset.
+ */
+bool convolvePlane(const uint8_t *src, const uint32_t width, const uint32_t height, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const float *kernel, const uint32_t size, const int32_t bias);
+
+/*!
+ * @brief Separable gaussian blur, the kernel reaches 3 sigma on each side.
+ * @param [string] - Source plane.
+ * @param [int] - Plane width.
+ * @param [int] - Plane height.
+ * @param [int] - Source row stride in bytes.
+ * @param [string] - Destination plane, must not overlap the source.
+ * @param [int] - Destination row stride in bytes.
+ * @param [double] - Standard deviation in pixels, up to FILTER_MAX_RADIUS / 3.
+ * @return [boolean] - Set if sigma is valid otherwise reset.
+ */
+bool gaussianPlane(const uint8_t *src, const uint32_t width, const uint32_t height, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const double sigma);
+
+/*!
+ * @brief Mean of the (2r + 1) x (2r + 1) window with running sums, the cost per
+ *        pixel does not depend on the radius.
+ * @param [string] - Source plane.
+ * @param [int] - Plane width.
+ * @param [int] - Plane height.
+ * @param [int] - Source row stride in bytes.
+ * @param [string] - Destination plane, must not overlap the source.
+ * @param [int] - Destination row stride in bytes.
+ * @param [int] - Window radius.
+ * @return None
+ */
+void boxPlane(const uint8_t *src, const uint32_t width, const uint32_t height, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const uint32_t radius);
+
+/*!
+ * @brief Gradient image of a 3x3 derivative operator, results above 255 saturate.
+ * @param [string] - Source plane.
+ * @param [int] - Plane width.
+ * @param [int] - Plane height.
+ * @param [int] - Source row stride in bytes.
+ * @param [string] - Destination plane, must not overlap the source.
+ * @param [int] - Destination row stride in bytes.
+ * @param [GradientOperator] - Operator to be used.
+ * @param [GradientOutput] - Value to be written.
+ * @return None
+ */
+void gradientPlane(const uint8_t *src, const uint32_t width, const uint32_t height, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const GradientOperator op, const GradientOutput output);
+
+/*!
+ * @brief Median of the (2r + 1) x (2r + 1) window. Radius 1 uses a vector
+ *        sorting network, larger windows a sliding histogram.
+ * @param [string] - Source plane.
+ * @param [int] - Plane width.
+ * @param [int] - Plane height.
+ * @param [int] - Source row stride in bytes.
+ * @param [string] - Destination plane, must not overlap the source.
+ * @param [int] - Destination row stride in bytes.
+ * @param [int] - Window radius.
+ * @return None
+ */
+void medianPlane(const uint8_t *src, const uint32_t width, const uint32_t height, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const uint32_t radius);
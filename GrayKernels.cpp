@@ -0,0 +1,510 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.1
+ *          - 1.0.0 - Added SIMD BGR to gray conversion kernels.
+ *          - 1.0.1 - Added BGR plane split and merge kernels.
+ *
+ * @desc Color to gray scale and BGR plane split / merge row kernels with SSE2,
+ *       SSSE3 and AVX2 variants selected at runtime and a portable scalar
+ *       fallback.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include "GrayKernels.h"
+
+#ifdef BITMAP_X86
+#include <immintrin.h>
+#endif
+
+/*! Fixed point coefficients of a luma weighting */
+struct GrayCoeffs {
+	int16_t wb;
+	int16_t wg;
+	int16_t wr;
+	int32_t bias;
+	int32_t shift;
+};
+
+//Average uses 21846 / 2^16 which equals (B + G + R) / 3 exactly for every 8 bit input,
+//weighted lumas use Q15 with rounding and weights summing up to 32768.
+static const GrayCoeffs COEFFS[3] = {
+	{ 21846, 21846, 21846, 0, 16 },		//LUMA_AVERAGE
+	{ 3736, 19234, 9798, 16384, 15 },		//LUMA_BT601
+	{ 2366, 23435, 6967, 16384, 15 }		//LUMA_BT709
+};
+
+typedef uint32_t (*GrayRowKernel)(const uint8_t *src, uint8_t *dst, const uint32_t width, const GrayCoeffs &c);
+
+/*!
+ * @brief Scalar conversion of the remaining pixels of a row.
+ */
+static void grayRowScalar(const uint8_t *src, uint8_t *dst, const uint32_t width, const uint32_t pixelBytes,
+	const GrayCoeffs &c) {
+	for(uint32_t j = 0; j < width; j++) {
+		const uint8_t *p = src + j * pixelBytes;
+		int32_t value = c.wb * p[0] + c.wg * p[1] + c.wr * p[2] + c.bias;
+		dst[j] = (uint8_t)(value >> c.shift);
+	}
+}
+
+#ifdef BITMAP_X86
+
+/*!
+ * @brief Weighs 16 deinterleaved B, G and R bytes into 16 gray bytes.
+ */
+SIMD_TARGET("sse2")
+static inline __m128i grayWeigh16(const __m128i b, const __m128i g, const __m128i r, const GrayCoeffs &c) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i wbg = _mm_set1_epi32((uint16_t)c.wb | ((uint32_t)(uint16_t)c.wg << 16));
+	const __m128i wr = _mm_set1_epi32((uint16_t)c.wr);
+	const __m128i bias = _mm_set1_epi32(c.bias);
+	const __m128i shift = _mm_cvtsi32_si128(c.shift);
+
+	__m128i b0 = _mm_unpacklo_epi8(b, zero), b1 = _mm_unpackhi_epi8(b, zero);
+	__m128i g0 = _mm_unpacklo_epi8(g, zero), g1 = _mm_unpackhi_epi8(g, zero);
+	__m128i r0 = _mm_unpacklo_epi8(r, zero), r1 = _mm_unpackhi_epi8(r, zero);
+
+	__m128i s0 = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(b0, g0), wbg), _mm_madd_epi16(_mm_unpacklo_epi16(r0, zero), wr));
+	__m128i s1 = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(b0, g0), wbg), _mm_madd_epi16(_mm_unpackhi_epi16(r0, zero), wr));
+	__m128i s2 = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(b1, g1), wbg), _mm_madd_epi16(_mm_unpacklo_epi16(r1, zero), wr));
+	__m128i s3 = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(b1, g1), wbg), _mm_madd_epi16(_mm_unpackhi_epi16(r1, zero), wr));
+
+	s0 = _mm_srl_epi32(_mm_add_epi32(s0, bias), shift);
+	s1 = _mm_srl_epi32(_mm_add_epi32(s1, bias), shift);
+	s2 = _mm_srl_epi32(_mm_add_epi32(s2, bias), shift);
+	s3 = _mm_srl_epi32(_mm_add_epi32(s3, bias), shift);
+
+	return _mm_packus_epi16(_mm_packs_epi32(s0, s1), _mm_packs_epi32(s2, s3));
+}
+
+/*!
+ * @brief SSE2 kernel, deinterleaves 16 BGR pixels with byte unpacks.
+ * @return [int] - Number of pixels converted.
+ */
+SIMD_TARGET("sse2")
+static uint32_t grayRowSse2(const uint8_t *src, uint8_t *dst, const uint32_t width, const GrayCoeffs &c) {
+	uint32_t j = 0;
+	for(; j + 16 <= width; j += 16) {
+		const uint8_t *p = src + j * 3;
+		__m128i t00 = _mm_loadu_si128((const __m128i *)p);
+		__m128i t01 = _mm_loadu_si128((const __m128i *)(p + 16));
+		__m128i t02 = _mm_loadu_si128((const __m128i *)(p + 32));
+
+		__m128i t10 = _mm_unpacklo_epi8(t00, _mm_unpackhi_epi64(t01, t01));
+		__m128i t11 = _mm_unpacklo_epi8(_mm_unpackhi_epi64(t00, t00), t02);
+		__m128i t12 = _mm_unpacklo_epi8(t01, _mm_unpackhi_epi64(t02, t02));
+
+		__m128i t20 = _mm_unpacklo_epi8(t10, _mm_unpackhi_epi64(t11, t11));
+		__m128i t21 = _mm_unpacklo_epi8(_mm_unpackhi_epi64(t10, t10), t12);
+		__m128i t22 = _mm_unpacklo_epi8(t11, _mm_unpackhi_epi64(t12, t12));
+
+		__m128i t30 = _mm_unpacklo_epi8(t20, _mm_unpackhi_epi64(t21, t21));
+		__m128i t31 = _mm_unpacklo_epi8(_mm_unpackhi_epi64(t20, t20), t22);
+		__m128i t32 = _mm_unpacklo_epi8(t21, _mm_unpackhi_epi64(t22, t22));
+
+		__m128i b = _mm_unpacklo_epi8(t30, _mm_unpackhi_epi64(t31, t31));
+		__m128i g = _mm_unpacklo_epi8(_mm_unpackhi_epi64(t30, t30), t32);
+		__m128i r = _mm_unpacklo_epi8(t31, _mm_unpackhi_epi64(t32, t32));
+
+		_mm_storeu_si128((__m128i *)(dst + j), grayWeigh16(b, g, r, c));
+	}
+	return j;
+}
+
+//pshufb masks picking B, G and R of 16 pixels out of three consecutive 16 byte loads.
+#define M_ 0x80
+static const uint8_t SHUF_B[3][16] = {
+	{ 0, 3, 6, 9, 12, 15, M_, M_, M_, M_, M_, M_, M_, M_, M_, M_ },
+	{ M_, M_, M_, M_, M_, M_, 2, 5, 8, 11, 14, M_, M_, M_, M_, M_ },
+	{ M_, M_, M_, M_, M_, M_, M_, M_, M_, M_, M_, 1, 4, 7, 10, 13 }
+};
+static const uint8_t SHUF_G[3][16] = {
+	{ 1, 4, 7, 10, 13, M_, M_, M_, M_, M_, M_, M_, M_, M_, M_, M_ },
+	{ M_, M_, M_, M_, M_, 0, 3, 6, 9, 12, 15, M_, M_, M_, M_, M_ },
+	{ M_, M_, M_, M_, M_, M_, M_, M_, M_, M_, M_, 2, 5, 8, 11, 14 }
+};
+static const uint8_t SHUF_R[3][16] = {
+	{ 2, 5, 8, 11, 14, M_, M_, M_, M_, M_, M_, M_, M_, M_, M_, M_ },
+	{ M_, M_, M_, M_, M_, 1, 4, 7, 10, 13, M_, M_, M_, M_, M_, M_ },
+	{ M_, M_, M_, M_, M_, M_, M_, M_, M_, M_, 0, 3, 6, 9, 12, 15 }
+};
+#undef M_
+
+/*!
+ * @brief SSSE3 kernel, deinterleaves 16 BGR pixels with pshufb.
+ * @return [int] - Number of pixels converted.
+ */
+SIMD_TARGET("ssse3")
+static uint32_t grayRowSsse3(const uint8_t *src, uint8_t *dst, const uint32_t width, const GrayCoeffs &c) {
+	__m128i mb0 = _mm_loadu_si128((const __m128i *)SHUF_B[0]);
+	__m128i mb1 = _mm_loadu_si128((const __m128i *)SHUF_B[1]);
+	__m128i mb2 = _mm_loadu_si128((const __m128i *)SHUF_B[2]);
+	__m128i mg0 = _mm_loadu_si128((const __m128i *)SHUF_G[0]);
+	__m128i mg1 = _mm_loadu_si128((const __m128i *)SHUF_G[1]);
+	__m128i mg2 = _mm_loadu_si128((const __m128i *)SHUF_G[2]);
+	__m128i mr0 = _mm_loadu_si128((const __m128i *)SHUF_R[0]);
+	__m128i mr1 = _mm_loadu_si128((const __m128i *)SHUF_R[1]);
+	__m128i mr2 = _mm_loadu_si128((const __m128i *)SHUF_R[2]);
+
+	uint32_t j = 0;
+	for(; j + 16 <= width; j += 16) {
+		const uint8_t *p = src + j * 3;
+		__m128i a0 = _mm_loadu_si128((const __m128i *)p);
+		__m128i a1 = _mm_loadu_si128((const __m128i *)(p + 16));
+		__m128i a2 = _mm_loadu_si128((const __m128i *)(p + 32));
+
+		__m128i b = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a0, mb0), _mm_shuffle_epi8(a1, mb1)), _mm_shuffle_epi8(a2, mb2));
+		__m128i g = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a0, mg0), _mm_shuffle_epi8(a1, mg1)), _mm_shuffle_epi8(a2, mg2));
+		__m128i r = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a0, mr0), _mm_shuffle_epi8(a1, mr1)), _mm_shuffle_epi8(a2, mr2));
+
+		_mm_storeu_si128((__m128i *)(dst + j), grayWeigh16(b, g, r, c));
+	}
+	return j;
+}
+
+/*!
+ * @brief AVX2 kernel, each 128 bit lane handles its own group of 16 pixels
+ *        exactly like the SSSE3 kernel so no cross lane shuffles are needed.
+ * @return [int] - Number of pixels converted.
+ */
+SIMD_TARGET("avx2")
+static uint32_t grayRowAvx2(const uint8_t *src, uint8_t *dst, const uint32_t width, const GrayCoeffs &c) {
+	__m256i mb0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_B[0]));
+	__m256i mb1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_B[1]));
+	__m256i mb2 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_B[2]));
+	__m256i mg0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_G[0]));
+	__m256i mg1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_G[1]));
+	__m256i mg2 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_G[2]));
+	__m256i mr0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_R[0]));
+	__m256i mr1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_R[1]));
+	__m256i mr2 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_R[2]));
+
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i wbg = _mm256_set1_epi32((uint16_t)c.wb | ((uint32_t)(uint16_t)c.wg << 16));
+	const __m256i wr = _mm256_set1_epi32((uint16_t)c.wr);
+	const __m256i bias = _mm256_set1_epi32(c.bias);
+	const __m128i shift = _mm_cvtsi32_si128(c.shift);
+
+	uint32_t j = 0;
+	for(; j + 32 <= width; j += 32) {
+		const uint8_t *p = src + j * 3;
+		__m256i a0 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)p)),
+			_mm_loadu_si128((const __m128i *)(p + 48)), 1);
+		__m256i a1 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(p + 16))),
+			_mm_loadu_si128((const __m128i *)(p + 64)), 1);
+		__m256i a2 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(p + 32))),
+			_mm_loadu_si128((const __m128i *)(p + 80)), 1);
+
+		__m256i b = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(a0, mb0), _mm256_shuffle_epi8(a1, mb1)), _mm256_shuffle_epi8(a2, mb2));
+		__m256i g = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(a0, mg0), _mm256_shuffle_epi8(a1, mg1)), _mm256_shuffle_epi8(a2, mg2));
+		__m256i r = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(a0, mr0), _mm256_shuffle_epi8(a1, mr1)), _mm256_shuffle_epi8(a2, mr2));
+
+		__m256i b0 = _mm256_unpacklo_epi8(b, zero), b1 = _mm256_unpackhi_epi8(b, zero);
+		__m256i g0 = _mm256_unpacklo_epi8(g, zero), g1 = _mm256_unpackhi_epi8(g, zero);
+		__m256i r0 = _mm256_unpacklo_epi8(r, zero), r1 = _mm256_unpackhi_epi8(r, zero);
+
+		__m256i s0 = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(b0, g0), wbg), _mm256_madd_epi16(_mm256_unpacklo_epi16(r0, zero), wr));
+		__m256i s1 = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(b0, g0), wbg), _mm256_madd_epi16(_mm256_unpackhi_epi16(r0, zero), wr));
+		__m256i s2 = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(b1, g1), wbg), _mm256_madd_epi16(_mm256_unpacklo_epi16(r1, zero), wr));
+		__m256i s3 = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(b1, g1), wbg), _mm256_madd_epi16(_mm256_unpackhi_epi16(r1, zero), wr));
+
+		s0 = _mm256_srl_epi32(_mm256_add_epi32(s0, bias), shift);
+		s1 = _mm256_srl_epi32(_mm256_add_epi32(s1, bias), shift);
+		s2 = _mm256_srl_epi32(_mm256_add_epi32(s2, bias), shift);
+		s3 = _mm256_srl_epi32(_mm256_add_epi32(s3, bias), shift);
+
+		//Packs work per lane, undoing the per lane unpacks above.
+		__m256i gray = _mm256_packus_epi16(_mm256_packs_epi32(s0, s1), _mm256_packs_epi32(s2, s3));
+		_mm256_storeu_si256((__m256i *)(dst + j), gray);
+	}
+	return j;
+}
+
+#endif
+
+/*!
+ * @brief Picks the row kernel for the given SIMD level.
+ */
+static GrayRowKernel selectKernel(const SimdLevel level) {
+#ifdef BITMAP_X86
+	switch(level) {
+		case SIMD_AVX2: return grayRowAvx2;
+		case SIMD_SSSE3: return grayRowSsse3;
+		case SIMD_SSE2: return grayRowSse2;
+		default: break;
+	}
+#else
+	(void)level;
+#endif
+	return 0;
+}
+
+void bgrToGrayRow(const uint8_t *src, uint8_t *dst, const uint32_t width, const uint32_t pixelBytes,
+	const LumaWeights weights, const SimdLevel level) {
+	const GrayCoeffs &c = COEFFS[weights];
+
+	//Vector kernels handle packed BGR24 only, leaving the row tail to the scalar loop.
+	uint32_t done = 0;
+	GrayRowKernel kernel = (pixelBytes == 3) ? selectKernel(level) : 0;
+	if(kernel) { done = kernel(src, dst, width, c); }
+
+	grayRowScalar(src + done * pixelBytes, dst + done, width - done, pixelBytes, c);
+}
+
+void bgrToGrayRow(const uint8_t *src, uint8_t *dst, const uint32_t width, const uint32_t pixelBytes,
+	const LumaWeights weights) {
+	bgrToGrayRow(src, dst, width, pixelBytes, weights, getSimdLevel());
+}
+
+typedef uint32_t (*SplitRowKernel)(const uint8_t *src, uint8_t *b, uint8_t *g, uint8_t *r, const uint32_t width);
+typedef uint32_t (*MergeRowKernel)(const uint8_t *b, const uint8_t *g, const uint8_t *r, uint8_t *dst, const uint32_t width);
+
+/*!
+ * @brief Scalar split of the remaining pixels of a row.
+ */
+static void splitRowScalar(const uint8_t *src, uint8_t *b, uint8_t *g, uint8_t *r, const uint32_t width) {
+	for(uint32_t j = 0; j < width; j++) {
+		b[j] = src[j * 3];
+		g[j] = src[j * 3 + 1];
+		r[j] = src[j * 3 + 2];
+	}
+}
+
+/*!
+ * @brief Scalar merge of the remaining pixels of a row.
+ */
+static void mergeRowScalar(const uint8_t *b, const uint8_t *g, const uint8_t *r, uint8_t *dst, const uint32_t width) {
+	for(uint32_t j = 0; j < width; j++) {
+		dst[j * 3] = b[j];
+		dst[j * 3 + 1] = g[j];
+		dst[j * 3 + 2] = r[j];
+	}
+}
+
+#ifdef BITMAP_X86
+
+//pshufb masks placing 16 B, G and R bytes into three consecutive 16 byte stores.
+#define M_ 0x80
+static const uint8_t MERGE_B[3][16] = {
+	{ 0, M_, M_, 1, M_, M_, 2, M_, M_, 3, M_, M_, 4, M_, M_, 5 },
+	{ M_, M_, 6, M_, M_, 7, M_, M_, 8, M_, M_, 9, M_, M_, 10, M_ },
+	{ M_, 11, M_, M_, 12, M_, M_, 13, M_, M_, 14, M_, M_, 15, M_, M_ }
+};
+static const uint8_t MERGE_G[3][16] = {
+	{ M_, 0, M_, M_, 1, M_, M_, 2, M_, M_, 3, M_, M_, 4, M_, M_ },
+	{ 5, M_, M_, 6, M_, M_, 7, M_, M_, 8, M_, M_, 9, M_, M_, 10 },
+	{ M_, M_, 11, M_, M_, 12, M_, M_, 13, M_, M_, 14, M_, M_, 15, M_ }
+};
+static const uint8_t MERGE_R[3][16] = {
+	{ M_, M_, 0, M_, M_, 1, M_, M_, 2, M_, M_, 3, M_, M_, 4, M_ },
+	{ M_, 5, M_, M_, 6, M_, M_, 7, M_, M_, 8, M_, M_, 9, M_, M_ },
+	{ 10, M_, M_, 11, M_, M_, 12, M_, M_, 13, M_, M_, 14, M_, M_, 15 }
+};
+#undef M_
+
+/*!
+ * @brief SSSE3 kernel, splits 16 BGR pixels with the gray kernel's pshufb masks.
+ * @return [int] - Number of pixels split.
+ */
+SIMD_TARGET("ssse3")
+static uint32_t splitRowSsse3(const uint8_t *src, uint8_t *b, uint8_t *g, uint8_t *r, const uint32_t width) {
+	__m128i mb0 = _mm_loadu_si128((const __m128i *)SHUF_B[0]);
+	__m128i mb1 = _mm_loadu_si128((const __m128i *)SHUF_B[1]);
+	__m128i mb2 = _mm_loadu_si128((const __m128i *)SHUF_B[2]);
+	__m128i mg0 = _mm_loadu_si128((const __m128i *)SHUF_G[0]);
+	__m128i mg1 = _mm_loadu_si128((const __m128i *)SHUF_G[1]);
+	__m128i mg2 = _mm_loadu_si128((const __m128i *)SHUF_G[2]);
+	__m128i mr0 = _mm_loadu_si128((const __m128i *)SHUF_R[0]);
+	__m128i mr1 = _mm_loadu_si128((const __m128i *)SHUF_R[1]);
+	__m128i mr2 = _mm_loadu_si128((const __m128i *)SHUF_R[2]);
+
+	uint32_t j = 0;
+	for(; j + 16 <= width; j += 16) {
+		const uint8_t *p = src + j * 3;
+		__m128i a0 = _mm_loadu_si128((const __m128i *)p);
+		__m128i a1 = _mm_loadu_si128((const __m128i *)(p + 16));
+		__m128i a2 = _mm_loadu_si128((const __m128i *)(p + 32));
+
+		_mm_storeu_si128((__m128i *)(b + j), _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a0, mb0), _mm_shuffle_epi8(a1, mb1)), _mm_shuffle_epi8(a2, mb2)));
+		_mm_storeu_si128((__m128i *)(g + j), _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a0, mg0), _mm_shuffle_epi8(a1, mg1)), _mm_shuffle_epi8(a2, mg2)));
+		_mm_storeu_si128((__m128i *)(r + j), _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a0, mr0), _mm_shuffle_epi8(a1, mr1)), _mm_shuffle_epi8(a2, mr2)));
+	}
+	return j;
+}
+
+/*!
+ * @brief AVX2 kernel, each 128 bit lane splits its own group of 16 pixels.
+ * @return [int] - Number of pixels split.
+ */
+SIMD_TARGET("avx2")
+static uint32_t splitRowAvx2(const uint8_t *src, uint8_t *b, uint8_t *g, uint8_t *r, const uint32_t width) {
+	__m256i mb0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_B[0]));
+	__m256i mb1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_B[1]));
+	__m256i mb2 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_B[2]));
+	__m256i mg0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_G[0]));
+	__m256i mg1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_G[1]));
+	__m256i mg2 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_G[2]));
+	__m256i mr0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_R[0]));
+	__m256i mr1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_R[1]));
+	__m256i mr2 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)SHUF_R[2]));
+
+	uint32_t j = 0;
+	for(; j + 32 <= width; j += 32) {
+		const uint8_t *p = src + j * 3;
+		__m256i a0 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)p)),
+			_mm_loadu_si128((const __m128i *)(p + 48)), 1);
+		__m256i a1 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(p + 16))),
+			_mm_loadu_si128((const __m128i *)(p + 64)), 1);
+		__m256i a2 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(p + 32))),
+			_mm_loadu_si128((const __m128i *)(p + 80)), 1);
+
+		_mm256_storeu_si256((__m256i *)(b + j), _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(a0, mb0), _mm256_shuffle_epi8(a1, mb1)), _mm256_shuffle_epi8(a2, mb2)));
+		_mm256_storeu_si256((__m256i *)(g + j), _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(a0, mg0), _mm256_shuffle_epi8(a1, mg1)), _mm256_shuffle_epi8(a2, mg2)));
+		_mm256_storeu_si256((__m256i *)(r + j), _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(a0, mr0), _mm256_shuffle_epi8(a1, mr1)), _mm256_shuffle_epi8(a2, mr2)));
+	}
+	return j;
+}
+
+/*!
+ * @brief SSSE3 kernel, interleaves 16 pixels of each plane with pshufb.
+ * @return [int] - Number of pixels merged.
+ */
+SIMD_TARGET("ssse3")
+static uint32_t mergeRowSsse3(const uint8_t *b, const uint8_t *g, const uint8_t *r, uint8_t *dst, const uint32_t width) {
+	__m128i mb0 = _mm_loadu_si128((const __m128i *)MERGE_B[0]);
+	__m128i mb1 = _mm_loadu_si128((const __m128i *)MERGE_B[1]);
+	__m128i mb2 = _mm_loadu_si128((const __m128i *)MERGE_B[2]);
+	__m128i mg0 = _mm_loadu_si128((const __m128i *)MERGE_G[0]);
+	__m128i mg1 = _mm_loadu_si128((const __m128i *)MERGE_G[1]);
+	__m128i mg2 = _mm_loadu_si128((const __m128i *)MERGE_G[2]);
+	__m128i mr0 = _mm_loadu_si128((const __m128i *)MERGE_R[0]);
+	__m128i mr1 = _mm_loadu_si128((const __m128i *)MERGE_R[1]);
+	__m128i mr2 = _mm_loadu_si128((const __m128i *)MERGE_R[2]);
+
+	uint32_t j = 0;
+	for(; j + 16 <= width; j += 16) {
+		__m128i vb = _mm_loadu_si128((const __m128i *)(b + j));
+		__m128i vg = _mm_loadu_si128((const __m128i *)(g + j));
+		__m128i vr = _mm_loadu_si128((const __m128i *)(r + j));
+
+		uint8_t *p = dst + j * 3;
+		_mm_storeu_si128((__m128i *)p, _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(vb, mb0), _mm_shuffle_epi8(vg, mg0)), _mm_shuffle_epi8(vr, mr0)));
+		_mm_storeu_si128((__m128i *)(p + 16), _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(vb, mb1), _mm_shuffle_epi8(vg, mg1)), _mm_shuffle_epi8(vr, mr1)));
+		_mm_storeu_si128((__m128i *)(p + 32), _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(vb, mb2), _mm_shuffle_epi8(vg, mg2)), _mm_shuffle_epi8(vr, mr2)));
+	}
+	return j;
+}
+
+/*!
+ * @brief AVX2 kernel, each 128 bit lane interleaves its own group of 16 pixels,
+ *        the lanes are put back in order before storing.
+ * @return [int] - Number of pixels merged.
+ */
+SIMD_TARGET("avx2")
+static uint32_t mergeRowAvx2(const uint8_t *b, const uint8_t *g, const uint8_t *r, uint8_t *dst, const uint32_t width) {
+	__m256i mb0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)MERGE_B[0]));
+	__m256i mb1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)MERGE_B[1]));
+	__m256i mb2 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)MERGE_B[2]));
+	__m256i mg0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)MERGE_G[0]));
+	__m256i mg1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)MERGE_G[1]));
+	__m256i mg2 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)MERGE_G[2]));
+	__m256i mr0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)MERGE_R[0]));
+	__m256i mr1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)MERGE_R[1]));
+	__m256i mr2 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)MERGE_R[2]));
+
+	uint32_t j = 0;
+	for(; j + 32 <= width; j += 32) {
+		__m256i vb = _mm256_loadu_si256((const __m256i *)(b + j));
+		__m256i vg = _mm256_loadu_si256((const __m256i *)(g + j));
+		__m256i vr = _mm256_loadu_si256((const __m256i *)(r + j));
+
+		//Lane 0 holds output bytes 0-47 and lane 1 bytes 48-95, 16 per vector.
+		__m256i o0 = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(vb, mb0), _mm256_shuffle_epi8(vg, mg0)), _mm256_shuffle_epi8(vr, mr0));
+		__m256i o1 = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(vb, mb1), _mm256_shuffle_epi8(vg, mg1)), _mm256_shuffle_epi8(vr, mr1));
+		__m256i o2 = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(vb, mb2), _mm256_shuffle_epi8(vg, mg2)), _mm256_shuffle_epi8(vr, mr2));
+
+		uint8_t *p = dst + j * 3;
+		_mm256_storeu_si256((__m256i *)p, _mm256_permute2x128_si256(o0, o1, 0x20));
+		_mm256_storeu_si256((__m256i *)(p + 32), _mm256_permute2x128_si256(o2, o0, 0x30));
+		_mm256_storeu_si256((__m256i *)(p + 64), _mm256_permute2x128_si256(o1, o2, 0x31));
+	}
+	return j;
+}
+
+#endif
+
+/*!
+ * @brief Picks the split kernel for the given SIMD level.
+ */
+static SplitRowKernel selectSplitKernel(const SimdLevel level) {
+#ifdef BITMAP_X86
+	switch(level) {
+		case SIMD_AVX2: return splitRowAvx2;
+		case SIMD_SSSE3: return splitRowSsse3;
+		default: break;
+	}
+#else
+	(void)level;
+#endif
+	return 0;
+}
+
+/*!
+ * @brief Picks the merge kernel for the given SIMD level.
+ */
+static MergeRowKernel selectMergeKernel(const SimdLevel level) {
+#ifdef BITMAP_X86
+	switch(level) {
+		case SIMD_AVX2: return mergeRowAvx2;
+		case SIMD_SSSE3: return mergeRowSsse3;
+		default: break;
+	}
+#else
+	(void)level;
+#endif
+	return 0;
+}
+
+void splitBgrRow(const uint8_t *src, uint8_t *b, uint8_t *g, uint8_t *r, const uint32_t width,
+	const SimdLevel level) {
+	uint32_t done = 0;
+	SplitRowKernel kernel = selectSplitKernel(level);
+	if(kernel) { done = kernel(src, b, g, r, width); }
+
+	splitRowScalar(src + done * 3, b + done, g + done, r + done, width - done);
+}
+
+void splitBgrRow(const uint8_t *src, uint8_t *b, uint8_t *g, uint8_t *r, const uint32_t width) {
+	splitBgrRow(src, b, g, r, width, getSimdLevel());
+}
+
+void mergeBgrRow(const uint8_t *b, const uint8_t *g, const uint8_t *r, uint8_t *dst, const uint32_t width,
+	const SimdLevel level) {
+	uint32_t done = 0;
+	MergeRowKernel kernel = selectMergeKernel(level);
+	if(kernel) { done = kernel(b, g, r, dst, width); }
+
+	mergeRowScalar(b + done, g + done, r + done, dst + done * 3, width - done);
+}
+
+void mergeBgrRow(const uint8_t *b, const uint8_t *g, const uint8_t *r, uint8_t *dst, const uint32_t width) {
+	mergeBgrRow(b, g, r, dst, width, getSimdLevel());
+}
@@ -0,0 +1,96 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.1
+ *          - 1.0.0 - Added SIMD BGR to gray conversion kernels.
+ *          - 1.0.1 - Added BGR plane split and merge kernels.
+ *
+ * @desc Color to gray scale and BGR plane split / merge row kernels with SSE2,
+ *       SSSE3 and AVX2 variants selected at runtime and a portable scalar
+ *       fallback.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "CpuFeatures.h"
+
+/*! Luma weights used for gray conversion */
+enum LumaWeights {
+	LUMA_AVERAGE = 0,				/*! (B + G + R) / 3 */
+	LUMA_BT601,						/*! 0.299 R + 0.587 G + 0.114 B */
+	LUMA_BT709						/*! 0.2126 R + 0.7152 G + 0.0722 B */
+};
+
+/*!
+ * @brief Converts one row of BGR(A) pixels into 8 bit gray.
+ *        gray = (wB * B + wG * G + wR * R + bias) >> shift, in fixed point.
+ * @param [string] - Source row, 'pixelBytes' per pixel (3 or 4).
+ * @param [string] - Destination gray row.
+ * @param [int] - Number of pixels.
+ * @param [int] - Bytes per source pixel.
+ * @param [LumaWeights] - Weights to be used.
+ * @return None
+ */
+void bgrToGrayRow(const uint8_t *src, uint8_t *dst, const uint32_t width, const uint32_t pixelBytes,
+	const LumaWeights weights);
+
+/*!
+ * @brief Same as bgrToGrayRow() but forced to the given SIMD level, which must
+ *        be supported by the CPU. Used for testing and benchmarking.
+ */
+void bgrToGrayRow(const uint8_t *src, uint8_t *dst, const uint32_t width, const uint32_t pixelBytes,
+	const LumaWeights weights, const SimdLevel level);
+
+/*!
+ * @brief Splits one row of BGR24 pixels into its blue, green and red planes.
+ * @param [string] - Source row, 3 bytes per pixel.
+ * @param [string] - Destination blue row.
+ * @param [string] - Destination green row.
+ * @param [string] - Destination red row.
+ * @param [int] - Number of pixels.
+ * @return None
+ */
+void splitBgrRow(const uint8_t *src, uint8_t *b, uint8_t *g, uint8_t *r, const uint32_t width);
+
+/*!
+ * @brief Same as splitBgrRow() but forced to the given SIMD level.
+ */
+void splitBgrRow(const uint8_t *src, uint8_t *b, uint8_t *g, uint8_t *r, const uint32_t width,
+	const SimdLevel level);
+
+/*!
+ * @brief Interleaves one row of blue, green and red planes into BGR24 pixels.
+ * @param [string] - Source blue row.
+ * @param [string] - Source green row.
+ * @param [string] - Source red row.
+ * @param [string] - Destination row, 3 bytes per pixel.
+ * @param [int] - Number of pixels.
+ * @return None
+ */
+void mergeBgrRow(const uint8_t *b, const uint8_t *g, const uint8_t *r, uint8_t *dst, const uint32_t width);
+
+/*!
+ * @brief Same as mergeBgrRow() but forced to the given SIMD level.
+ */
+void mergeBgrRow(const uint8_t *b, const uint8_t *g, const uint8_t *r, uint8_t *dst, const uint32_t width,
+	const SimdLevel level);
@@ -8,15 +8,22 @@
  * Course Instructor: Dr. Jawaid Iqbal
  */
 
+#ifdef _WIN32
 #include <Windows.h>
+#else
+#include <cstdio>
+//Console input of conio.h, used by the interactive menu.
+static int _getch(void) { return getchar(); }
+#endif
 
 #include "BitmapHandler.h"
+#include "BatchRunner.h"
 
 using namespace std;
 
 enum {
 	BEGIN, READ, CONVERT, ROTATE, SCALE, TRANSLATE, EXIT
-} States;
+};
 
 int currentState = BEGIN;
 bool stateMachine = true;
@@ -32,9 +39,19 @@ void _handleScaleMenu(void);
 void _handleTranslateMenu(void);
 void stateTransition(void);
 void printInfo(BitmapHandler *bmp);
+int runBatch(int argc, char **argv);
+int runIndex(int argc, char **argv);
+int runStats(int argc, char **argv);
 
-int main(int *argc, char **argv) {
+int main(int argc, char **argv) {
+	//Any argument selects the non-interactive batch mode.
+	if(argc > 1 && (string(argv[1]) == "-index" || string(argv[1]) == "-query")) { return runIndex(argc, argv); }
+	if(argc > 1 && string(argv[1]) == "-stats") { return runStats(argc, argv); }
+	if(argc > 1) { return runBatch(argc, argv); }
+
+#ifdef _WIN32
 	SetConsoleTitle(TEXT("BMP Image App - by Syed Asad Amin"));
+#endif
 
 	while(stateMachine) {
 		switch(currentState) {
@@ -202,8 +219,8 @@ void _handleScaleMenu(void) {
 
 void _handleTranslateMenu(void) {
 	uint8_t fileName[32];
-	uint32_t x = 0;
-	uint32_t y = 0;
+	int32_t x = 0;
+	int32_t y = 0;
 
 	cout << "----------     TRANSLATE MENU     ----------" << endl;
 	cout << "--------------------------------------------" << endl;
@@ -250,7 +267,11 @@ void stateTransition(void) {
 	else if(c == '\r') currentState = BEGIN;	//ENTER
 	else currentState = BEGIN;					//ANY OTHER KEY
 
+#ifdef _WIN32
 	system("CLS");
+#else
+	system("clear");
+#endif
 }
 
 void printInfo(BitmapHandler *bmp) {
@@ -270,3 +291,133 @@ void printInfo(BitmapHandler *bmp) {
 	cout << "Color used: " << bmp->getColorUsed() << endl;
 	cout << "Imp color used: " << bmp->getImpColorUsed() << endl;
 }
+
+int runBatch(int argc, char **argv) {
+	BatchRunner batch;
+	bool valid = true;
+
+	for(int i = 1; i < argc && valid; i++) {
+		string arg = argv[i];
+		bool hasValue = (i + 1 < argc);
+
+		if(arg == "-op" && hasValue) { valid = batch.addOperation(argv[++i]); }
+		else if(arg == "-m" && hasValue) { valid = batch.addManifest(argv[++i]); }
+		else if(arg == "-o" && hasValue) { batch.setOutputDir(argv[++i]); }
+		else if(arg == "-j" && hasValue) { batch.setWorkers((uint32_t)atoi(argv[++i])); }
+		else if(arg == "-s" && hasValue) { batch.setStripRows((uint32_t)atoi(argv[++i])); }
+		else if(arg == "-t" && hasValue) { batch.setTraceFile(argv[++i]); }
+		else if(arg == "-p" && hasValue) { batch.setPrefetchDepth((uint32_t)atoi(argv[++i])); }
+		else if(arg == "-mem" && hasValue) { batch.setInFlightLimit((size_t)atoi(argv[++i]) << 20); }
+		else if(arg == "-q") { batch.setVerbose(false); }
+		else if(arg == "-f") { batch.setFuseGeometry(true); }
+		else if(arg == "-rle") { batch.setRunLengthOutput(true); }
+		else if(arg == "-pyr" && hasValue) { valid = batch.setPyramid(argv[++i]); }
+		else if(arg == "-roi" && hasValue) { valid = batch.setRegion(argv[++i]); }
+		else if(arg[0] != '-') { batch.addInput(argv[i]); }
+		else { valid = false; }
+
+		if(!valid) { cout << "Invalid argument: " << arg << endl; }
+	}
+
+	if(!valid || (batch.getOperationCount() == 0 && batch.getPyramidLevels() == 0 && !batch.hasRegion()) ||
+		batch.getFileCount() == 0) {
+		cout << "Usage: ImageApp [-op operation]... [-m manifest] [-o output_dir] [-j workers] [-s strip_rows] [-p depth] [-mem MiB] [-t trace_file] [-f] [-rle] [-pyr levels[:box|gaussian]] [-roi x,y,w,h] [-q] [inputs]..." << endl;
+		cout << "Operations (applied in order):" << endl;
+		cout << "  gray[:average|bt601|bt709]" << endl;
+		cout << "  rotate:angle[:bilinear|nearest]" << endl;
+		cout << "  scale:x[,y][:bilinear|nearest|bicubic|lanczos3|area]" << endl;
+		cout << "  translate:x,y" << endl;
+		cout << "  gamma:g | brightness:b | contrast:c | threshold:t | window:low,high | invert | equalize" << endl;
+		cout << "  blur:sigma | box:radius | median:radius | sobel[:magnitude|x|y] | scharr[:magnitude|x|y]" << endl;
+		cout << "Consecutive gray value operations are composed into one lookup table pass." << endl;
+		cout << "-f runs consecutive rotate/scale/translate operations as one resampling pass." << endl;
+		cout << "-p reads that many files ahead of the workers (0 reads in the workers), -mem caps the bytes held." << endl;
+		cout << "-t appends the stage timings and counters of every call as JSON lines." << endl;
+		cout << "-rle writes gray outputs RLE8 compressed." << endl;
+		cout << "-pyr also writes the 1/2, 1/4, ... levels of every output as name_2.bmp, name_4.bmp and so on," << endl;
+		cout << "     without operations the levels of the inputs are made in one pass over each file." << endl;
+		cout << "-roi works on a window of every input (from its top-left corner), only its rows are read;" << endl;
+		cout << "     without operations the windows are written as they are." << endl;
+		cout << "Inputs are files, directories (every .bmp below) or patterns like images/*.bmp." << endl;
+		return EXIT_FAILURE;
+	}
+
+	return batch.run() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int runIndex(int argc, char **argv) {
+	string command = argv[1];
+	BitmapIndex index;
+
+	//Building or refreshing the index of a directory.
+	if(command == "-index" && argc == 4) {
+		index.load(argv[3]);
+		if(!index.build(argv[2]) || !index.save(argv[3])) {
+			cout << "Unable to index " << argv[2] << endl;
+			return EXIT_FAILURE;
+		}
+		cout << index.getCount() << " files indexed." << endl;
+		return EXIT_SUCCESS;
+	}
+
+	//Listing the indexed files matching the filter, one path per line.
+	if(command == "-query" && argc >= 3 && argc % 2 == 1) {
+		IndexQuery filter;
+		memset(&filter, 0, sizeof(filter));
+
+		for(int i = 3; i + 1 < argc; i += 2) {
+			string arg = argv[i];
+			uint32_t low = 0, high = 0;
+			if(sscanf(argv[i + 1], "%u:%u", &low, &high) == 1) { high = low; }
+
+			if(arg == "-w") { filter.minWidth = low; filter.maxWidth = high; }
+			else if(arg == "-h") { filter.minHeight = low; filter.maxHeight = high; }
+			else if(arg == "-bpp") { filter.bitsPerPixel = (uint16_t)low; }
+			else { cout << "Invalid argument: " << arg << endl; return EXIT_FAILURE; }
+		}
+
+		if(!index.load(argv[2])) {
+			cout << "Unable to read index " << argv[2] << endl;
+			return EXIT_FAILURE;
+		}
+
+		vector<uint32_t> matches;
+		index.query(filter, matches);
+		for(uint32_t i : matches) { cout << index.getPath(i) << "\n"; }
+		cout.flush();
+		return EXIT_SUCCESS;
+	}
+
+	cout << "Usage: ImageApp -index directory index_file" << endl;
+	cout << "       ImageApp -query index_file [-w min[:max]] [-h min[:max]] [-bpp bits]" << endl;
+	return EXIT_FAILURE;
+}
+
+int runStats(int argc, char **argv) {
+	if(argc < 3) {
+		cout << "Usage: ImageApp -stats files..." << endl;
+		return EXIT_FAILURE;
+	}
+
+	//One JSON object per file, channels are gray or blue, green, red.
+	BitmapHandler bmp;
+	int failed = 0;
+	for(int i = 2; i < argc; i++) {
+		ImageStats stats;
+		if(!bmp.computeStats((const uint8_t *)argv[i], stats)) {
+			cout << "Unable to read " << argv[i] << endl;
+			failed++;
+			continue;
+		}
+
+		cout << "{\"file\":\"" << argv[i] << "\",\"pixels\":" << stats.count << ",\"channels\":[";
+		for(uint32_t c = 0; c < stats.channels; c++) {
+			cout << (c ? "," : "") << "{\"min\":" << (int)stats.minimum[c] << ",\"max\":" << (int)stats.maximum[c]
+				<< ",\"mean\":" << stats.mean[c] << ",\"stddev\":" << sqrt(stats.variance[c])
+				<< ",\"p1\":" << (int)statsPercentile(stats, c, 1.0) << ",\"p50\":" << (int)statsPercentile(stats, c, 50.0)
+				<< ",\"p99\":" << (int)statsPercentile(stats, c, 99.0) << "}";
+		}
+		cout << "]}" << endl;
+	}
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
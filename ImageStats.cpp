@@ -0,0 +1,191 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.0
+ *          - 1.0.0 - Added parallel histogram and image statistics.
+ *
+ * @desc Histograms, extrema, mean, variance and percentiles of 8 bit gray and
+ *       24/32 bit color pixel rows, counted in parallel row bands.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include "ImageStats.h"
+
+#include <cstring>
+
+#include <mutex>
+
+#include "ThreadPool.h"
+
+static const uint32_t STATS_BAND_ROWS		= 32;		//Smallest row band given to a thread
+static const uint64_t STATS_FLUSH_PIXELS	= 0x40000000;	//Pixels counted before the 32 bit bins are flushed
+
+void resetStats(ImageStats &stats, const uint32_t channels) {
+	memset(&stats, 0, sizeof(stats));
+	stats.channels = (channels == 1) ? 1 : STATS_MAX_CHANNELS;
+}
+
+/*!
+ * @brief Gray rows, four sub-histograms are filled in turn so runs of equal
+ *        pixels do not wait on the store of the same counter.
+ */
+static void countGrayRows(const uint8_t *data, const uint32_t width, const uint32_t rows, const uint32_t stride,
+	uint64_t *histogram) {
+	uint32_t bins[4][256];
+	memset(bins, 0, sizeof(bins));
+	uint64_t pending = 0;
+
+	for(uint32_t i = 0; i < rows; i++) {
+		const uint8_t *row = data + (size_t)i * stride;
+		uint32_t j = 0;
+		for(; j + 4 <= width; j += 4) {
+			bins[0][row[j]]++;
+			bins[1][row[j + 1]]++;
+			bins[2][row[j + 2]]++;
+			bins[3][row[j + 3]]++;
+		}
+		for(; j < width; j++) { bins[0][row[j]]++; }
+
+		pending += width;
+		if(pending >= STATS_FLUSH_PIXELS || i + 1 == rows) {
+			for(uint32_t k = 0; k < 256; k++) {
+				histogram[k] += (uint64_t)bins[0][k] + bins[1][k] + bins[2][k] + bins[3][k];
+			}
+			memset(bins, 0, sizeof(bins));
+			pending = 0;
+		}
+	}
+}
+
+/*!
+ * @brief Color rows, every channel has two sub-histograms used by alternate pixels.
+ */
+static void countColorRows(const uint8_t *data, const uint32_t width, const uint32_t rows, const uint32_t stride,
+	const uint32_t pixelBytes, uint64_t (*histogram)[256]) {
+	uint32_t bins[2][STATS_MAX_CHANNELS][256];
+	memset(bins, 0, sizeof(bins));
+	uint64_t pending = 0;
+
+	for(uint32_t i = 0; i < rows; i++) {
+		const uint8_t *p = data + (size_t)i * stride;
+		uint32_t j = 0;
+		for(; j + 2 <= width; j += 2, p += 2 * pixelBytes) {
+			bins[0][0][p[0]]++;
+			bins[0][1][p[1]]++;
+			bins[0][2][p[2]]++;
+			bins[1][0][p[pixelBytes]]++;
+			bins[1][1][p[pixelBytes + 1]]++;
+			bins[1][2][p[pixelBytes + 2]]++;
+		}
+		if(j < width) {
+			bins[0][0][p[0]]++;
+			bins[0][1][p[1]]++;
+			bins[0][2][p[2]]++;
+		}
+
+		pending += width;
+		if(pending >= STATS_FLUSH_PIXELS || i + 1 == rows) {
+			for(uint32_t c = 0; c < STATS_MAX_CHANNELS; c++) {
+				for(uint32_t k = 0; k < 256; k++) { histogram[c][k] += (uint64_t)bins[0][c][k] + bins[1][c][k]; }
+			}
+			memset(bins, 0, sizeof(bins));
+			pending = 0;
+		}
+	}
+}
+
+void countRows(const uint8_t *data, const uint32_t width, const uint32_t rows, const uint32_t stride,
+	const uint32_t pixelBytes, ImageStats &stats) {
+	if(pixelBytes == 1) {
+		countGrayRows(data, width, rows, stride, stats.histogram[0]);
+	} else {
+		countColorRows(data, width, rows, stride, pixelBytes, stats.histogram);
+	}
+	stats.count += (uint64_t)width * rows;
+}
+
+void mergeStats(ImageStats &dst, const ImageStats &src) {
+	for(uint32_t c = 0; c < dst.channels; c++) {
+		for(uint32_t k = 0; k < 256; k++) { dst.histogram[c][k] += src.histogram[c][k]; }
+	}
+	dst.count += src.count;
+}
+
+void finishStats(ImageStats &stats) {
+	for(uint32_t c = 0; c < stats.channels; c++) {
+		const uint64_t *histogram = stats.histogram[c];
+		stats.minimum[c] = 0;
+		stats.maximum[c] = 0;
+		stats.mean[c] = 0.0;
+		stats.variance[c] = 0.0;
+		if(stats.count == 0) { continue; }
+
+		uint32_t low = 0, high = 255;
+		while(histogram[low] == 0) { low++; }
+		while(histogram[high] == 0) { high--; }
+		stats.minimum[c] = (uint8_t)low;
+		stats.maximum[c] = (uint8_t)high;
+
+		//Sums of 256 bins are exact in 64 bits up to 2^40 pixels.
+		uint64_t sum = 0, squares = 0;
+		for(uint32_t k = low; k <= high; k++) {
+			sum += histogram[k] * k;
+			squares += histogram[k] * k * k;
+		}
+		double mean = (double)sum / stats.count;
+		stats.mean[c] = mean;
+		stats.variance[c] = (double)squares / stats.count - mean * mean;
+		if(stats.variance[c] < 0.0) { stats.variance[c] = 0.0; }
+	}
+}
+
+bool computeStats(const uint8_t *data, const uint32_t width, const uint32_t height, const uint32_t stride,
+	const uint16_t bpp, ImageStats &stats) {
+	if(bpp != 8 && bpp != 24 && bpp != 32) { return false; }
+
+	uint32_t pixelBytes = bpp / 8;
+	resetStats(stats, pixelBytes == 1 ? 1 : STATS_MAX_CHANNELS);
+
+	//Every band counts into its own histograms, only the merge is serialized.
+	std::mutex mergeMutex;
+	ThreadPool::getShared().parallelFor(0, height, STATS_BAND_ROWS, [&](uint32_t first, uint32_t last) {
+		ImageStats band;
+		resetStats(band, stats.channels);
+		countRows(data + (size_t)first * stride, width, last - first, stride, pixelBytes, band);
+
+		std::lock_guard<std::mutex> lock(mergeMutex);
+		mergeStats(stats, band);
+	});
+
+	finishStats(stats);
+	return true;
+}
+
+uint8_t statsPercentile(const ImageStats &stats, const uint32_t channel, const double percent) {
+	if(stats.count == 0 || channel >= stats.channels) { return 0; }
+
+	double target = (percent <= 0.0) ? 1.0 : stats.count * (percent / 100.0);
+	uint64_t cumulative = 0;
+	for(uint32_t k = 0; k < 256; k++) {
+		cumulative += stats.histogram[channel][k];
+		if((double)cumulative >= target) { return (uint8_t)k; }
+	}
+	return 255;
+}
@@ -0,0 +1,105 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.0
+ *          - 1.0.0 - Added parallel histogram and image statistics.
+ *
+ * @desc Histograms, extrema, mean, variance and percentiles of 8 bit gray and
+ *       24/32 bit color pixel rows, counted in parallel row bands.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+
+static const uint32_t STATS_MAX_CHANNELS	= 3;		//Blue, green and red of color images
+
+/*! Statistics of the pixel rows, channel 0 is gray or blue */
+struct ImageStats {
+	uint32_t channels;							/*! 1 for gray, 3 for color */
+	uint64_t count;								/*! Pixels counted per channel */
+	uint64_t histogram[STATS_MAX_CHANNELS][256];
+	uint8_t minimum[STATS_MAX_CHANNELS];		/*! Set by finishStats() */
+	uint8_t maximum[STATS_MAX_CHANNELS];		/*! Set by finishStats() */
+	double mean[STATS_MAX_CHANNELS];			/*! Set by finishStats() */
+	double variance[STATS_MAX_CHANNELS];		/*! Population variance, set by finishStats() */
+};
+
+/*!
+ * @brief Clears the statistics.
+ * @param [ImageStats] - Statistics to be cleared.
+ * @param [int] - Number of channels, 1 or 3.
+ * @return None
+ */
+void resetStats(ImageStats &stats, const uint32_t channels);
+
+/*!
+ * @brief Adds the pixels of the rows to the histograms. Only 'width' pixels of
+ *        each row are counted, the row padding is skipped.
+ * @param [string] - First row.
+ * @param [int] - Pixels per row.
+ * @param [int] - Number of rows.
+ * @param [int] - Row stride in bytes.
+ * @param [int] - Bytes per pixel, 1 for gray, 3 or 4 for color (alpha is ignored).
+ * @param [ImageStats] - Statistics the counts are added to.
+ * @return None
+ */
+void countRows(const uint8_t *data, const uint32_t width, const uint32_t rows, const uint32_t stride,
+	const uint32_t pixelBytes, ImageStats &stats);
+
+/*!
+ * @brief Adds the histograms of 'src' to 'dst', both must have the same channels.
+ * @param [ImageStats] - Statistics the counts are added to.
+ * @param [ImageStats] - Statistics to be added.
+ * @return None
+ */
+void mergeStats(ImageStats &dst, const ImageStats &src);
+
+/*!
+ * @brief Derives extrema, mean and variance from the histograms.
+ * @param [ImageStats] - Statistics to be completed.
+ * @return None
+ */
+void finishStats(ImageStats &stats);
+
+/*!
+ * @brief Counts the whole image in parallel row bands, every band fills its own
+ *        histograms which are merged at the end, then finishes the statistics.
+ * @param [string] - First row.
+ * @param [int] - Image width.
+ * @param [int] - Image height.
+ * @param [int] - Row stride in bytes.
+ * @param [int] - Bits per pixel, 8, 24 or 32.
+ * @param [ImageStats] - Calculated statistics.
+ * @return [boolean] - Set if the pixel format is supported otherwise reset.
+ */
+bool computeStats(const uint8_t *data, const uint32_t width, const uint32_t height, const uint32_t stride,
+	const uint16_t bpp, ImageStats &stats);
+
+/*!
+ * @brief Finds the smallest value with at least the given share of the pixels
+ *        at or below it, e.g. 50 for the median.
+ * @param [ImageStats] - Statistics of the image.
+ * @param [int] - Channel.
+ * @param [double] - Percentage from 0 to 100.
+ * @return [int] - Value of the percentile.
+ */
+uint8_t statsPercentile(const ImageStats &stats, const uint32_t channel, const double percent);
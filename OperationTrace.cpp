@@ -0,0 +1,112 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.0
+ *          - 1.0.0 - Added per stage timing and counters of operations.
+ *
+ * @desc Timings and counters of BitmapHandler operations: wall time per stage,
+ *       bytes read and written, pool allocations and threads, exported as
+ *       JSON lines.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include "OperationTrace.h"
+
+#include <mutex>
+
+static const char *STAGE_NAMES[TRACE_STAGES] = { "header", "read", "allocate", "kernel", "write" };
+
+static std::mutex traceMutex;
+
+/*!
+ * @brief Appends a JSON string literal, escaping quotes, backslashes and control characters.
+ * @param [string] - Output.
+ * @param [string] - Text to be quoted.
+ * @return None
+ */
+static void appendQuoted(std::string &out, const std::string &text) {
+	out += '"';
+	for(size_t i = 0; i < text.size(); i++) {
+		unsigned char c = (unsigned char)text[i];
+		if(c == '"' || c == '\\') { out += '\\'; out += (char)c; }
+		else if(c < 0x20) {
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+			out += escaped;
+		}
+		else { out += (char)c; }
+	}
+	out += '"';
+}
+
+void resetTrace(OperationTrace &trace, const char *operation) {
+	trace.operation = operation;
+	trace.file.clear();
+	trace.success = false;
+	trace.totalMs = 0.0;
+	for(uint32_t i = 0; i < TRACE_STAGES; i++) { trace.stageMs[i] = 0.0; }
+	trace.bytesRead = 0;
+	trace.bytesWritten = 0;
+	trace.allocations = 0;
+	trace.allocatedBytes = 0;
+	trace.threads = 0;
+	trace.stripRows = 0;
+	trace.error.clear();
+}
+
+std::string traceToJson(const OperationTrace &trace) {
+	char number[64];
+	std::string out = "{\"op\":";
+	appendQuoted(out, trace.operation ? trace.operation : "");
+	out += ",\"file\":";
+	appendQuoted(out, trace.file);
+	out += trace.success ? ",\"ok\":true" : ",\"ok\":false";
+
+	snprintf(number, sizeof(number), ",\"total_ms\":%.3f", trace.totalMs);
+	out += number;
+	for(uint32_t i = 0; i < TRACE_STAGES; i++) {
+		snprintf(number, sizeof(number), ",\"%s_ms\":%.3f", STAGE_NAMES[i], trace.stageMs[i]);
+		out += number;
+	}
+
+	snprintf(number, sizeof(number), ",\"bytes_read\":%llu,\"bytes_written\":%llu",
+		(unsigned long long)trace.bytesRead, (unsigned long long)trace.bytesWritten);
+	out += number;
+	snprintf(number, sizeof(number), ",\"allocations\":%llu,\"allocated_bytes\":%llu",
+		(unsigned long long)trace.allocations, (unsigned long long)trace.allocatedBytes);
+	out += number;
+	snprintf(number, sizeof(number), ",\"threads\":%u,\"strip_rows\":%u", trace.threads, trace.stripRows);
+	out += number;
+
+	out += ",\"error\":";
+	appendQuoted(out, trace.error);
+	out += '}';
+	return out;
+}
+
+bool writeTrace(FILE *file, const OperationTrace &trace) {
+	if(file == 0) { return false; }
+
+	std::string line = traceToJson(trace);
+	line += '\n';
+
+	std::lock_guard<std::mutex> lock(traceMutex);
+	return fwrite(line.data(), 1, line.size(), file) == line.size() && fflush(file) == 0;
+}
@@ -0,0 +1,109 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.0
+ *          - 1.0.0 - Added per stage timing and counters of operations.
+ *
+ * @desc Timings and counters of BitmapHandler operations: wall time per stage,
+ *       bytes read and written, pool allocations and threads, exported as
+ *       JSON lines.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+#include <chrono>
+#include <string>
+
+/*! Stages the time of a traced operation is split into */
+enum TraceStage {
+	STAGE_HEADER = 0,				/*! Opening the file and parsing its header */
+	STAGE_READ,						/*! Reading and unpacking pixel rows */
+	STAGE_ALLOCATE,					/*! Taking buffers from the pool */
+	STAGE_KERNEL,					/*! Processing, the time not spent in the other stages */
+	STAGE_WRITE,					/*! Writing the output file */
+	TRACE_STAGES
+};
+
+/*! Timings and counters of one call of a BitmapHandler operation */
+struct OperationTrace {
+	const char *operation;			/*! Name of the call */
+	std::string file;				/*! File read (or written by saveImage), empty for in-memory calls */
+	bool success;					/*! Result of the call */
+	double totalMs;					/*! Wall time of the call */
+	double stageMs[TRACE_STAGES];	/*! Wall time per stage */
+	uint64_t bytesRead;				/*! Bytes read from files */
+	uint64_t bytesWritten;			/*! Bytes written to files */
+	uint64_t allocations;			/*! Buffers taken from the pool by the calling thread */
+	uint64_t allocatedBytes;		/*! Bytes the pool had to allocate fresh for them */
+	uint32_t threads;				/*! Threads of the shared pool */
+	uint32_t stripRows;				/*! Strip height, 0 when whole images are processed */
+	std::string error;				/*! Last error reported, empty if none */
+};
+
+/*!
+ * @brief Clears all timings and counters of a trace.
+ * @param [OperationTrace] - Trace to be cleared.
+ * @param [string] - Name of the operation.
+ * @return None
+ */
+void resetTrace(OperationTrace &trace, const char *operation);
+
+/*!
+ * @brief Formats the trace as one JSON object without a line break.
+ * @param [OperationTrace] - Trace to be formatted.
+ * @return [string] - JSON object.
+ */
+std::string traceToJson(const OperationTrace &trace);
+
+/*!
+ * @brief Appends the trace as one JSON line, lines of concurrent writers are
+ *        not interleaved.
+ * @param [FILE] - Open output file.
+ * @param [OperationTrace] - Trace to be written.
+ * @return [boolean] - Set if the line is written successfully otherwise reset.
+ */
+bool writeTrace(FILE *file, const OperationTrace &trace);
+
+/*! Adds the wall time of its scope to a stage, without a trace it does nothing */
+class StageTimer {
+
+	public:
+		inline StageTimer(OperationTrace *trace, const TraceStage stage) : trace(trace), stage(stage) {
+			if(trace) { start = std::chrono::steady_clock::now(); }
+		}
+
+		inline ~StageTimer() {
+			if(trace) {
+				trace->stageMs[stage] += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			}
+		}
+
+	private:
+		StageTimer(const StageTimer &);
+		StageTimer &operator=(const StageTimer &);
+
+		OperationTrace *trace;
+		TraceStage stage;
+		std::chrono::steady_clock::time_point start;
+};
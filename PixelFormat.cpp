@@ -0,0 +1,238 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.2
+ *          - 1.0.0 - Added header driven pixel layouts and unpacking kernels.
+ *          - 1.0.1 - Added run length encoded layouts.
+ *          - 1.0.2 - Added palette expansion of 8 bit indices into BGR24 rows.
+ *
+ * @desc Pixel layouts described by the real 'BMP' header (1/4/8 bit indexed,
+ *       16/32 bit bit fields, 24/32 bit BGR) and the kernels unpacking their
+ *       rows into the 8, 24 or 32 bit rows the library works on.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include "PixelFormat.h"
+
+#include <cstring>
+
+//Channel masks of 16 and 32 bit images without bit fields.
+static const uint32_t RGB555_MASKS[4]	= { 0x00007C00, 0x000003E0, 0x0000001F, 0x00000000 };
+static const uint32_t BGRX_MASKS[4]		= { 0x00FF0000, 0x0000FF00, 0x000000FF, 0x00000000 };
+
+/*! Channel of a bit field pixel, at most its top 8 bits are scaled to 0-255 through a table */
+struct ChannelField {
+	uint32_t shift;					/*! Shift bringing the used bits to bit 0 */
+	uint32_t mask;					/*! Mask of the used bits after shifting */
+	uint8_t scale[256];				/*! Used bits to 8 bit intensity */
+};
+
+/*!
+ * @brief Checks the mask is a single run of set bits.
+ * @param [int] - Channel mask.
+ * @return [boolean] - Set if the mask is valid otherwise reset.
+ */
+static bool isContiguousMask(uint32_t mask) {
+	if(mask == 0) { return false; }
+	while((mask & 1) == 0) { mask >>= 1; }
+	return (mask & (mask + 1)) == 0;
+}
+
+/*!
+ * @brief Prepares the extraction of one channel, a missing (alpha) channel
+ *        always reads as 255.
+ * @param [int] - Channel mask.
+ * @param [ChannelField] - Field to be filled.
+ * @return None
+ */
+static void makeField(uint32_t mask, ChannelField &field) {
+	field.shift = 0;
+	field.mask = 0;
+	if(mask == 0) {
+		field.scale[0] = 255;
+		return;
+	}
+
+	while((mask & 1) == 0) { mask >>= 1; field.shift++; }
+	uint32_t bits = 0;
+	while(bits < 32 && ((mask >> bits) & 1)) { bits++; }
+
+	//Channels wider than 8 bits only keep their top 8 bits.
+	if(bits > 8) { field.shift += bits - 8; bits = 8; }
+	field.mask = (1u << bits) - 1;
+	for(uint32_t v = 0; v <= field.mask; v++) {
+		field.scale[v] = (uint8_t)((v * 255 + field.mask / 2) / field.mask);
+	}
+}
+
+/*!
+ * @brief Copies rows that are already in the working format.
+ */
+static void copyRows(const uint8_t *src, const int64_t srcStride, uint8_t *dst, const uint32_t dstStride,
+	const uint32_t rowBytes, const uint32_t rows) {
+	for(uint32_t i = 0; i < rows; i++) {
+		memcpy(dst + (size_t)i * dstStride, src + (int64_t)i * srcStride, rowBytes);
+	}
+}
+
+/*!
+ * @brief Expands 1 or 4 bit palette indices to one byte per pixel through the
+ *        levels table, the leftmost pixel is in the high bits of a byte.
+ */
+template<uint32_t BITS>
+static void unpackIndexedRows(const uint8_t *src, const int64_t srcStride, uint8_t *dst, const uint32_t dstStride,
+	const uint32_t width, const uint32_t rows, const uint8_t *levels) {
+	const uint32_t PER_BYTE = 8 / BITS;
+	const uint8_t MASK = (uint8_t)((1u << BITS) - 1);
+
+	for(uint32_t i = 0; i < rows; i++) {
+		const uint8_t *s = src + (int64_t)i * srcStride;
+		uint8_t *d = dst + (size_t)i * dstStride;
+
+		uint32_t full = width / PER_BYTE;
+		for(uint32_t j = 0; j < full; j++) {
+			uint8_t byte = s[j];
+			for(uint32_t k = 0; k < PER_BYTE; k++) {
+				d[k] = levels[(byte >> (8 - BITS * (k + 1))) & MASK];
+			}
+			d += PER_BYTE;
+		}
+		for(uint32_t k = 0; k < width % PER_BYTE; k++) {
+			d[k] = levels[(s[full] >> (8 - BITS * (k + 1))) & MASK];
+		}
+	}
+}
+
+/*!
+ * @brief Expands 16 or 32 bit bit field pixels into BGR or BGRA bytes.
+ */
+template<typename Word, uint32_t OUT_BYTES>
+static void unpackFieldRows(const uint8_t *src, const int64_t srcStride, uint8_t *dst, const uint32_t dstStride,
+	const uint32_t width, const uint32_t rows, const ChannelField *fields) {
+	const ChannelField &r = fields[0], &g = fields[1], &b = fields[2], &a = fields[3];
+
+	for(uint32_t i = 0; i < rows; i++) {
+		const uint8_t *s = src + (int64_t)i * srcStride;
+		uint8_t *d = dst + (size_t)i * dstStride;
+
+		for(uint32_t j = 0; j < width; j++) {
+			Word p;
+			memcpy(&p, s + (size_t)j * sizeof(Word), sizeof(Word));
+			d[0] = b.scale[(p >> b.shift) & b.mask];
+			d[1] = g.scale[(p >> g.shift) & g.mask];
+			d[2] = r.scale[(p >> r.shift) & r.mask];
+			if(OUT_BYTES == 4) { d[3] = a.scale[(p >> a.shift) & a.mask]; }
+			d += OUT_BYTES;
+		}
+	}
+}
+
+bool describeLayout(const uint16_t bpp, const uint32_t compression, const uint32_t *masks, const bool topDown,
+	PixelLayout &layout) {
+	layout.format = PIXEL_UNSUPPORTED;
+	layout.bitsPerPixel = bpp;
+	layout.workingBits = 0;
+	layout.topDown = topDown;
+	memset(layout.masks, 0, sizeof(layout.masks));
+
+	//Run length encoded images are stored bottom-up, RLE8 with 8 and RLE4 with 4 bit indices.
+	if(compression == COMPRESSION_RLE8 || compression == COMPRESSION_RLE4) {
+		if(topDown || bpp != ((compression == COMPRESSION_RLE8) ? 8 : 4)) { return false; }
+		layout.format = (compression == COMPRESSION_RLE8) ? PIXEL_RLE8 : PIXEL_RLE4;
+		layout.workingBits = 8;
+		return true;
+	}
+
+	bool fields = (compression == COMPRESSION_BITFIELDS || compression == COMPRESSION_ALPHABITFIELDS);
+	if(compression != COMPRESSION_RGB && !fields) { return false; }
+	if(fields && bpp != 16 && bpp != 32) { return false; }
+
+	switch(bpp) {
+		case 1: layout.format = PIXEL_INDEXED1; layout.workingBits = 8; return true;
+		case 4: layout.format = PIXEL_INDEXED4; layout.workingBits = 8; return true;
+		case 8: layout.format = PIXEL_INDEXED8; layout.workingBits = 8; return true;
+		case 24: layout.format = PIXEL_BGR24; layout.workingBits = 24; return true;
+		case 16: memcpy(layout.masks, fields ? masks : RGB555_MASKS, sizeof(layout.masks)); break;
+		case 32: memcpy(layout.masks, fields ? masks : BGRX_MASKS, sizeof(layout.masks)); break;
+		default: return false;
+	}
+
+	//Color masks must be single runs of bits inside the pixel, alpha is optional.
+	uint32_t limit = (bpp == 16) ? 0xFFFF : 0xFFFFFFFF;
+	for(uint32_t i = 0; i < 4; i++) {
+		if(layout.masks[i] & ~limit) { return false; }
+		if((i < 3 || layout.masks[i]) && !isContiguousMask(layout.masks[i])) { return false; }
+	}
+
+	//Plain BGRA bytes are used as they are, the fourth byte is kept whether it is alpha or unused.
+	if(bpp == 32 && layout.masks[0] == BGRX_MASKS[0] && layout.masks[1] == BGRX_MASKS[1] &&
+		layout.masks[2] == BGRX_MASKS[2] && (layout.masks[3] == 0 || layout.masks[3] == 0xFF000000)) {
+		layout.format = PIXEL_BGRA32;
+		layout.workingBits = 32;
+		return true;
+	}
+
+	layout.format = (bpp == 16) ? PIXEL_BITFIELDS16 : PIXEL_BITFIELDS32;
+	layout.workingBits = layout.masks[3] ? 32 : 24;
+	return true;
+}
+
+void unpackRows(const PixelLayout &layout, const uint8_t *src, const int64_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const uint32_t width, const uint32_t rows, const uint8_t *levels) {
+	uint8_t indices[16];
+	if(levels == 0) {
+		for(uint32_t k = 0; k < 16; k++) { indices[k] = (uint8_t)k; }
+		levels = indices;
+	}
+
+	switch(layout.format) {
+		case PIXEL_INDEXED1: unpackIndexedRows<1>(src, srcStride, dst, dstStride, width, rows, levels); return;
+		case PIXEL_INDEXED4: unpackIndexedRows<4>(src, srcStride, dst, dstStride, width, rows, levels); return;
+		case PIXEL_INDEXED8: copyRows(src, srcStride, dst, dstStride, width, rows); return;
+		case PIXEL_BGR24: copyRows(src, srcStride, dst, dstStride, width * 3, rows); return;
+		case PIXEL_BGRA32: copyRows(src, srcStride, dst, dstStride, width * 4, rows); return;
+		default: break;
+	}
+
+	ChannelField fields[4];
+	for(uint32_t i = 0; i < 4; i++) { makeField(layout.masks[i], fields[i]); }
+
+	if(layout.format == PIXEL_BITFIELDS16) {
+		if(layout.workingBits == 32) { unpackFieldRows<uint16_t, 4>(src, srcStride, dst, dstStride, width, rows, fields); }
+		else { unpackFieldRows<uint16_t, 3>(src, srcStride, dst, dstStride, width, rows, fields); }
+	} else if(layout.format == PIXEL_BITFIELDS32) {
+		if(layout.workingBits == 32) { unpackFieldRows<uint32_t, 4>(src, srcStride, dst, dstStride, width, rows, fields); }
+		else { unpackFieldRows<uint32_t, 3>(src, srcStride, dst, dstStride, width, rows, fields); }
+	}
+}
+
+void expandPaletteRows(const uint8_t *src, const uint32_t srcStride, uint8_t *dst, const uint32_t dstStride,
+	const uint32_t width, const uint32_t rows, const uint8_t *palette) {
+	for(uint32_t i = 0; i < rows; i++) {
+		const uint8_t *s = src + (size_t)i * srcStride;
+		uint8_t *d = dst + (size_t)i * dstStride;
+		for(uint32_t j = 0; j < width; j++, d += 3) {
+			const uint8_t *entry = palette + (size_t)s[j] * 4;
+			d[0] = entry[0];
+			d[1] = entry[1];
+			d[2] = entry[2];
+		}
+	}
+}
@@ -0,0 +1,136 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.2
+ *          - 1.0.0 - Added header driven pixel layouts and unpacking kernels.
+ *          - 1.0.1 - Added run length encoded layouts.
+ *          - 1.0.2 - Added palette expansion of 8 bit indices into BGR24 rows.
+ *
+ * @desc Pixel layouts described by the real 'BMP' header (1/4/8 bit indexed,
+ *       16/32 bit bit fields, 24/32 bit BGR) and the kernels unpacking their
+ *       rows into the 8, 24 or 32 bit rows the library works on.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+
+static const uint32_t COMPRESSION_RGB			= 0;		//Uncompressed
+static const uint32_t COMPRESSION_RLE8			= 1;		//Run length encoded 8 bit indices
+static const uint32_t COMPRESSION_RLE4			= 2;		//Run length encoded 4 bit indices
+static const uint32_t COMPRESSION_BITFIELDS		= 3;		//Uncompressed with color masks
+static const uint32_t COMPRESSION_ALPHABITFIELDS	= 6;		//Uncompressed with color and alpha masks
+
+static const uint32_t INFO_HEADER_SIZE		= 40;		//BITMAPINFOHEADER
+static const uint32_t INFO_V2_SIZE			= 52;		//Adds the RGB masks
+static const uint32_t INFO_V3_SIZE			= 56;		//Adds the alpha mask
+static const uint32_t INFO_V4_SIZE			= 108;		//BITMAPV4HEADER
+static const uint32_t INFO_V5_SIZE			= 124;		//BITMAPV5HEADER
+
+/*! Layouts of the pixel rows in a file */
+enum PixelFormat {
+	PIXEL_UNSUPPORTED = 0,
+	PIXEL_INDEXED1,					/*! 8 pixels per byte, palette indices */
+	PIXEL_INDEXED4,					/*! 2 pixels per byte, palette indices */
+	PIXEL_INDEXED8,					/*! 1 byte palette index (or gray value) per pixel */
+	PIXEL_BITFIELDS16,				/*! 16 bit words with channel masks, 5-5-5 without masks */
+	PIXEL_BGR24,					/*! B, G, R bytes */
+	PIXEL_BGRA32,					/*! B, G, R and alpha (or unused) bytes */
+	PIXEL_BITFIELDS32,				/*! 32 bit words with channel masks other than BGRA */
+	PIXEL_RLE8,						/*! Run length encoded 8 bit indices, rows of varying size */
+	PIXEL_RLE4						/*! Run length encoded 4 bit indices, rows of varying size */
+};
+
+/*! Pixel layout of an image file and of the rows it is unpacked to */
+struct PixelLayout {
+	PixelFormat format;
+	uint16_t bitsPerPixel;			/*! Bits per pixel in the file */
+	uint16_t workingBits;			/*! Bits per pixel of unpacked rows: 8/24/32 */
+	bool topDown;					/*! First row in the file is the top one */
+	uint32_t masks[4];				/*! Red, green, blue and alpha masks of bit field formats */
+};
+
+/*!
+ * @brief Describes the pixel layout of the header fields.
+ * @param [int] - Bits per pixel: 1/4/8/16/24/32.
+ * @param [int] - Compression type.
+ * @param [int] - Red, green, blue and alpha masks, only used with bit fields.
+ * @param [boolean] - Set if the height in the header is negative.
+ * @param [PixelLayout] - Receives the layout.
+ * @return [boolean] - Set if the layout is supported otherwise reset.
+ */
+bool describeLayout(const uint16_t bpp, const uint32_t compression, const uint32_t *masks, const bool topDown,
+	PixelLayout &layout);
+
+/*!
+ * @brief Checks if the file rows can be used as they are, bottom-up in the
+ *        working format.
+ * @param [PixelLayout] - Layout of the file.
+ * @return [boolean] - Set if no unpacking is needed otherwise reset.
+ */
+inline bool isNativeLayout(const PixelLayout &layout) {
+	return !layout.topDown && (layout.format == PIXEL_INDEXED8 || layout.format == PIXEL_BGR24 ||
+		layout.format == PIXEL_BGRA32);
+}
+
+/*!
+ * @brief Checks if the pixels are run length encoded, such rows can not be
+ *        addressed in the file and are decoded instead of unpacked.
+ * @param [PixelLayout] - Layout of the file.
+ * @return [boolean] - Set if the rows are run length encoded otherwise reset.
+ */
+inline bool isRunLengthLayout(const PixelLayout &layout) {
+	return layout.format == PIXEL_RLE8 || layout.format == PIXEL_RLE4;
+}
+
+/*!
+ * @brief Unpacks file rows into working rows. Every format has a loop of its
+ *        own, the format is only looked at once per call. Run length encoded
+ *        layouts are not handled, see RleDecoder.
+ * @param [PixelLayout] - Layout of the file.
+ * @param [string] - First source row.
+ * @param [int] - Distance to the next source row in bytes, negative to walk
+ *        top-down rows from the bottom.
+ * @param [string] - First destination row.
+ * @param [int] - Destination row stride in bytes.
+ * @param [int] - Width in pixels.
+ * @param [int] - Number of rows.
+ * @param [string] - Output value of every palette index of 1/4 bit formats,
+ *        null to keep the indices.
+ * @return None
+ */
+void unpackRows(const PixelLayout &layout, const uint8_t *src, const int64_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const uint32_t width, const uint32_t rows, const uint8_t *levels = 0);
+
+/*!
+ * @brief Expands 8 bit palette indices into BGR24 pixels, for images whose
+ *        palette holds colors and whose indices can not be blended.
+ * @param [string] - First source row of indices.
+ * @param [int] - Source row stride in bytes.
+ * @param [string] - First destination row.
+ * @param [int] - Destination row stride in bytes.
+ * @param [int] - Width in pixels.
+ * @param [int] - Number of rows.
+ * @param [string] - BGRA palette of 256 entries.
+ * @return None
+ */
+void expandPaletteRows(const uint8_t *src, const uint32_t srcStride, uint8_t *dst, const uint32_t dstStride,
+	const uint32_t width, const uint32_t rows, const uint8_t *palette);
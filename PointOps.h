@@ -0,0 +1,142 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.1
+ *          - 1.0.0 - Added composable lookup table point operations.
+ *          - 1.0.1 - Moved histogram counting into the statistics module.
+ *
+ * @desc Point operations on 8 bit gray images built on 256 entry lookup
+ *       tables, several tables compose into one that is applied in a single
+ *       pass with AVX2 table lookups selected at runtime.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "CpuFeatures.h"
+
+class PointLut {
+
+	public:
+		/*!
+		 * @brief Constructor creating the identity table.
+		 */
+		PointLut();
+
+		/*!
+		 * @brief Power law, out = 255 * (in / 255) ^ gamma. Values below 1 brighten.
+		 * @param [double] - Exponent, must be positive.
+		 * @return [PointLut] - Created table.
+		 */
+		static PointLut gamma(const double gamma);
+
+		/*!
+		 * @brief Adds a constant, out = in + brightness.
+		 * @param [int] - Offset, may be negative.
+		 * @return [PointLut] - Created table.
+		 */
+		static PointLut brightness(const int32_t brightness);
+
+		/*!
+		 * @brief Stretches about mid gray, out = (in - 128) * contrast + 128.
+		 * @param [double] - Gain, values below 1 reduce the contrast.
+		 * @return [PointLut] - Created table.
+		 */
+		static PointLut contrast(const double contrast);
+
+		/*!
+		 * @brief Binarizes, out = (in >= level) ? high : low.
+		 * @param [int] - Threshold level.
+		 * @param [int] - Value below the level.
+		 * @param [int] - Value at and above the level.
+		 * @return [PointLut] - Created table.
+		 */
+		static PointLut threshold(const uint8_t level, const uint8_t low = 0, const uint8_t high = 255);
+
+		/*!
+		 * @brief Negative, out = 255 - in.
+		 * @param None
+		 * @return [PointLut] - Created table.
+		 */
+		static PointLut invert(void);
+
+		/*!
+		 * @brief Stretches the window [low, high] over the full range, values
+		 *        outside of the window are clipped.
+		 * @param [int] - Input value mapped to 0.
+		 * @param [int] - Input value mapped to 255.
+		 * @return [PointLut] - Created table.
+		 */
+		static PointLut window(const uint8_t low, const uint8_t high);
+
+		/*!
+		 * @brief Histogram equalization, maps the cumulative distribution of the
+		 *        image onto the full range.
+		 * @param [int] - Histogram of the image, 256 bins.
+		 * @return [PointLut] - Created table.
+		 */
+		static PointLut equalize(const uint64_t *histogram);
+
+		/*!
+		 * @brief Composes two tables into one, the result applies this table first
+		 *        and 'next' to its output.
+		 * @param [PointLut] - Table applied second.
+		 * @return [PointLut] - Composed table.
+		 */
+		PointLut then(const PointLut &next) const;
+
+		/*!
+		 * @brief Checks whether the table maps every value onto itself.
+		 * @param None
+		 * @return [boolean] - Set if the table is the identity otherwise reset.
+		 */
+		bool isIdentity(void) const;
+
+		//GETTERS
+
+		inline uint8_t operator[](const uint8_t value) const { return table[value]; }
+		inline const uint8_t *getTable(void) const { return table; }
+
+		//SETTERS
+
+		inline void set(const uint8_t value, const uint8_t mapped) { table[value] = mapped; }
+
+	private:
+		uint8_t table[256];
+};
+
+/*!
+ * @brief Maps one row of 8 bit pixels through the table. 'src' and 'dst' may
+ *        be the same row.
+ * @param [string] - Source row.
+ * @param [string] - Destination row.
+ * @param [int] - Number of pixels.
+ * @param [PointLut] - Table to be applied.
+ * @return None
+ */
+void applyLutRow(const uint8_t *src, uint8_t *dst, const uint32_t width, const PointLut &lut);
+
+/*!
+ * @brief Same as applyLutRow() but forced to the given SIMD level, which must
+ *        be supported by the CPU. Used for testing and benchmarking.
+ */
+void applyLutRow(const uint8_t *src, uint8_t *dst, const uint32_t width, const PointLut &lut, const SimdLevel level);
@@ -0,0 +1,200 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.0
+ *          - 1.0.0 - Added streamed image pyramids.
+ *
+ * @desc Image pyramids: every level halves the previous one with a 2x2 box or a
+ *       5 tap binomial reduce, fed a strip of rows at a time so all levels are
+ *       built in one pass over the source.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include "Pyramid.h"
+
+#include <cstring>
+
+#include "ThreadPool.h"
+
+static const uint32_t REDUCE_BAND_ROWS = 8;						//Smallest row band given to a thread
+
+/*!
+ * @brief Sums horizontal pairs of pixels, an odd last pixel counts twice.
+ */
+template<uint32_t N>
+static void reduceRowBox(const uint8_t *src, const uint32_t srcWidth, uint16_t *dst, const uint32_t width) {
+	uint32_t pairs = srcWidth / 2;
+	for(uint32_t x = 0; x < pairs; x++) {
+		const uint8_t *s = src + (size_t)x * 2 * N;
+		for(uint32_t c = 0; c < N; c++) { dst[x * N + c] = (uint16_t)(s[c] + s[N + c]); }
+	}
+	if(width > pairs) {
+		const uint8_t *s = src + (size_t)(srcWidth - 1) * N;
+		for(uint32_t c = 0; c < N; c++) { dst[pairs * N + c] = (uint16_t)(s[c] * 2); }
+	}
+}
+
+/*!
+ * @brief Weighs 1 4 6 4 1 the five pixels around every other pixel, pixels
+ *        past the sides repeat the side ones.
+ */
+template<uint32_t N>
+static void reduceRowGaussian(const uint8_t *src, const uint32_t srcWidth, uint16_t *dst, const uint32_t width) {
+	static const uint16_t TAPS[5] = { 1, 4, 6, 4, 1 };
+	const int32_t last = (int32_t)srcWidth - 1;
+
+	for(uint32_t x = 0; x < width; x++) {
+		int32_t center = (int32_t)x * 2;
+		if(center >= 2 && center + 2 <= last) {
+			const uint8_t *s = src + (size_t)(center - 2) * N;
+			for(uint32_t c = 0; c < N; c++) {
+				dst[x * N + c] = (uint16_t)(s[c] + 4 * s[N + c] + 6 * s[2 * N + c] + 4 * s[3 * N + c] + s[4 * N + c]);
+			}
+			continue;
+		}
+
+		for(uint32_t c = 0; c < N; c++) {
+			uint16_t sum = 0;
+			for(int32_t k = 0; k < 5; k++) {
+				int32_t i = center + k - 2;
+				i = (i < 0) ? 0 : ((i > last) ? last : i);
+				sum += TAPS[k] * src[(size_t)i * N + c];
+			}
+			dst[x * N + c] = sum;
+		}
+	}
+}
+
+/*!
+ * @brief Reduces a row horizontally with the kernel and pixel size.
+ */
+static void reduceRow(const uint8_t *src, const uint32_t srcWidth, uint16_t *dst, const uint32_t width,
+	const uint32_t pixelBytes, const PyramidFilter filter) {
+	if(filter == PYRAMID_GAUSSIAN) {
+		switch(pixelBytes) {
+			case 1: reduceRowGaussian<1>(src, srcWidth, dst, width); break;
+			case 3: reduceRowGaussian<3>(src, srcWidth, dst, width); break;
+			default: reduceRowGaussian<4>(src, srcWidth, dst, width); break;
+		}
+	} else {
+		switch(pixelBytes) {
+			case 1: reduceRowBox<1>(src, srcWidth, dst, width); break;
+			case 3: reduceRowBox<3>(src, srcWidth, dst, width); break;
+			default: reduceRowBox<4>(src, srcWidth, dst, width); break;
+		}
+	}
+}
+
+uint32_t pyramidLevels(const uint32_t width, const uint32_t height, const uint32_t count) {
+	uint32_t levels = 0;
+	uint32_t w = width, h = height;
+	while(levels < count && levels < PYRAMID_MAX_LEVELS && (w > 1 || h > 1)) {
+		w = (w + 1) / 2;
+		h = (h + 1) / 2;
+		levels++;
+	}
+	return levels;
+}
+
+PyramidLevel::PyramidLevel() {
+	reset(0, 0, 1, PYRAMID_BOX);
+}
+
+void PyramidLevel::reset(const uint32_t srcWidth, const uint32_t srcHeight, const uint32_t pixelBytes, const PyramidFilter filter) {
+	this->srcWidth = srcWidth;
+	this->srcHeight = srcHeight;
+	this->pixelBytes = pixelBytes;
+	this->filter = filter;
+
+	width = (srcWidth + 1) / 2;
+	height = (srcHeight + 1) / 2;
+	stride = (width * pixelBytes + 3) & ~3u;
+
+	received = 0;
+	nextRow = 0;
+	firstRow = 0;
+	base = 0;
+}
+
+uint32_t PyramidLevel::lastInput(const uint32_t row) const {
+	uint32_t last = row * 2 + ((filter == PYRAMID_GAUSSIAN) ? 2 : 1);
+	return (last < srcHeight) ? last : srcHeight - 1;
+}
+
+uint32_t PyramidLevel::push(const uint8_t *rows, const uint32_t count, const uint32_t stride) {
+	const size_t rowSize = (size_t)width * pixelBytes;
+
+	//Reducing the new rows horizontally behind the kept ones.
+	size_t needed = (size_t)(received + count - base) * rowSize;
+	if(reduced.size() < needed) { reduced.resize(needed); }
+	ThreadPool::getShared().parallelFor(0, count, REDUCE_BAND_ROWS, [&](uint32_t first, uint32_t last) {
+		for(uint32_t i = first; i < last; i++) {
+			reduceRow(rows + (size_t)i * stride, srcWidth, &reduced[(received + i - base) * rowSize], width, pixelBytes, filter);
+		}
+	});
+	received += count;
+
+	//Completing every level row whose rows above are all in.
+	uint32_t end = nextRow;
+	while(end < height && lastInput(end) < received) { end++; }
+	firstRow = nextRow;
+	if(output.size() < (size_t)(end - firstRow) * this->stride) { output.resize((size_t)(end - firstRow) * this->stride); }
+
+	ThreadPool::getShared().parallelFor(firstRow, end, REDUCE_BAND_ROWS, [&](uint32_t first, uint32_t last) {
+		const int32_t top = (int32_t)srcHeight - 1;
+		for(uint32_t y = first; y < last; y++) {
+			uint8_t *dst = &output[(size_t)(y - firstRow) * this->stride];
+			int32_t center = (int32_t)y * 2;
+
+			if(filter == PYRAMID_GAUSSIAN) {
+				const uint16_t *r[5];
+				for(int32_t k = 0; k < 5; k++) {
+					int32_t i = center + k - 2;
+					i = (i < 0) ? 0 : ((i > top) ? top : i);
+					r[k] = &reduced[(i - base) * rowSize];
+				}
+				for(size_t i = 0; i < rowSize; i++) {
+					uint32_t sum = r[0][i] + 4u * r[1][i] + 6u * r[2][i] + 4u * r[3][i] + r[4][i];
+					dst[i] = (uint8_t)((sum + 128) >> 8);
+				}
+			} else {
+				const uint16_t *r0 = &reduced[(center - base) * rowSize];
+				const uint16_t *r1 = &reduced[(((center < top) ? center + 1 : top) - base) * rowSize];
+				for(size_t i = 0; i < rowSize; i++) { dst[i] = (uint8_t)((r0[i] + r1[i] + 2) >> 2); }
+			}
+			memset(dst + rowSize, 0, this->stride - rowSize);
+		}
+	});
+	nextRow = end;
+
+	//Dropping the rows no later level row needs.
+	uint32_t keep = received;
+	if(nextRow < height) {
+		int32_t lowest = (int32_t)nextRow * 2 - ((filter == PYRAMID_GAUSSIAN) ? 2 : 0);
+		keep = (lowest > 0) ? (uint32_t)lowest : 0;
+	}
+	if(keep > base) {
+		if(received > keep) {
+			memmove(reduced.data(), &reduced[(keep - base) * rowSize], (size_t)(received - keep) * rowSize * sizeof(uint16_t));
+		}
+		base = keep;
+	}
+	return end - firstRow;
+}
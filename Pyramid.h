@@ -0,0 +1,116 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.0
+ *          - 1.0.0 - Added streamed image pyramids.
+ *
+ * @desc Image pyramids: every level halves the previous one with a 2x2 box or a
+ *       5 tap binomial reduce, fed a strip of rows at a time so all levels are
+ *       built in one pass over the source.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <vector>
+
+/*! Reduce kernels of the pyramid levels */
+enum PyramidFilter {
+	PYRAMID_BOX = 0,				/*! Mean of 2x2 pixels */
+	PYRAMID_GAUSSIAN				/*! 5x5 binomial (1 4 6 4 1) centered on every other pixel */
+};
+
+static const uint32_t PYRAMID_MAX_LEVELS	= 16;		//Most levels below the source
+static const uint32_t PYRAMID_STRIP_ROWS	= 256;		//Source rows fed at once to in-memory pyramids
+
+/*!
+ * @brief Returns the number of levels an image can be halved into before it is
+ *        a single pixel, limited to the given count and PYRAMID_MAX_LEVELS.
+ * @param [int] - Source width.
+ * @param [int] - Source height.
+ * @param [int] - Levels asked for.
+ * @return [int] - Levels available.
+ */
+uint32_t pyramidLevels(const uint32_t width, const uint32_t height, const uint32_t count);
+
+class PyramidLevel {
+
+	public:
+		/*!
+		 * @brief Constructor of the class initializing all the data variable(s).
+		 */
+		PyramidLevel();
+
+		/*!
+		 * @brief Prepares the reduction of an image of the given size, forgetting an
+		 *        earlier one. The level is (width + 1) / 2 x (height + 1) / 2, odd
+		 *        sides repeat their last pixel.
+		 * @param [int] - Width of the image above.
+		 * @param [int] - Height of the image above.
+		 * @param [int] - Bytes per pixel (1, 3 or 4).
+		 * @param [PyramidFilter] - Reduce kernel.
+		 * @return None
+		 */
+		void reset(const uint32_t srcWidth, const uint32_t srcHeight, const uint32_t pixelBytes, const PyramidFilter filter);
+
+		/*!
+		 * @brief Feeds the next bottom-up rows of the image above. Rows are reduced
+		 *        horizontally right away and kept only until no later level row
+		 *        needs them. The level rows completed by the feed are then readable
+		 *        with getRows() until the next call.
+		 * @param [string] - First row fed.
+		 * @param [int] - Number of rows.
+		 * @param [int] - Row stride in bytes.
+		 * @return [int] - Number of level rows completed.
+		 */
+		uint32_t push(const uint8_t *rows, const uint32_t count, const uint32_t stride);
+
+		//GETTERS
+
+		inline uint32_t getWidth(void) const { return width; }
+		inline uint32_t getHeight(void) const { return height; }
+		inline uint32_t getStride(void) const { return stride; }
+		inline uint32_t getFirstRow(void) const { return firstRow; }	/*! Level row of getRows() */
+		inline const uint8_t *getRows(void) const { return output.data(); }
+
+	private:
+		/*!
+		 * @brief Returns the last row of the image above the level row depends on.
+		 */
+		uint32_t lastInput(const uint32_t row) const;
+
+		uint32_t srcWidth;
+		uint32_t srcHeight;
+		uint32_t width;
+		uint32_t height;
+		uint32_t stride;						/*! Row size in bytes of the level rows, 4 byte aligned */
+		uint32_t pixelBytes;
+		PyramidFilter filter;
+
+		uint32_t received;						/*! Rows of the image above fed so far */
+		uint32_t nextRow;						/*! Next level row to be completed */
+		uint32_t firstRow;
+
+		std::vector<uint16_t> reduced;			/*! Horizontally reduced rows [base, received) */
+		uint32_t base;
+		std::vector<uint8_t> output;			/*! Rows completed by the last feed */
+};
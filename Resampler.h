@@ -0,0 +1,119 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.2
+ *          - 1.0.0 - Added separable fixed point resampler.
+ *          - 1.0.1 - Split into horizontal and vertical passes for row windows.
+ *          - 1.0.2 - Took the intermediate buffer from the buffer pool.
+ *
+ * @desc Two pass separable resampling of 8 bit planes with precomputed filter tables.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <vector>
+
+/*! Reconstruction filters of the resampler */
+enum ResampleFilter {
+	FILTER_NEAREST = 0,				/*! Nearest source pixel */
+	FILTER_BILINEAR,				/*! Triangle, support 1 */
+	FILTER_BICUBIC,					/*! Keys cubic (a = -0.5), support 2 */
+	FILTER_LANCZOS3,				/*! Windowed sinc, support 3 */
+	FILTER_AREA						/*! Box averaging the covered source area */
+};
+
+static const int RESAMPLE_BITS			= 14;		//Fixed point bits of the filter weights
+
+/*!
+ * Fixed point weights of one axis, computed once per output row or column.
+ * Output pixel 'i' is the sum of weights[i * maxTaps + k] * in[start[i] + k]
+ * for k < taps[i], with the weights of every pixel summing to 1 << RESAMPLE_BITS.
+ */
+struct FilterTable {
+	std::vector<int32_t> start;
+	std::vector<int32_t> taps;
+	std::vector<int16_t> weights;
+	uint32_t maxTaps;
+};
+
+/*!
+ * @brief Builds the filter table resampling 'inSize' samples into 'outSize'.
+ *        Downscaling widens the filter by the scale factor to avoid aliasing.
+ * @param [int] - Input size.
+ * @param [int] - Output size.
+ * @param [ResampleFilter] - Filter to be used.
+ * @param [FilterTable] - Table to be filled.
+ * @return None
+ */
+void buildFilterTable(const uint32_t inSize, const uint32_t outSize, const ResampleFilter filter, FilterTable &table);
+
+/*!
+ * @brief Resamples the source plane into the destination plane, horizontally
+ *        then vertically. Both passes run in parallel row bands.
+ * @param [string] - Source plane.
+ * @param [int] - Source width.
+ * @param [int] - Source height.
+ * @param [int] - Source row stride in bytes.
+ * @param [string] - Destination plane.
+ * @param [int] - Destination width.
+ * @param [int] - Destination height.
+ * @param [int] - Destination row stride in bytes.
+ * @param [ResampleFilter] - Filter to be used.
+ * @return None
+ */
+void resamplePlane(const uint8_t *src, const uint32_t srcWidth, const uint32_t srcHeight, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstWidth, const uint32_t dstHeight, const uint32_t dstStride,
+	const ResampleFilter filter);
+
+/*!
+ * @brief Horizontal pass, resamples every row of the source rows to the
+ *        destination width. Rows run in parallel bands.
+ * @param [string] - First source row.
+ * @param [int] - Number of rows.
+ * @param [int] - Source row stride in bytes.
+ * @param [string] - First destination row.
+ * @param [int] - Destination row stride in bytes.
+ * @param [FilterTable] - Horizontal filter table.
+ * @return None
+ */
+void resampleHorizontal(const uint8_t *src, const uint32_t rows, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const FilterTable &horTable);
+
+/*!
+ * @brief Vertical pass of destination rows [first, last). The source holds the
+ *        horizontally resampled rows starting at row 'srcFirstRow', so a window
+ *        of the image is enough as long as it covers the taps of those rows.
+ * @param [string] - First row of the source window.
+ * @param [int] - Source row stride in bytes.
+ * @param [int] - Image row held by the first row of the window.
+ * @param [string] - Destination row 'first'.
+ * @param [int] - Destination row stride in bytes.
+ * @param [int] - Destination width.
+ * @param [int] - First destination row.
+ * @param [int] - One past the last destination row.
+ * @param [FilterTable] - Vertical filter table.
+ * @return None
+ */
+void resampleVertical(const uint8_t *src, const uint32_t srcStride, const int32_t srcFirstRow,
+	uint8_t *dst, const uint32_t dstStride, const uint32_t dstWidth,
+	const uint32_t first, const uint32_t last, const FilterTable &verTable);
@@ -0,0 +1,272 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.1
+ *          - 1.0.0 - Added RLE8/RLE4 row decoding and RLE8 encoding.
+ *          - 1.0.1 - Sized the encoder bound for the worst case, bands check their slots.
+ *
+ * @desc Run length encoded 'BMP' pixels: a decoder handing out rows of RLE8 and
+ *       RLE4 images one band at a time, from memory or read from the file in
+ *       chunks, and a banded RLE8 encoder.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include "RunLength.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "BitmapIO.h"
+#include "ThreadPool.h"
+
+static const uint32_t RLE_MIN_RUN = 3;							//Shortest run worth a code of its own
+static const uint32_t RLE_MAX_COUNT = 255;						//Most pixels of one code
+
+/*!
+ * @brief Counts the bytes equal to the first one, eight at a time.
+ * @param [string] - First byte.
+ * @param [int] - Most bytes to count.
+ * @return [int] - Length of the run.
+ */
+static inline uint32_t runLength(const uint8_t *p, const uint32_t limit) {
+	const uint64_t pattern = 0x0101010101010101ull * p[0];
+	uint32_t n = 1;
+	while(n + 8 <= limit) {
+		uint64_t word;
+		memcpy(&word, p + n, sizeof(word));
+		if(word != pattern) { break; }
+		n += 8;
+	}
+	while(n < limit && p[n] == p[0]) { n++; }
+	return n;
+}
+
+/*!
+ * @brief RLE8 encodes rows, each followed by an end of line code, into a slot
+ *        of the given size.
+ */
+static size_t encodeRows(const uint8_t *src, const uint32_t srcStride, const uint32_t width, const uint32_t rows,
+	uint8_t *out, const size_t slot) {
+	uint8_t *o = out;
+	const size_t rowBound = rleBound(width, 1);
+
+	for(uint32_t r = 0; r < rows; r++) {
+		//Checking a whole row fits before writing it, rows never outgrow their bound.
+		if(slot - (size_t)(o - out) < rowBound) { throw std::length_error("RLE8 band exceeds its slot"); }
+		const uint8_t *s = src + (size_t)r * srcStride;
+		uint32_t i = 0;
+
+		while(i < width) {
+			uint32_t run = runLength(s + i, (width - i < RLE_MAX_COUNT) ? width - i : RLE_MAX_COUNT);
+			if(run >= RLE_MIN_RUN) {
+				*o++ = (uint8_t)run;
+				*o++ = s[i];
+				i += run;
+				continue;
+			}
+
+			//Collecting the indices up to the next long run.
+			uint32_t j = i + run;
+			while(j < width && j - i < RLE_MAX_COUNT) {
+				uint32_t next = runLength(s + j, (width - j < RLE_MIN_RUN) ? width - j : RLE_MIN_RUN);
+				if(next >= RLE_MIN_RUN) { break; }
+				j += next;
+			}
+			if(j - i > RLE_MAX_COUNT) { j = i + RLE_MAX_COUNT; }
+
+			//Absolute blocks need three indices, shorter ones are written as runs.
+			uint32_t n = j - i;
+			if(n >= RLE_MIN_RUN) {
+				*o++ = 0;
+				*o++ = (uint8_t)n;
+				memcpy(o, s + i, n);
+				o += n;
+				if(n & 1) { *o++ = 0; }
+			} else if(n == 2 && s[i] == s[i + 1]) {
+				*o++ = 2;
+				*o++ = s[i];
+			} else {
+				for(uint32_t k = 0; k < n; k++) {
+					*o++ = 1;
+					*o++ = s[i + k];
+				}
+			}
+			i = j;
+		}
+
+		*o++ = 0;
+		*o++ = 0;
+	}
+	return (size_t)(o - out);
+}
+
+size_t encodeRle8(const uint8_t *src, const uint32_t srcStride, const uint32_t width, const uint32_t rows, uint8_t *out) {
+	uint32_t bands = (rows + RLE_BAND_ROWS - 1) / RLE_BAND_ROWS;
+	size_t bandBound = rleBound(width, RLE_BAND_ROWS);
+	std::vector<size_t> sizes(bands);
+
+	//Every band is encoded into a slot of its own, then the slots are closed up.
+	ThreadPool::getShared().parallelFor(0, bands, 1, [&](uint32_t first, uint32_t last) {
+		for(uint32_t b = first; b < last; b++) {
+			uint32_t r0 = b * RLE_BAND_ROWS;
+			uint32_t count = (rows - r0 < RLE_BAND_ROWS) ? rows - r0 : RLE_BAND_ROWS;
+			sizes[b] = encodeRows(src + (size_t)r0 * srcStride, srcStride, width, count, out + (size_t)b * bandBound,
+				rleBound(width, count));
+		}
+	});
+
+	size_t total = 0;
+	for(uint32_t b = 0; b < bands; b++) {
+		if(total != (size_t)b * bandBound) { memmove(out + total, out + (size_t)b * bandBound, sizes[b]); }
+		total += sizes[b];
+	}
+	return total;
+}
+
+RleDecoder::RleDecoder() {
+	reset(PIXEL_RLE8, 0, 0, 0);
+}
+
+void RleDecoder::reset(const PixelFormat format, const uint32_t width, const uint32_t height, const uint64_t size,
+	const uint8_t *levels) {
+	this->format = format;
+	this->width = width;
+	this->height = height;
+	this->size = size;
+	for(uint32_t i = 0; i < 256; i++) { this->levels[i] = levels ? levels[i] : (uint8_t)i; }
+
+	furthest.offset = 0;
+	furthest.row = 0;
+	furthest.column = 0;
+	furthest.ended = (height == 0);
+	rowStarts.assign(1, furthest);
+
+	chunk.clear();
+	chunkStart = 0;
+	fetched = 0;
+}
+
+void RleDecoder::decode(const uint8_t *data, const uint32_t first, const uint32_t count, uint8_t *dst,
+	const uint32_t dstStride) {
+	RleCursor cursor = seek(first, count, dst, dstStride);
+	run(data, 0, size, cursor, first, first + count, dst, dstStride);
+	if(cursor.offset > furthest.offset || cursor.row > furthest.row) { furthest = cursor; }
+}
+
+bool RleDecoder::read(const FileReader &file, const uint64_t offset, const uint32_t first, const uint32_t count,
+	uint8_t *dst, const uint32_t dstStride) {
+	RleCursor cursor = seek(first, count, dst, dstStride);
+	uint32_t last = first + count;
+
+	while(!cursor.ended && cursor.row < last) {
+		//Reading the next chunk once the current one has no whole code left.
+		uint64_t chunkEnd = chunkStart + chunk.size();
+		if(cursor.offset < chunkStart || cursor.offset >= chunkEnd ||
+			(chunkEnd - cursor.offset < RLE_MAX_CODE && chunkEnd < size)) {
+			if(cursor.offset >= size) { cursor.ended = true; break; }
+			uint64_t bytes = (size - cursor.offset < RLE_CHUNK_SIZE) ? size - cursor.offset : RLE_CHUNK_SIZE;
+
+			chunk.resize((size_t)bytes);
+			chunkStart = cursor.offset;
+			chunkEnd = chunkStart + bytes;
+			if(!file.read(offset + chunkStart, chunk.data(), (size_t)bytes)) {
+				chunk.clear();
+				return false;
+			}
+			fetched += bytes;
+		}
+
+		run(chunk.data(), chunkStart, chunkEnd, cursor, first, last, dst, dstStride);
+	}
+
+	if(cursor.offset > furthest.offset || cursor.row > furthest.row) { furthest = cursor; }
+	return true;
+}
+
+RleCursor RleDecoder::seek(const uint32_t first, const uint32_t count, uint8_t *dst, const uint32_t dstStride) const {
+	for(uint32_t i = 0; i < count; i++) { memset(dst + (size_t)i * dstStride, levels[0], width); }
+	return (first < rowStarts.size()) ? rowStarts[first] : furthest;
+}
+
+void RleDecoder::run(const uint8_t *data, const uint64_t begin, const uint64_t end, RleCursor &cursor,
+	const uint32_t first, const uint32_t last, uint8_t *dst, const uint32_t dstStride) {
+	//Codes cut short by the end of the data wait for the next chunk, unless it is the end of the pixels.
+	bool complete = (end >= size);
+
+	while(!cursor.ended && cursor.row < last) {
+		uint64_t left = end - cursor.offset;
+		if(left < RLE_MAX_CODE && !complete) { return; }
+		if(left < 2) { cursor.ended = true; return; }
+
+		const uint8_t *p = data + (cursor.offset - begin);
+		uint8_t *row = (cursor.row >= first) ? dst + (size_t)(cursor.row - first) * dstStride : 0;
+		uint32_t column = cursor.column;
+		uint32_t count = p[0];
+
+		if(count > 0) {
+			//Run of one index, or of two alternating 4 bit indices.
+			uint32_t n = (column >= width) ? 0 : ((width - column < count) ? width - column : count);
+			if(row && format == PIXEL_RLE8) {
+				memset(row + column, levels[p[1]], n);
+			} else if(row) {
+				uint8_t pair[2] = { levels[p[1] >> 4], levels[p[1] & 0x0F] };
+				for(uint32_t k = 0; k < n; k++) { row[column + k] = pair[k & 1]; }
+			}
+			cursor.column = column + n;
+			cursor.offset += 2;
+		} else if(p[1] == 0) {
+			cursor.offset += 2;
+			moveTo(cursor, cursor.row + 1, 0);
+		} else if(p[1] == 1) {
+			cursor.offset += 2;
+			cursor.ended = true;
+		} else if(p[1] == 2) {
+			if(left < 4) { cursor.ended = true; return; }
+			cursor.offset += 4;
+			moveTo(cursor, cursor.row + p[3], column + p[2]);
+		} else {
+			//Absolute block of indices, padded to a whole number of words.
+			count = p[1];
+			uint64_t bytes = (format == PIXEL_RLE8) ? count : (count + 1) / 2;
+			bytes += bytes & 1;
+			if(left < 2 + bytes) { cursor.ended = true; return; }
+
+			uint32_t n = (column >= width) ? 0 : ((width - column < count) ? width - column : count);
+			const uint8_t *s = p + 2;
+			if(row && format == PIXEL_RLE8) {
+				for(uint32_t k = 0; k < n; k++) { row[column + k] = levels[s[k]]; }
+			} else if(row) {
+				for(uint32_t k = 0; k < n; k++) { row[column + k] = levels[(k & 1) ? s[k >> 1] & 0x0F : s[k >> 1] >> 4]; }
+			}
+			cursor.column = column + n;
+			cursor.offset += 2 + bytes;
+		}
+	}
+}
+
+void RleDecoder::moveTo(RleCursor &cursor, const uint32_t row, const uint32_t column) {
+	cursor.row = row;
+	cursor.column = column;
+	if(row >= height) { cursor.ended = true; }
+
+	//Rows jumped over by a delta start where the codes of the row they land on start.
+	uint32_t lastRow = (row < height) ? row : height - 1;
+	while(rowStarts.size() <= lastRow) { rowStarts.push_back(cursor); }
+}
@@ -0,0 +1,163 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.1
+ *          - 1.0.0 - Added RLE8/RLE4 row decoding and RLE8 encoding.
+ *          - 1.0.1 - Sized the encoder bound for the worst case, bands check their slots.
+ *
+ * @desc Run length encoded 'BMP' pixels: a decoder handing out rows of RLE8 and
+ *       RLE4 images one band at a time, from memory or read from the file in
+ *       chunks, and a banded RLE8 encoder.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <vector>
+
+#include "PixelFormat.h"
+
+class FileReader;
+
+static const uint32_t RLE_MAX_CODE		= 258;		//Longest code: escape, count, 255 indices and padding
+static const uint32_t RLE_CHUNK_SIZE	= 65536;	//Encoded bytes read from a file at once
+static const uint32_t RLE_BAND_ROWS		= 64;		//Rows encoded by one task
+
+/*!
+ * @brief Largest size of encoded rows, every row ending with an end of line.
+ *        No code takes more than two bytes a pixel: a lone index is a run of
+ *        one and a padded absolute block of three indices takes six bytes.
+ * @param [int] - Width in pixels.
+ * @param [int] - Number of rows.
+ * @return [int] - Size in bytes.
+ */
+inline size_t rleBound(const uint32_t width, const uint32_t rows) {
+	return ((size_t)width * 2 + 2) * rows;
+}
+
+/*!
+ * @brief RLE8 encodes rows. Runs of three or more equal indices become runs,
+ *        the indices between them absolute blocks. Every row ends with an end
+ *        of line code, the end of bitmap code is left to the caller. Bands of
+ *        rows are encoded in parallel, each into a slot of rleBound() bytes.
+ *        Throws if a band would outgrow its slot.
+ * @param [string] - First row.
+ * @param [int] - Row stride in bytes.
+ * @param [int] - Width in pixels.
+ * @param [int] - Number of rows.
+ * @param [string] - Output, sized with rleBound().
+ * @return [int] - Number of bytes written.
+ */
+size_t encodeRle8(const uint8_t *src, const uint32_t srcStride, const uint32_t width, const uint32_t rows, uint8_t *out);
+
+/*! Position of a decoder in the encoded pixels, kept at row starts to resume there */
+struct RleCursor {
+	uint64_t offset;				/*! Offset of the next code from the first encoded byte */
+	uint32_t row;					/*! Row the next code writes to, 0 is the bottom row */
+	uint32_t column;				/*! Column the next code writes to */
+	bool ended;						/*! End of the bitmap reached, the rest reads as index 0 */
+};
+
+class RleDecoder {
+
+	public:
+		/*!
+		 * @brief Constructor of the class initializing all the data variable(s).
+		 */
+		RleDecoder();
+
+		/*!
+		 * @brief Prepares the decoding of an image, forgetting an earlier one.
+		 * @param [PixelFormat] - PIXEL_RLE8 or PIXEL_RLE4.
+		 * @param [int] - Width in pixels.
+		 * @param [int] - Height in pixels.
+		 * @param [int] - Size of the encoded pixels in bytes.
+		 * @param [string] - Output value of every palette index, null to keep the indices.
+		 * @return None
+		 */
+		void reset(const PixelFormat format, const uint32_t width, const uint32_t height, const uint64_t size,
+			const uint8_t *levels = 0);
+
+		/*!
+		 * @brief Decodes rows from the encoded pixels in memory. The start of every
+		 *        decoded row is remembered, so rows may be asked for in any order
+		 *        and decoding only resumes from the nearest row start. Pixels the
+		 *        codes skip read as index 0.
+		 * @param [string] - Encoded pixels.
+		 * @param [int] - First row, 0 is the bottom row.
+		 * @param [int] - Number of rows.
+		 * @param [string] - Destination of the first row, one byte per pixel.
+		 * @param [int] - Destination row stride in bytes.
+		 * @return None
+		 */
+		void decode(const uint8_t *data, const uint32_t first, const uint32_t count, uint8_t *dst, const uint32_t dstStride);
+
+		/*!
+		 * @brief Same as decode() but the encoded pixels are read from the file in
+		 *        chunks of RLE_CHUNK_SIZE bytes as the codes are needed.
+		 * @param [FileReader] - Open file.
+		 * @param [int] - File offset of the encoded pixels.
+		 * @param [int] - First row, 0 is the bottom row.
+		 * @param [int] - Number of rows.
+		 * @param [string] - Destination of the first row, one byte per pixel.
+		 * @param [int] - Destination row stride in bytes.
+		 * @return [boolean] - Set if the file could be read otherwise reset.
+		 */
+		bool read(const FileReader &file, const uint64_t offset, const uint32_t first, const uint32_t count,
+			uint8_t *dst, const uint32_t dstStride);
+
+		//GETTERS
+
+		inline uint64_t getFetchedBytes(void) const { return fetched; }
+
+	private:
+		/*!
+		 * @brief Starts decoding at the row, clearing the destination rows.
+		 */
+		RleCursor seek(const uint32_t first, const uint32_t count, uint8_t *dst, const uint32_t dstStride) const;
+
+		/*!
+		 * @brief Runs the codes of data[begin, end) until the row 'last' starts, the
+		 *        data runs out or the bitmap ends. Only rows from 'first' are written.
+		 */
+		void run(const uint8_t *data, const uint64_t begin, const uint64_t end, RleCursor &cursor,
+			const uint32_t first, const uint32_t last, uint8_t *dst, const uint32_t dstStride);
+
+		/*!
+		 * @brief Moves the cursor to a later row, remembering the starts of new rows.
+		 */
+		void moveTo(RleCursor &cursor, const uint32_t row, const uint32_t column);
+
+		PixelFormat format;
+		uint32_t width;
+		uint32_t height;
+		uint64_t size;
+		uint8_t levels[256];
+
+		std::vector<RleCursor> rowStarts;	/*! Cursor at the start of every row decoded so far */
+		RleCursor furthest;					/*! Furthest cursor reached */
+
+		std::vector<uint8_t> chunk;			/*! Encoded bytes read from the file */
+		uint64_t chunkStart;				/*! Offset of the chunk in the encoded pixels */
+		uint64_t fetched;					/*! Bytes read from the file */
+};
@@ -0,0 +1,180 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.0
+ *          - 1.0.0 - Added shared row band thread pool.
+ *
+ * @desc Shared worker thread pool splitting row ranges into bands.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <exception>
+#include <memory>
+
+/*! State of one parallelFor() call shared by the caller and the helpers */
+struct BandJob {
+	ThreadPool::BandFunction fn;
+	uint32_t begin;
+	uint32_t end;
+	uint32_t bandRows;
+	uint32_t bandCount;
+
+	std::atomic<uint32_t> nextBand;
+	std::atomic<uint32_t> pending;
+
+	std::mutex doneMutex;
+	std::condition_variable doneCond;
+	std::exception_ptr error;
+};
+
+/*!
+ * @brief Claims and runs bands of the job until none are left.
+ */
+static void runBands(BandJob &job) {
+	for(;;) {
+		uint32_t band = job.nextBand++;
+		if(band >= job.bandCount) { break; }
+
+		uint32_t first = job.begin + band * job.bandRows;
+		uint32_t last = (job.end - first > job.bandRows) ? first + job.bandRows : job.end;
+
+		try {
+			job.fn(first, last);
+		} catch(...) {
+			std::lock_guard<std::mutex> lock(job.doneMutex);
+			if(!job.error) { job.error = std::current_exception(); }
+		}
+
+		if(--job.pending == 0) {
+			std::lock_guard<std::mutex> lock(job.doneMutex);
+			job.doneCond.notify_all();
+		}
+	}
+}
+
+ThreadPool::ThreadPool(const uint32_t threads) {
+	threadCount = 1;
+	stopping = false;
+	startWorkers(threads);
+}
+
+ThreadPool::~ThreadPool() {
+	stopWorkers();
+}
+
+ThreadPool &ThreadPool::getShared(void) {
+	static ThreadPool pool;
+	return pool;
+}
+
+void ThreadPool::setThreadCount(const uint32_t threads) {
+	stopWorkers();
+	startWorkers(threads);
+}
+
+void ThreadPool::startWorkers(const uint32_t threads) {
+	uint32_t count = threads;
+	if(count == 0) { count = std::thread::hardware_concurrency(); }
+	if(count == 0) { count = 1; }
+
+	threadCount = count;
+	stopping = false;
+
+	//Caller of parallelFor() is one of the threads.
+	for(uint32_t i = 1; i < count; i++) {
+		workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+	}
+}
+
+void ThreadPool::stopWorkers(void) {
+	{
+		std::lock_guard<std::mutex> lock(taskMutex);
+		stopping = true;
+	}
+	taskCond.notify_all();
+
+	for(size_t i = 0; i < workers.size(); i++) {
+		workers[i].join();
+	}
+	workers.clear();
+}
+
+void ThreadPool::workerLoop(void) {
+	for(;;) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(taskMutex);
+			taskCond.wait(lock, [this] { return stopping || !tasks.empty(); });
+			if(tasks.empty()) { return; }
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+		task();
+	}
+}
+
+void ThreadPool::parallelFor(const uint32_t begin, const uint32_t end, const uint32_t minRows, const BandFunction &fn) {
+	if(end <= begin) { return; }
+
+	uint32_t rows = end - begin;
+	uint32_t minBand = minRows ? minRows : 1;
+
+	//Running inline when there is nothing to split.
+	if(threadCount <= 1 || rows <= minBand) {
+		fn(begin, end);
+		return;
+	}
+
+	//A few bands per thread keeps the load balanced when rows differ in cost.
+	uint32_t bandRows = (rows + threadCount * 4 - 1) / (threadCount * 4);
+	if(bandRows < minBand) { bandRows = minBand; }
+
+	std::shared_ptr<BandJob> job = std::make_shared<BandJob>();
+	job->fn = fn;
+	job->begin = begin;
+	job->end = end;
+	job->bandRows = bandRows;
+	job->bandCount = (rows + bandRows - 1) / bandRows;
+	job->nextBand = 0;
+	job->pending = job->bandCount;
+
+	uint32_t helpers = job->bandCount - 1;
+	if(helpers > threadCount - 1) { helpers = threadCount - 1; }
+
+	{
+		std::lock_guard<std::mutex> lock(taskMutex);
+		for(uint32_t i = 0; i < helpers; i++) {
+			tasks.push_back([job] { runBands(*job); });
+		}
+	}
+	taskCond.notify_all();
+
+	runBands(*job);
+
+	{
+		std::unique_lock<std::mutex> lock(job->doneMutex);
+		job->doneCond.wait(lock, [&job] { return job->pending.load() == 0; });
+	}
+
+	if(job->error) { std::rethrow_exception(job->error); }
+}
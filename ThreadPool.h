@@ -0,0 +1,172 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.1
+ *          - 1.0.0 - Added shared row band thread pool.
+ *          - 1.0.1 - Added bounded queue.
+ *
+ * @desc Shared worker thread pool splitting row ranges into bands.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+
+	public:
+		/*! Work done on rows [begin, end) of a band */
+		typedef std::function<void(uint32_t begin, uint32_t end)> BandFunction;
+
+		/*!
+		 * @brief Constructor starting the worker threads.
+		 * @param [int] - Number of threads including the caller, 0 for all cores.
+		 */
+		explicit ThreadPool(const uint32_t threads = 0);
+
+		/*!
+		 * @brief Destructor, finishes queued work and joins the workers.
+		 */
+		virtual ~ThreadPool();
+
+		/*!
+		 * @brief Changes the number of threads. Must not be called while
+		 *        parallelFor() is running on this pool.
+		 * @param [int] - Number of threads including the caller, 0 for all cores.
+		 * @return None
+		 */
+		void setThreadCount(const uint32_t threads);
+
+		/*!
+		 * @brief Splits [begin, end) into bands and runs them on the pool. The
+		 *        calling thread works on bands too and returns once all are done.
+		 *        The first exception thrown by a band is rethrown to the caller.
+		 * @param [int] - First row.
+		 * @param [int] - One past the last row.
+		 * @param [int] - Minimum number of rows per band.
+		 * @param [BandFunction] - Work to be done for each band.
+		 * @return None
+		 */
+		void parallelFor(const uint32_t begin, const uint32_t end, const uint32_t minRows, const BandFunction &fn);
+
+		//GETTERS
+
+		inline uint32_t getThreadCount(void) const { return threadCount; }
+
+		/*!
+		 * @brief Returns the pool shared by the whole library.
+		 * @param None
+		 * @return [ThreadPool] - Shared pool.
+		 */
+		static ThreadPool &getShared(void);
+
+	private:
+		ThreadPool(const ThreadPool &);
+		ThreadPool &operator=(const ThreadPool &);
+
+		/*!
+		 * @brief Runs queued tasks until the pool is stopped.
+		 */
+		void workerLoop(void);
+
+		void startWorkers(const uint32_t threads);
+		void stopWorkers(void);
+
+		uint32_t threadCount;
+		bool stopping;
+
+		std::vector<std::thread> workers;
+		std::deque<std::function<void()> > tasks;
+		std::mutex taskMutex;
+		std::condition_variable taskCond;
+};
+
+/*! First in first out queue of limited size, pushing blocks while it is full */
+template <class T>
+class BoundedQueue {
+
+	public:
+		/*!
+		 * @brief Constructor creating an empty open queue.
+		 * @param [int] - Maximum number of queued items, at least 1.
+		 */
+		explicit BoundedQueue(const size_t capacity) : capacity(capacity ? capacity : 1), closed(false) { }
+
+		/*!
+		 * @brief Appends an item, waiting while the queue is full.
+		 * @param [T] - Item to be moved into the queue.
+		 * @return [boolean] - Set if the item is queued, reset if the queue is closed.
+		 */
+		bool push(T &&item) {
+			std::unique_lock<std::mutex> lock(queueMutex);
+			notFull.wait(lock, [this]() { return closed || items.size() < capacity; });
+			if(closed) { return false; }
+			items.push_back(std::move(item));
+			notEmpty.notify_one();
+			return true;
+		}
+
+		/*!
+		 * @brief Takes the oldest item, waiting while the queue is empty and open.
+		 * @param [T] - Receives the item.
+		 * @return [boolean] - Set if an item is taken, reset once the queue is closed and empty.
+		 */
+		bool pop(T &item) {
+			std::unique_lock<std::mutex> lock(queueMutex);
+			notEmpty.wait(lock, [this]() { return closed || !items.empty(); });
+			if(items.empty()) { return false; }
+			item = std::move(items.front());
+			items.pop_front();
+			notFull.notify_one();
+			return true;
+		}
+
+		/*!
+		 * @brief Closes the queue, queued items can still be taken.
+		 * @param None
+		 * @return None
+		 */
+		void close(void) {
+			std::lock_guard<std::mutex> lock(queueMutex);
+			closed = true;
+			notEmpty.notify_all();
+			notFull.notify_all();
+		}
+
+	private:
+		BoundedQueue(const BoundedQueue &);
+		BoundedQueue &operator=(const BoundedQueue &);
+
+		size_t capacity;
+		bool closed;
+
+		std::deque<T> items;
+		std::mutex queueMutex;
+		std::condition_variable notEmpty;
+		std::condition_variable notFull;
+};
@@ -0,0 +1,252 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.0
+ *          - 1.0.0 - Added right angle rotations.
+ *
+ * @desc Lossless rotations by right angles of 8, 24 and 32 bit planes, a
+ *       cache blocked transpose with SSE2 16x16 byte kernels for quarter turns
+ *       and SSSE3 byte shuffles reversing the rows of half turns.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include "Transpose.h"
+#include "ThreadPool.h"
+
+#include <cmath>
+#include <cstring>
+
+#ifdef BITMAP_X86
+#include <immintrin.h>
+#endif
+
+/*!
+ * @brief Copies one pixel of 1, 3 or 4 bytes.
+ */
+static inline void copyPixel(uint8_t *dst, const uint8_t *src, const uint32_t pixelBytes) {
+	if(pixelBytes == 1) { dst[0] = src[0]; }
+	else if(pixelBytes == 3) { dst[0] = src[0]; dst[1] = src[1]; dst[2] = src[2]; }
+	else { memcpy(dst, src, pixelBytes); }
+}
+
+/*!
+ * @brief Scalar quarter turn of the destination block [u0, u1) x [v0, v1).
+ *        Destination rows walk down a source column, the block keeps the
+ *        touched source rows in cache.
+ */
+static void turnBlockScalar(const uint8_t *src, const uint32_t width, const uint32_t height, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const uint32_t pixelBytes, const QuarterTurn turn,
+	const uint32_t u0, const uint32_t u1, const uint32_t v0, const uint32_t v1) {
+	for(uint32_t v = v0; v < v1; v++) {
+		uint8_t *out = dst + (size_t)v * dstStride + (size_t)u0 * pixelBytes;
+		if(turn == TURN_90) {
+			//dst(u, v) = src(v, height - 1 - u)
+			const uint8_t *in = src + (size_t)(height - 1 - u0) * srcStride + (size_t)v * pixelBytes;
+			for(uint32_t u = u0; u < u1; u++, out += pixelBytes, in -= srcStride) { copyPixel(out, in, pixelBytes); }
+		} else {
+			//dst(u, v) = src(width - 1 - v, u)
+			const uint8_t *in = src + (size_t)u0 * srcStride + (size_t)(width - 1 - v) * pixelBytes;
+			for(uint32_t u = u0; u < u1; u++, out += pixelBytes, in += srcStride) { copyPixel(out, in, pixelBytes); }
+		}
+	}
+}
+
+/*!
+ * @brief Scalar half turn of one row.
+ */
+static void reverseRowScalar(const uint8_t *in, uint8_t *out, const uint32_t width, const uint32_t pixelBytes) {
+	const uint8_t *p = in + (size_t)(width - 1) * pixelBytes;
+	for(uint32_t u = 0; u < width; u++, out += pixelBytes, p -= pixelBytes) { copyPixel(out, p, pixelBytes); }
+}
+
+#ifdef BITMAP_X86
+
+static const uint32_t PREFETCH_ROWS = 32;						//Source rows requested ahead of a quarter turn
+
+/*!
+ * @brief Transposes 16 rows of 16 bytes. Every round of byte unpacks rotates the
+ *        8 bit (row, column) index left by one, four rounds swap row and column.
+ * @param [__m128i] - Rows, replaced by the columns.
+ * @return None
+ */
+SIMD_TARGET("sse2")
+static inline void transpose16x16(__m128i v[16]) {
+	__m128i t[16];
+	for(int round = 0; round < 4; round++) {
+		for(int i = 0; i < 8; i++) {
+			t[2 * i] = _mm_unpacklo_epi8(v[i], v[i + 8]);
+			t[2 * i + 1] = _mm_unpackhi_epi8(v[i], v[i + 8]);
+		}
+		for(int i = 0; i < 16; i++) { v[i] = t[i]; }
+	}
+}
+
+/*!
+ * @brief SSE2 quarter turn of a gray destination block, 16x16 pixels per step,
+ *        the remaining columns and rows are left to the scalar kernel. 'uDone'
+ *        and 'vDone' receive the end of the columns and rows done.
+ */
+SIMD_TARGET("sse2")
+static void turnBlockSse2(const uint8_t *src, const uint32_t width, const uint32_t height, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const QuarterTurn turn,
+	const uint32_t u0, const uint32_t u1, const uint32_t v0, const uint32_t v1, uint32_t &uDone, uint32_t &vDone) {
+	uDone = u0 + ((u1 - u0) & ~15u);
+	vDone = v0 + ((v1 - v0) & ~15u);
+
+	__m128i v[16];
+	for(uint32_t ub = u0; ub < uDone; ub += 16) {
+		//Every source row of a block is a separate cache line the hardware prefetcher
+		//does not predict, the rows of the next block are requested ahead.
+		if(ub + PREFETCH_ROWS + 16 <= height) {
+			for(uint32_t i = 0; i < 16; i++) {
+				const uint8_t *row = (turn == TURN_90) ? src + (size_t)(height - 1 - ub - PREFETCH_ROWS - i) * srcStride + v0 :
+					src + (size_t)(ub + PREFETCH_ROWS + i) * srcStride + (width - vDone);
+				_mm_prefetch((const char *)row, _MM_HINT_T0);
+			}
+		}
+		for(uint32_t vb = v0; vb < vDone; vb += 16) {
+			if(turn == TURN_90) {
+				//Destination rows vb.. read source columns vb.. of rows height - 1 - ub - i.
+				const uint8_t *in = src + (size_t)(height - 1 - ub) * srcStride + vb;
+				for(int i = 0; i < 16; i++) { v[i] = _mm_loadu_si128((const __m128i *)(in - (size_t)i * srcStride)); }
+				transpose16x16(v);
+				for(int j = 0; j < 16; j++) { _mm_storeu_si128((__m128i *)(dst + (size_t)(vb + j) * dstStride + ub), v[j]); }
+			} else {
+				//Destination row vb + j reads source column width - 1 - vb - j, the last one loaded first.
+				const uint8_t *in = src + (size_t)ub * srcStride + (width - 16 - vb);
+				for(int i = 0; i < 16; i++) { v[i] = _mm_loadu_si128((const __m128i *)(in + (size_t)i * srcStride)); }
+				transpose16x16(v);
+				for(int j = 0; j < 16; j++) { _mm_storeu_si128((__m128i *)(dst + (size_t)(vb + j) * dstStride + ub), v[15 - j]); }
+			}
+		}
+	}
+}
+
+/*!
+ * @brief SSSE3 half turn of one row, 16 pixels per step with byte shuffles.
+ * @return [int] - Number of pixels done.
+ */
+SIMD_TARGET("ssse3")
+static uint32_t reverseRowSsse3(const uint8_t *in, uint8_t *out, const uint32_t width, const uint32_t pixelBytes) {
+	uint32_t u = 0;
+	if(pixelBytes == 1) {
+		const __m128i mask = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+		for(; u + 16 <= width; u += 16) {
+			__m128i x = _mm_loadu_si128((const __m128i *)(in + width - 16 - u));
+			_mm_storeu_si128((__m128i *)(out + u), _mm_shuffle_epi8(x, mask));
+		}
+	} else if(pixelBytes == 3) {
+		//Output byte k of 16 reversed pixels is source byte 3 * (15 - k / 3) + k % 3 of the
+		//48 byte block, each output vector gathers from the source vectors holding its bytes.
+		uint8_t masks[3][3][16];
+		for(int o = 0; o < 3; o++) {
+			for(int i = 0; i < 16; i++) {
+				int k = o * 16 + i;
+				int b = 3 * (15 - k / 3) + k % 3;
+				for(int s = 0; s < 3; s++) { masks[o][s][i] = (b / 16 == s) ? (uint8_t)(b % 16) : 0x80; }
+			}
+		}
+		__m128i m[3][3];
+		for(int o = 0; o < 3; o++) {
+			for(int s = 0; s < 3; s++) { m[o][s] = _mm_loadu_si128((const __m128i *)masks[o][s]); }
+		}
+
+		for(; u + 16 <= width; u += 16) {
+			const uint8_t *p = in + (size_t)(width - 16 - u) * 3;
+			__m128i x0 = _mm_loadu_si128((const __m128i *)p);
+			__m128i x1 = _mm_loadu_si128((const __m128i *)(p + 16));
+			__m128i x2 = _mm_loadu_si128((const __m128i *)(p + 32));
+			for(int o = 0; o < 3; o++) {
+				__m128i y = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(x0, m[o][0]), _mm_shuffle_epi8(x1, m[o][1])),
+					_mm_shuffle_epi8(x2, m[o][2]));
+				_mm_storeu_si128((__m128i *)(out + (size_t)u * 3 + o * 16), y);
+			}
+		}
+	} else if(pixelBytes == 4) {
+		for(; u + 4 <= width; u += 4) {
+			__m128i x = _mm_loadu_si128((const __m128i *)(in + (size_t)(width - 4 - u) * 4));
+			_mm_storeu_si128((__m128i *)(out + (size_t)u * 4), _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 1, 2, 3)));
+		}
+	}
+	return u;
+}
+
+#endif
+
+bool toQuarterTurn(double angle, QuarterTurn &turn) {
+	angle = fmod(angle, 360.0);
+	if(angle < 0.0) { angle += 360.0; }
+
+	if(angle == 0.0) { turn = TURN_0; }
+	else if(angle == 90.0) { turn = TURN_90; }
+	else if(angle == 180.0) { turn = TURN_180; }
+	else if(angle == 270.0) { turn = TURN_270; }
+	else { return false; }
+	return true;
+}
+
+void rotateQuarter(const uint8_t *src, const uint32_t width, const uint32_t height, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const uint32_t pixelBytes, const QuarterTurn turn, const SimdLevel level) {
+	(void)level;
+	size_t rowBytes = (size_t)width * pixelBytes;
+
+	if(turn == TURN_0 || turn == TURN_180) {
+		ThreadPool::getShared().parallelFor(0, height, TURN_TILE_ROWS, [&](uint32_t first, uint32_t last) {
+			for(uint32_t v = first; v < last; v++) {
+				uint8_t *out = dst + (size_t)v * dstStride;
+				if(turn == TURN_0) { memcpy(out, src + (size_t)v * srcStride, rowBytes); continue; }
+
+				const uint8_t *in = src + (size_t)(height - 1 - v) * srcStride;
+				uint32_t u = 0;
+#ifdef BITMAP_X86
+				if(level >= SIMD_SSSE3) { u = reverseRowSsse3(in, out, width, pixelBytes); }
+#endif
+				reverseRowScalar(in, out + (size_t)u * pixelBytes, width - u, pixelBytes);
+			}
+		});
+		return;
+	}
+
+	//Quarter turns, the destination is 'height' pixels wide and 'width' rows high.
+	uint32_t dstWidth = height;
+	uint32_t dstHeight = width;
+	ThreadPool::getShared().parallelFor(0, dstHeight, TURN_TILE_ROWS, [&](uint32_t first, uint32_t last) {
+		for(uint32_t v0 = first; v0 < last; v0 += TURN_TILE_ROWS) {
+			uint32_t v1 = (last - v0 > TURN_TILE_ROWS) ? v0 + TURN_TILE_ROWS : last;
+			for(uint32_t u0 = 0; u0 < dstWidth; u0 += TURN_TILE_COLS) {
+				uint32_t u1 = (dstWidth - u0 > TURN_TILE_COLS) ? u0 + TURN_TILE_COLS : dstWidth;
+				uint32_t uDone = u0, vDone = v0;
+#ifdef BITMAP_X86
+				if(pixelBytes == 1 && level >= SIMD_SSE2) {
+					turnBlockSse2(src, width, height, srcStride, dst, dstStride, turn, u0, u1, v0, v1, uDone, vDone);
+				}
+#endif
+				//Right edge of the SIMD part, then the rows below it.
+				if(uDone < u1) { turnBlockScalar(src, width, height, srcStride, dst, dstStride, pixelBytes, turn, uDone, u1, v0, vDone); }
+				if(vDone < v1) { turnBlockScalar(src, width, height, srcStride, dst, dstStride, pixelBytes, turn, u0, u1, vDone, v1); }
+			}
+		}
+	});
+}
+
+void rotateQuarter(const uint8_t *src, const uint32_t width, const uint32_t height, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const uint32_t pixelBytes, const QuarterTurn turn) {
+	rotateQuarter(src, width, height, srcStride, dst, dstStride, pixelBytes, turn, getSimdLevel());
+}
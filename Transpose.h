@@ -0,0 +1,77 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 16th, 2026
+ * @version 1.0.0
+ *          - 1.0.0 - Added right angle rotations.
+ *
+ * @desc Lossless rotations by right angles of 8, 24 and 32 bit planes, a
+ *       cache blocked transpose with SSE2 16x16 byte kernels for quarter turns
+ *       and SSSE3 byte shuffles reversing the rows of half turns.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "CpuFeatures.h"
+
+/*! Counterclockwise right angle rotations, matching rotateImage() */
+enum QuarterTurn {
+	TURN_0 = 0,						/*! dst(u, v) = src(u, v) */
+	TURN_90,						/*! dst(u, v) = src(v, height - 1 - u), width and height swap */
+	TURN_180,						/*! dst(u, v) = src(width - 1 - u, height - 1 - v) */
+	TURN_270						/*! dst(u, v) = src(width - 1 - v, u), width and height swap */
+};
+
+static const uint32_t TURN_TILE_ROWS = 256;		//Destination rows of a cache block
+static const uint32_t TURN_TILE_COLS = 128;		//Destination columns of a cache block
+
+/*!
+ * @brief Checks for an angle that is an exact multiple of 90 degrees.
+ * @param [double] - Angle in degrees, any sign.
+ * @param [QuarterTurn] - Receives the rotation.
+ * @return [boolean] - Set if the angle is a right angle otherwise reset.
+ */
+bool toQuarterTurn(double angle, QuarterTurn &turn);
+
+/*!
+ * @brief Rotates a plane by a right angle, pixels move unchanged. Quarter turns
+ *        transpose in cache blocks, half turns reverse the rows. Row bands run
+ *        in parallel and the kernels are dispatched to the best SIMD level.
+ * @param [string] - Source plane.
+ * @param [int] - Source width.
+ * @param [int] - Source height.
+ * @param [int] - Source row stride in bytes.
+ * @param [string] - Destination plane, sized height x width for quarter turns.
+ * @param [int] - Destination row stride in bytes.
+ * @param [int] - Bytes per pixel (1, 3 or 4).
+ * @param [QuarterTurn] - Rotation.
+ * @return None
+ */
+void rotateQuarter(const uint8_t *src, const uint32_t width, const uint32_t height, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const uint32_t pixelBytes, const QuarterTurn turn);
+
+/*!
+ * @brief Same as rotateQuarter() but forced to the given SIMD level, which must
+ *        be supported by the CPU. Used for testing and benchmarking.
+ */
+void rotateQuarter(const uint8_t *src, const uint32_t width, const uint32_t height, const uint32_t srcStride,
+	uint8_t *dst, const uint32_t dstStride, const uint32_t pixelBytes, const QuarterTurn turn, const SimdLevel level);
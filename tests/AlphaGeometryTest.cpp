@@ -0,0 +1,212 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 17th, 2026
+ *
+ * Rotation, scaling, translation and fused transforms of 32 bit BGRA images.
+ *
+ * Usage: AlphaGeometryTest [threads]
+ *
+ * A 32 bit file with a BITMAPV5HEADER and B, G, R and alpha masks is written,
+ * run through the geometric operations in memory and in strips of 3 rows, and
+ * the outputs are loaded back. Checks that:
+ *   - outputs stay 32 bit and strips give the same bytes as memory,
+ *   - rotating by 90 then -90 degrees gives the source back,
+ *   - a source with one constant value per channel keeps those values under
+ *     scaling and inside rotations, so channels are never mixed.
+ * Exits with 1 when a check fails.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BitmapHandler.h"
+
+using namespace std;
+
+static const char *SOURCE_FILE = "alpha_source.bmp";		//Written in the working directory
+static const char *MEMORY_FILE = "alpha_memory.bmp";
+static const char *STRIP_FILE = "alpha_strip.bmp";
+static const char *BACK_FILE = "alpha_back.bmp";
+static const uint32_t TEST_STRIP_ROWS = 3;					//Strip height of the streamed runs
+static const uint8_t CONSTANT_BGRA[4] = { 10, 100, 200, 255 };
+
+static uint32_t failures = 0;
+
+/*!
+ * @brief Reports a failed check.
+ * @param [boolean] - Result of the check.
+ * @param [string] - What was checked.
+ * @return None
+ */
+static void check(const bool passed, const string &what) {
+	if(!passed) {
+		cout << "Failed: " << what << endl;
+		failures++;
+	}
+}
+
+static void putWord(vector<uint8_t> &file, const size_t at, const uint32_t value, const uint32_t bytes) {
+	for(uint32_t k = 0; k < bytes; k++) { file[at + k] = (uint8_t)(value >> (8 * k)); }
+}
+
+/*!
+ * @brief Writes a bottom-up 32 bit file with a BITMAPV5HEADER and BGRA masks.
+ * @param [string] - File name.
+ * @param [int] - Width in pixels.
+ * @param [int] - Height in pixels.
+ * @param [boolean] - Set for one constant value per channel, reset for a pattern.
+ * @return [boolean] - Set if the file is written otherwise reset.
+ */
+static bool writeV5(const char *fileName, const uint32_t width, const uint32_t height, const bool constant) {
+	const uint32_t offset = IMAGE_INFO_ADD + INFO_V5_SIZE;
+	const uint32_t size = width * height * 4;
+	vector<uint8_t> file(offset + size, 0);
+
+	file[0] = HEADER_B0;
+	file[1] = HEADER_B1;
+	putWord(file, FILE_INFO_ADD, offset + size, 4);
+	putWord(file, 10, offset, 4);
+	putWord(file, IMAGE_INFO_ADD, INFO_V5_SIZE, 4);
+	putWord(file, IMAGE_INFO_ADD + 4, width, 4);
+	putWord(file, IMAGE_INFO_ADD + 8, height, 4);
+	putWord(file, IMAGE_INFO_ADD + 12, 1, 2);
+	putWord(file, IMAGE_INFO_ADD + 14, 32, 2);
+	putWord(file, IMAGE_INFO_ADD + 16, COMPRESSION_BITFIELDS, 4);
+	putWord(file, IMAGE_INFO_ADD + 20, size, 4);
+	putWord(file, IMAGE_INFO_ADD + 40, 0x00FF0000, 4);		//Red
+	putWord(file, IMAGE_INFO_ADD + 44, 0x0000FF00, 4);		//Green
+	putWord(file, IMAGE_INFO_ADD + 48, 0x000000FF, 4);		//Blue
+	putWord(file, IMAGE_INFO_ADD + 52, 0xFF000000, 4);		//Alpha
+
+	for(uint32_t y = 0; y < height; y++) {
+		for(uint32_t x = 0; x < width; x++) {
+			uint8_t *p = &file[offset + ((size_t)y * width + x) * 4];
+			for(uint32_t c = 0; c < 4; c++) {
+				p[c] = constant ? CONSTANT_BGRA[c] : (uint8_t)(x * (c + 3) + y * (7 - c) + ((x ^ y) & 15));
+			}
+		}
+	}
+
+	FILE *out = fopen(fileName, "wb");
+	if(out == 0) { return false; }
+	bool written = fwrite(file.data(), 1, file.size(), out) == file.size();
+	fclose(out);
+	return written;
+}
+
+/*!
+ * @brief Loads an output and checks it is a 32 bit image.
+ */
+static bool loadOutput(BitmapHandler &handler, const char *fileName, BitmapImage &image) {
+	return handler.loadImage((const uint8_t *)fileName, image) && image.getBitsPerPixel() == BIT_ALPHA_IMAGE;
+}
+
+/*!
+ * @brief Compares the pixels of two images.
+ */
+static bool samePixels(const BitmapImage &a, const BitmapImage &b) {
+	if(a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight() || a.getBitsPerPixel() != b.getBitsPerPixel()) {
+		return false;
+	}
+	for(uint32_t y = 0; y < a.getHeight(); y++) {
+		if(memcmp(a.getRow(y), b.getRow(y), (size_t)a.getWidth() * 4) != 0) { return false; }
+	}
+	return true;
+}
+
+/*!
+ * @brief Counts the pixels equal to the constant source pixel.
+ */
+static uint64_t constantPixels(const BitmapImage &image) {
+	uint64_t count = 0;
+	for(uint32_t y = 0; y < image.getHeight(); y++) {
+		const uint8_t *row = image.getRow(y);
+		for(uint32_t x = 0; x < image.getWidth(); x++) {
+			if(memcmp(row + (size_t)x * 4, CONSTANT_BGRA, 4) == 0) { count++; }
+		}
+	}
+	return count;
+}
+
+/*!
+ * @brief Runs one operation from the source file in memory and in strips, checks
+ *        both outputs are 32 bit and equal and returns the in-memory one.
+ */
+template<typename Operation>
+static bool runBoth(BitmapHandler &handler, const string &name, Operation operation, BitmapImage &output) {
+	BitmapImage streamed;
+	handler.setStripRows(0);
+	bool memory = operation((const uint8_t *)SOURCE_FILE, (const uint8_t *)MEMORY_FILE) &&
+		loadOutput(handler, MEMORY_FILE, output);
+	handler.setStripRows(TEST_STRIP_ROWS);
+	bool strips = operation((const uint8_t *)SOURCE_FILE, (const uint8_t *)STRIP_FILE) &&
+		loadOutput(handler, STRIP_FILE, streamed);
+	handler.setStripRows(0);
+
+	check(memory, name + " in memory");
+	check(strips, name + " in strips");
+	check(memory && strips && samePixels(output, streamed), name + " strips match memory");
+	return memory;
+}
+
+int main(int argc, char **argv) {
+	if(argc > 1) { BitmapHandler::setThreadCount((uint32_t)atoi(argv[1])); }
+
+	BitmapHandler handler;
+	BitmapImage source, output, back;
+
+	for(uint32_t pass = 0; pass < 2; pass++) {
+		bool constant = (pass == 1);
+		string kind = constant ? " (constant)" : " (pattern)";
+		if(!writeV5(SOURCE_FILE, 37, 23, constant) || !loadOutput(handler, SOURCE_FILE, source)) {
+			check(false, "loading the V5 source" + kind);
+			break;
+		}
+
+		//Right angles are lossless, turning back gives the source.
+		if(runBoth(handler, "rotate 90" + kind, [&](const uint8_t *in, const uint8_t *out) {
+			return handler.rotateImage(in, out, 90.0); }, output)) {
+			bool turned = handler.rotateImage((const uint8_t *)MEMORY_FILE, (const uint8_t *)BACK_FILE, -90.0) &&
+				loadOutput(handler, BACK_FILE, back);
+			check(turned && samePixels(source, back), "rotate 90 and back" + kind);
+		}
+
+		if(runBoth(handler, "rotate 45" + kind, [&](const uint8_t *in, const uint8_t *out) {
+			return handler.rotateImage(in, out, 45.0); }, output) && constant) {
+			check(constantPixels(output) > (uint64_t)source.getWidth() * source.getHeight() / 2, "rotate 45 keeps channels" + kind);
+		}
+
+		if(runBoth(handler, "scale" + kind, [&](const uint8_t *in, const uint8_t *out) {
+			return handler.scaleImage(in, out, 2.5, 0.6); }, output)) {
+			check(output.getWidth() == 93 && output.getHeight() == 14, "scale size" + kind);
+			if(constant) { check(constantPixels(output) == (uint64_t)output.getWidth() * output.getHeight(), "scale keeps channels" + kind); }
+		}
+
+		if(runBoth(handler, "translate" + kind, [&](const uint8_t *in, const uint8_t *out) {
+			return handler.translatedImage(in, out, 5, -4); }, output) && !constant) {
+			check(memcmp(output.getRow(0) + 5 * 4, source.getRow(4), (size_t)(source.getWidth() - 5) * 4) == 0, "translate moves pixels" + kind);
+		}
+
+		vector<GeometryStep> steps = { { GEOMETRY_ROTATE, 30.0, 0.0 }, { GEOMETRY_SCALE, 1.5, 1.5 } };
+		runBoth(handler, "transform" + kind, [&](const uint8_t *in, const uint8_t *out) {
+			return handler.transformImage(in, out, steps, INTERP_BILINEAR, 0); }, output);
+	}
+
+	remove(SOURCE_FILE);
+	remove(MEMORY_FILE);
+	remove(STRIP_FILE);
+	remove(BACK_FILE);
+
+	cout << (failures ? "FAILED" : "PASSED") << endl;
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,234 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 17th, 2026
+ *
+ * Interpolating, counting and filtering 4 and 8 bit images with a color palette.
+ *
+ * Usage: IndexedColorTest [threads]
+ *
+ * Files with red (index 0) and blue (index 2) column stripes are written with
+ * green at index 1, and run through the operations in memory and in strips of
+ * 3 rows. Checks that:
+ *   - rotations, scaling and transforms give 24 bit outputs without any green,
+ *     so indices are never blended, and strips give the same bytes as memory,
+ *   - right angle rotations keep the indices and the palette,
+ *   - statistics count three color channels,
+ *   - lookup tables, filters and equalization reject the images.
+ * Exits with 1 when a check fails.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BitmapHandler.h"
+
+using namespace std;
+
+static const char *SOURCE_FILE = "indexed_source.bmp";		//Written in the working directory
+static const char *MEMORY_FILE = "indexed_memory.bmp";
+static const char *STRIP_FILE = "indexed_strip.bmp";
+static const uint32_t TEST_WIDTH = 40;
+static const uint32_t TEST_HEIGHT = 24;
+static const uint32_t TEST_STRIP_ROWS = 3;					//Strip height of the streamed runs
+static const uint8_t PALETTE_BGRA[3][4] = { { 0, 0, 255, 0 }, { 0, 255, 0, 0 }, { 255, 0, 0, 0 } };
+
+static uint32_t failures = 0;
+
+/*!
+ * @brief Reports a failed check.
+ * @param [boolean] - Result of the check.
+ * @param [string] - What was checked.
+ * @return None
+ */
+static void check(const bool passed, const string &what) {
+	if(!passed) {
+		cout << "Failed: " << what << endl;
+		failures++;
+	}
+}
+
+static void putWord(vector<uint8_t> &file, const size_t at, const uint32_t value, const uint32_t bytes) {
+	for(uint32_t k = 0; k < bytes; k++) { file[at + k] = (uint8_t)(value >> (8 * k)); }
+}
+
+/*!
+ * @brief Index of a source pixel, stripes of 5 columns alternate red and blue.
+ */
+static uint8_t sourceIndex(const uint32_t x) {
+	return ((x / 5) & 1) ? 2 : 0;
+}
+
+/*!
+ * @brief Writes a bottom-up indexed file with the red, green and blue palette.
+ * @param [string] - File name.
+ * @param [int] - Bits per pixel, 4 or 8.
+ * @return [boolean] - Set if the file is written otherwise reset.
+ */
+static bool writeIndexed(const char *fileName, const uint32_t bpp) {
+	const uint32_t entries = 1u << bpp;
+	const uint32_t offset = IMAGE_INFO_ADD + INFO_HEADER_SIZE + entries * 4;
+	const uint32_t stride = ((TEST_WIDTH * bpp + 31) / 32) * 4;
+	const uint32_t size = stride * TEST_HEIGHT;
+	vector<uint8_t> file(offset + size, 0);
+
+	file[0] = HEADER_B0;
+	file[1] = HEADER_B1;
+	putWord(file, FILE_INFO_ADD, offset + size, 4);
+	putWord(file, 10, offset, 4);
+	putWord(file, IMAGE_INFO_ADD, INFO_HEADER_SIZE, 4);
+	putWord(file, IMAGE_INFO_ADD + 4, TEST_WIDTH, 4);
+	putWord(file, IMAGE_INFO_ADD + 8, TEST_HEIGHT, 4);
+	putWord(file, IMAGE_INFO_ADD + 12, 1, 2);
+	putWord(file, IMAGE_INFO_ADD + 14, bpp, 2);
+	putWord(file, IMAGE_INFO_ADD + 16, COMPRESSION_RGB, 4);
+	putWord(file, IMAGE_INFO_ADD + 20, size, 4);
+	memcpy(&file[IMAGE_INFO_ADD + INFO_HEADER_SIZE], PALETTE_BGRA, sizeof(PALETTE_BGRA));
+
+	for(uint32_t y = 0; y < TEST_HEIGHT; y++) {
+		uint8_t *row = &file[offset + (size_t)y * stride];
+		for(uint32_t x = 0; x < TEST_WIDTH; x++) {
+			if(bpp == 8) { row[x] = sourceIndex(x); }
+			else { row[x / 2] |= (uint8_t)(sourceIndex(x) << ((x & 1) ? 0 : 4)); }
+		}
+	}
+
+	FILE *out = fopen(fileName, "wb");
+	if(out == 0) { return false; }
+	bool written = fwrite(file.data(), 1, file.size(), out) == file.size();
+	fclose(out);
+	return written;
+}
+
+/*!
+ * @brief Compares the pixels of two images.
+ */
+static bool samePixels(const BitmapImage &a, const BitmapImage &b) {
+	if(a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight() || a.getBitsPerPixel() != b.getBitsPerPixel()) {
+		return false;
+	}
+	for(uint32_t y = 0; y < a.getHeight(); y++) {
+		if(memcmp(a.getRow(y), b.getRow(y), (size_t)a.getWidth() * a.getBitsPerPixel() / 8) != 0) { return false; }
+	}
+	return true;
+}
+
+/*!
+ * @brief Checks a 24 bit output has no green, which only a blended index gives.
+ */
+static bool noGreen(const BitmapImage &image) {
+	if(image.getBitsPerPixel() != BIT_COLOR_IMAGE) { return false; }
+	for(uint32_t y = 0; y < image.getHeight(); y++) {
+		const uint8_t *row = image.getRow(y);
+		for(uint32_t x = 0; x < image.getWidth(); x++) {
+			if(row[x * 3 + 1] != 0) { return false; }
+		}
+	}
+	return true;
+}
+
+/*!
+ * @brief Runs one operation from the source file in memory and in strips, checks
+ *        both outputs are equal and returns the in-memory one.
+ */
+template<typename Operation>
+static bool runBoth(BitmapHandler &handler, const string &name, Operation operation, BitmapImage &output) {
+	BitmapImage streamed;
+	handler.setStripRows(0);
+	bool memory = operation((const uint8_t *)SOURCE_FILE, (const uint8_t *)MEMORY_FILE) &&
+		handler.loadImage((const uint8_t *)MEMORY_FILE, output);
+	handler.setStripRows(TEST_STRIP_ROWS);
+	bool strips = operation((const uint8_t *)SOURCE_FILE, (const uint8_t *)STRIP_FILE) &&
+		handler.loadImage((const uint8_t *)STRIP_FILE, streamed);
+	handler.setStripRows(0);
+
+	check(memory, name + " in memory");
+	check(strips, name + " in strips");
+	check(memory && strips && samePixels(output, streamed), name + " strips match memory");
+	return memory;
+}
+
+/*!
+ * @brief Checks an operation fails in memory and in strips.
+ */
+template<typename Operation>
+static void rejectBoth(BitmapHandler &handler, const string &name, Operation operation) {
+	handler.setStripRows(0);
+	check(!operation((const uint8_t *)SOURCE_FILE, (const uint8_t *)MEMORY_FILE), name + " rejected in memory");
+	handler.setStripRows(TEST_STRIP_ROWS);
+	check(!operation((const uint8_t *)SOURCE_FILE, (const uint8_t *)STRIP_FILE), name + " rejected in strips");
+	handler.setStripRows(0);
+}
+
+int main(int argc, char **argv) {
+	if(argc > 1) { BitmapHandler::setThreadCount((uint32_t)atoi(argv[1])); }
+
+	BitmapHandler handler;
+	BitmapImage source, output;
+	const uint32_t depths[2] = { 8, 4 };
+
+	for(uint32_t pass = 0; pass < 2; pass++) {
+		string kind = " (" + to_string(depths[pass]) + " bit)";
+		if(!writeIndexed(SOURCE_FILE, depths[pass]) || !handler.loadImage((const uint8_t *)SOURCE_FILE, source)) {
+			check(false, "loading the indexed source" + kind);
+			break;
+		}
+
+		if(runBoth(handler, "scale" + kind, [&](const uint8_t *in, const uint8_t *out) {
+			return handler.scaleImage(in, out, 2.0, 1.5); }, output)) {
+			check(noGreen(output), "scale blends colors" + kind);
+		}
+
+		if(runBoth(handler, "rotate 30" + kind, [&](const uint8_t *in, const uint8_t *out) {
+			return handler.rotateImage(in, out, 30.0); }, output)) {
+			check(noGreen(output), "rotate 30 blends colors" + kind);
+		}
+
+		vector<GeometryStep> steps = { { GEOMETRY_ROTATE, -20.0, 0.0 }, { GEOMETRY_SCALE, 0.7, 1.3 } };
+		if(runBoth(handler, "transform" + kind, [&](const uint8_t *in, const uint8_t *out) {
+			return handler.transformImage(in, out, steps, INTERP_BILINEAR, 0); }, output)) {
+			check(noGreen(output), "transform blends colors" + kind);
+		}
+
+		//Right angles move whole pixels, the indices and their palette are kept.
+		if(runBoth(handler, "rotate 90" + kind, [&](const uint8_t *in, const uint8_t *out) {
+			return handler.rotateImage(in, out, 90.0); }, output)) {
+			check(output.getBitsPerPixel() == BIT_GRAY_IMAGE && output.getPaletteSize() == PALETTE_SIZE &&
+				memcmp(output.getPalette(), PALETTE_BGRA, sizeof(PALETTE_BGRA)) == 0, "rotate 90 keeps the palette" + kind);
+		}
+
+		ImageStats memoryStats, stripStats;
+		handler.setStripRows(0);
+		bool memory = handler.computeStats((const uint8_t *)SOURCE_FILE, memoryStats);
+		handler.setStripRows(TEST_STRIP_ROWS);
+		bool strips = handler.computeStats((const uint8_t *)SOURCE_FILE, stripStats);
+		handler.setStripRows(0);
+		check(memory && memoryStats.channels == 3 && memoryStats.maximum[0] == 255 && memoryStats.maximum[1] == 0,
+			"stats count colors in memory" + kind);
+		check(strips && stripStats.channels == 3 && memcmp(memoryStats.histogram, stripStats.histogram,
+			sizeof(memoryStats.histogram)) == 0, "stats count colors in strips" + kind);
+
+		rejectBoth(handler, "lookup table" + kind, [&](const uint8_t *in, const uint8_t *out) {
+			return handler.applyLut(in, out, PointLut::invert()); });
+		rejectBoth(handler, "equalize" + kind, [&](const uint8_t *in, const uint8_t *out) {
+			return handler.equalizeImage(in, out); });
+		rejectBoth(handler, "box blur" + kind, [&](const uint8_t *in, const uint8_t *out) {
+			return handler.boxBlur(in, out, 1); });
+	}
+
+	remove(SOURCE_FILE);
+	remove(MEMORY_FILE);
+	remove(STRIP_FILE);
+
+	cout << (failures ? "FAILED" : "PASSED") << endl;
+	return failures ? 1 : 0;
+}
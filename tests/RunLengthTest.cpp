@@ -0,0 +1,123 @@
+/*!
+ * @author Syed Asad Amin
+ * @date Oct 17th, 2026
+ *
+ * Round trip of RLE8 compressed gray images through saveImage() and loadImage().
+ *
+ * Usage: RunLengthTest [threads]
+ *
+ * Rows of random indices, alternating indices, the 'a b c d d d' pattern (three
+ * index absolute blocks, the most bytes per pixel an absolute block takes) and
+ * flat rows are saved RLE8 compressed and loaded back. The images span several
+ * encoder bands so neighbouring bands write into their slots at the same time.
+ * Exits with 1 when a loaded image differs from the saved one.
+ *
+ * A project for Image Processing For Intelligent System Course,
+ * National University of Science and Technology (NUST), RWP.
+ *
+ * Course Instructor: Dr. Jawaid Iqbal
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "BitmapHandler.h"
+#include "RunLength.h"
+
+using namespace std;
+
+static const char *TEST_FILE = "rle_roundtrip.bmp";		//Written in the working directory
+
+/*! Row patterns of the test images */
+enum RowPattern {
+	ROW_RANDOM = 0,				/*! Random indices */
+	ROW_ALTERNATING,			/*! Two indices taking turns */
+	ROW_ABCDDD,					/*! Three distinct indices then a run of three */
+	ROW_FLAT,					/*! One index, keeps the whole image compressible */
+	ROW_PATTERNS
+};
+
+/*!
+ * @brief Fills a row with one of the patterns.
+ * @param [string] - Row.
+ * @param [int] - Width in pixels.
+ * @param [RowPattern] - Pattern of the row.
+ * @param [mt19937] - Random generator.
+ * @return None
+ */
+static void fillRow(uint8_t *row, const uint32_t width, const RowPattern pattern, mt19937 &random) {
+	for(uint32_t x = 0; x < width; x++) {
+		switch(pattern) {
+			case ROW_RANDOM: row[x] = (uint8_t)random(); break;
+			case ROW_ALTERNATING: row[x] = (x & 1) ? 200 : 10; break;
+			case ROW_ABCDDD: row[x] = (x % 6 < 3) ? (uint8_t)(x % 6 + 1) : 9; break;
+			default: row[x] = 128; break;
+		}
+	}
+}
+
+/*!
+ * @brief Saves an image RLE8 compressed, loads it back and compares the pixels.
+ * @param [BitmapHandler] - Handler writing RLE8.
+ * @param [int] - Width in pixels.
+ * @param [int] - Height in pixels.
+ * @param [int] - Pattern of every row, ROW_PATTERNS cycles through all of them.
+ * @return [bool] - true if the pixels came back unchanged.
+ */
+static bool roundTrip(BitmapHandler &handler, const uint32_t width, const uint32_t height, const uint32_t pattern) {
+	mt19937 random(width * 31 + height);
+	BitmapImage image(width, height, BIT_GRAY_IMAGE);
+	for(uint32_t y = 0; y < height; y++) {
+		RowPattern rowPattern = (RowPattern)((pattern == ROW_PATTERNS) ? y % ROW_PATTERNS : pattern);
+		fillRow(image.getRow(y), width, rowPattern, random);
+	}
+
+	//Encoding into a buffer of exactly the bound, any overrun lands outside it.
+	const BitmapImage &source = image;
+	vector<uint8_t> encoded(rleBound(width, height));
+	encodeRle8(source.getData(), source.getStride(), width, height, encoded.data());
+
+	BitmapImage loaded;
+	if(!handler.saveImage((const uint8_t *)TEST_FILE, image) || !handler.loadImage((const uint8_t *)TEST_FILE, loaded)) {
+		return false;
+	}
+	if(loaded.getWidth() != width || loaded.getHeight() != height || loaded.getBitsPerPixel() != BIT_GRAY_IMAGE) {
+		return false;
+	}
+	const BitmapImage &result = loaded;
+	for(uint32_t y = 0; y < height; y++) {
+		if(memcmp(source.getRow(y), result.getRow(y), width) != 0) { return false; }
+	}
+	return true;
+}
+
+int main(int argc, char **argv) {
+	if(argc > 1) { BitmapHandler::setThreadCount((uint32_t)atoi(argv[1])); }
+
+	BitmapHandler handler;
+	handler.setRunLengthOutput(true);
+
+	static const uint32_t WIDTHS[] = { 1, 2, 3, 5, 6, 7, 255, 256, 600, 1001 };
+	static const uint32_t HEIGHTS[] = { 1, RLE_BAND_ROWS + 1, 2000 };
+
+	uint32_t failures = 0;
+	for(uint32_t w : WIDTHS) {
+		for(uint32_t h : HEIGHTS) {
+			for(uint32_t pattern = 0; pattern <= ROW_PATTERNS; pattern++) {
+				if(!roundTrip(handler, w, h, pattern)) {
+					cout << "Mismatch: " << w << "x" << h << " pattern " << pattern << endl;
+					failures++;
+				}
+			}
+		}
+	}
+	remove(TEST_FILE);
+
+	cout << (failures ? "FAILED" : "PASSED") << endl;
+	return failures ? 1 : 0;
+}